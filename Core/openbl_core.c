@@ -18,7 +18,9 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "openbl_core.h"
+#include "openbl_mem.h"
 #include "app_openbootloader.h"
+#include "common_interface.h"
 #include <stdbool.h>
 
 /* Private typedef -----------------------------------------------------------*/
@@ -27,7 +29,7 @@
 /* Private variables ---------------------------------------------------------*/
 static uint32_t NumberOfInterfaces = 0U;
 static OPENBL_HandleTypeDef a_InterfacesTable[INTERFACES_SUPPORTED];
-static OPENBL_HandleTypeDef *p_Interface;
+static OPENBL_HandleTypeDef *p_Interface = NULL;
 
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
@@ -41,6 +43,9 @@ void OPENBL_Init(void)
 {
   uint32_t counter;
 
+  /* Paint the free stack before any interface uses it, for the RAM usage report */
+  Common_PaintStack();
+
   for (counter = 0U; counter < NumberOfInterfaces; counter++)
   {
     if (a_InterfacesTable[counter].p_Ops->Init != NULL)
@@ -138,6 +143,19 @@ void OPENBL_CommandProcess(void)
   {
     command_opcode = p_Interface->p_Ops->GetCommandOpcode();
 
+    /* Program the FLASH pages pending in the write cache as soon as the download is over,
+       a programming failure is reported to the host instead of running the command */
+    if ((command_opcode != CMD_WRITE_MEMORY) && (command_opcode != CMD_NS_WRITE_MEMORY)
+        && (OPENBL_MEM_Flush() != SUCCESS))
+    {
+      if (p_Interface->p_Ops->SendByte != NULL)
+      {
+        p_Interface->p_Ops->SendByte(NACK_BYTE);
+      }
+
+      return;
+    }
+
     switch (command_opcode)
     {
       case CMD_GET_COMMAND:
@@ -406,6 +424,20 @@ void OPENBL_CommandProcess(void)
         }
         break;
 
+      case CMD_HANDSHAKE:
+        if (p_Interface->p_Cmd->Handshake != NULL)
+        {
+          p_Interface->p_Cmd->Handshake();
+        }
+        else
+        {
+          if (p_Interface->p_Ops->SendByte != NULL)
+          {
+            p_Interface->p_Ops->SendByte(NACK_BYTE);
+          }
+        }
+        break;
+
       case CMD_SPECIAL_COMMAND:
         if (p_Interface->p_Cmd->SpecialCommand != NULL)
         {
@@ -444,3 +476,25 @@ void OPENBL_CommandProcess(void)
     }
   }
 }
+
+/**
+  * @brief  This function is used to signal to the host that a memory operation is on going.
+  * @note   It is called repeatedly by the memory interfaces while an operation runs in busy state.
+  *         The detected interface answers the host polling with its busy state, and must return
+  *         immediately when the host is not polling.
+  * @retval None.
+  */
+#if defined (__ICCARM__)
+__ramfunc void OPENBL_SendBusyState(void)
+#else
+__attribute__((section(".ramfunc"))) void OPENBL_SendBusyState(void)
+#endif /* (__ICCARM__) */
+{
+  if (p_Interface != NULL)
+  {
+    if (p_Interface->p_Ops->SendBusyState != NULL)
+    {
+      p_Interface->p_Ops->SendBusyState();
+    }
+  }
+}
@@ -39,6 +39,7 @@
 #define CMD_GET_VERSION                   0x01U             /* Get Version command */
 #define CMD_GET_ID                        0x02U             /* Get ID command */
 #define CMD_SPEED                         0x03U             /* Speed command */
+#define CMD_HANDSHAKE                     0x04U             /* Handshake command */
 #define CMD_READ_MEMORY                   0x11U             /* Read Memory command */
 #define CMD_WRITE_MEMORY                  0x31U             /* Write Memory command */
 #define CMD_GO                            0x21U             /* GO command */
@@ -66,6 +67,7 @@ typedef struct
   uint8_t (*Detection)(void);
   uint8_t (*GetCommandOpcode)(void);
   void (*SendByte)(uint8_t Byte);
+  void (*SendBusyState)(void);
 } OPENBL_OpsTypeDef;
 
 typedef struct
@@ -90,6 +92,7 @@ typedef struct
   void (*Speed)(void);
   void (*SpecialCommand)(void);
   void (*ExtendedSpecialCommand)(void);
+  void (*Handshake)(void);
 } OPENBL_CommandsTypeDef;
 
 typedef struct
@@ -121,6 +124,11 @@ void OPENBL_DeInit(void);
 void OPENBL_InterfacesDeInit(void);
 uint32_t OPENBL_InterfaceDetection(void);
 void OPENBL_CommandProcess(void);
+#if defined (__ICCARM__)
+__ramfunc void OPENBL_SendBusyState(void);
+#else
+__attribute__((section(".ramfunc"))) void OPENBL_SendBusyState(void);
+#endif /* (__ICCARM__) */
 ErrorStatus OPENBL_RegisterInterface(OPENBL_HandleTypeDef *Interface);
 
 #endif /* OPENBL_CORE_H */
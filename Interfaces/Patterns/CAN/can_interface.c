@@ -0,0 +1,492 @@
+/**
+  ******************************************************************************
+  * @file    can_interface.c
+  * @author  MCD Application Team
+  * @brief   Contains CAN HW configuration and the CAN frames transfer, on the FDCAN
+  *          instance running in classic CAN mode
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "platform.h"
+#include "interfaces_conf.h"
+#include "openbl_core.h"
+#include "openbl_can_cmd.h"
+#include "can_interface.h"
+#include "iwdg_interface.h"
+#include "common_interface.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint32_t StdId;                         /*!< Identifier of the received frame */
+  uint32_t DLC;                           /*!< Number of data bytes of the received frame */
+  uint8_t Data[CAN_DLC_BYTES_8];          /*!< Data bytes of the received frame */
+} OPENBL_CAN_FrameTypeDef;
+
+/* Private define ------------------------------------------------------------*/
+#define CAN_RX_RING_SIZE                  16U  /* Number of frames of the reception ring, must be a power of 2 */
+#define CAN_TIME_QUANTA                   20U  /* Time quanta per bit: 1 sync + 15 segment 1 + 4 segment 2 */
+#define CAN_SPEED_NB                      5U   /* Number of entries of the CAN speed table */
+#define CAN_TX_TIMEOUT                    0x00100000U  /* Polls of the Tx buffers before giving up */
+#define CAN_TX_ELEMENT_SIZE               72U  /* Tx buffer element in the message RAM: header and 64 bytes */
+#define CAN_ELEMENT_STD_ID_POS            18U  /* Standard identifier in the first element word */
+#define CAN_ELEMENT_DLC_POS               16U  /* Data length code in the second element word */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static FDCAN_HandleTypeDef hfdcan;
+static FDCAN_TxHeaderTypeDef TxHeader;
+static OPENBL_CAN_FrameTypeDef CanRxRing[CAN_RX_RING_SIZE];
+static volatile uint32_t CanRxHead = 0U;
+static volatile uint32_t CanRxTail = 0U;
+static volatile uint8_t CanRxPaused = 0U;
+static uint32_t CanPrescaler = CANx_CLOCK_FREQ / (CAN_TIME_QUANTA * 125000U);
+static uint8_t CanDetected = 0U;
+
+/* Bit rates of the CAN speed command, the index 0 is the default 125 kbps */
+static const uint32_t a_CanSpeedTable[CAN_SPEED_NB] = {125000U, 125000U, 250000U, 500000U, 1000000U};
+
+/* Exported variables --------------------------------------------------------*/
+uint8_t tCanRxData[CAN_RAM_BUFFER_SIZE];
+
+/* Private function prototypes -----------------------------------------------*/
+static void OPENBL_CAN_Init(void);
+static void OPENBL_CAN_FlushTx(void);
+static void OPENBL_CAN_DrainRxFifo(uint32_t RxFifo);
+static void OPENBL_CAN_GetFrame(OPENBL_CAN_FrameTypeDef *pFrame);
+
+/* Private functions ---------------------------------------------------------*/
+/**
+ * @brief  This function is used to initialize the used FDCAN instance in classic CAN mode.
+ * @retval None.
+ */
+static void OPENBL_CAN_Init(void)
+{
+  FDCAN_FilterTypeDef filter_config;
+
+  /*              Bit time configuration:
+    Bit time parameter         | Value
+    ---------------------------|----------------------------
+    Time_quantum (tq)          | CanPrescaler / CANx_CLOCK_FREQ
+    Synchronization_segment    | 1 tq
+    Phase_segment_1            | 15 tq
+    Phase_segment_2            | 4 tq
+    Synchronization_Jump_width | 4 tq
+    Sample point               | 80 %
+  */
+  hfdcan.Instance                  = CANx;
+  hfdcan.Init.ClockDivider         = FDCAN_CLOCK_DIV1;
+  hfdcan.Init.FrameFormat          = FDCAN_FRAME_CLASSIC;
+  hfdcan.Init.Mode                 = FDCAN_MODE_NORMAL;
+  hfdcan.Init.AutoRetransmission   = ENABLE;
+  hfdcan.Init.TransmitPause        = DISABLE;
+  hfdcan.Init.ProtocolException    = DISABLE;
+  hfdcan.Init.NominalPrescaler     = CanPrescaler;
+  hfdcan.Init.NominalSyncJumpWidth = 4U;
+  hfdcan.Init.NominalTimeSeg1      = 15U;
+  hfdcan.Init.NominalTimeSeg2      = 4U;
+  hfdcan.Init.DataPrescaler        = 1U;
+  hfdcan.Init.DataSyncJumpWidth    = 4U;
+  hfdcan.Init.DataTimeSeg1         = 15U;
+  hfdcan.Init.DataTimeSeg2         = 4U;
+  hfdcan.Init.StdFiltersNbr        = 2U;
+  hfdcan.Init.ExtFiltersNbr        = 0U;
+
+  /* Transmit the Tx buffers in request order so that the frames of a response stay ordered */
+  hfdcan.Init.TxFifoQueueMode      = FDCAN_TX_FIFO_OPERATION;
+
+  if (HAL_FDCAN_Init(&hfdcan) != HAL_OK)
+  {
+    while (1);
+  }
+
+  /* Split the identifiers between the two Rx FIFOs: all the frames of a command share the
+     same identifier, so the frames order is kept inside each command */
+  filter_config.IdType       = FDCAN_STANDARD_ID;
+  filter_config.FilterType   = FDCAN_FILTER_MASK;
+  filter_config.FilterID2    = 0x001U;
+
+  /* Even identifiers are received in FIFO 0 */
+  filter_config.FilterIndex  = 0U;
+  filter_config.FilterConfig = FDCAN_FILTER_TO_RXFIFO0;
+  filter_config.FilterID1    = 0x000U;
+  HAL_FDCAN_ConfigFilter(&hfdcan, &filter_config);
+
+  /* Odd identifiers are received in FIFO 1 */
+  filter_config.FilterIndex  = 1U;
+  filter_config.FilterConfig = FDCAN_FILTER_TO_RXFIFO1;
+  filter_config.FilterID1    = 0x001U;
+  HAL_FDCAN_ConfigFilter(&hfdcan, &filter_config);
+
+  /* Prepare Tx Header */
+  TxHeader.Identifier          = 0x79U;
+  TxHeader.IdType              = FDCAN_STANDARD_ID;
+  TxHeader.TxFrameType         = FDCAN_DATA_FRAME;
+  TxHeader.DataLength          = CAN_DLC_BYTES_8;
+  TxHeader.ErrorStateIndicator = FDCAN_ESI_ACTIVE;
+  TxHeader.BitRateSwitch       = FDCAN_BRS_OFF;
+  TxHeader.FDFormat            = FDCAN_CLASSIC_CAN;
+  TxHeader.TxEventFifoControl  = FDCAN_NO_TX_EVENTS;
+  TxHeader.MessageMarker       = 0U;
+
+  /* Both Rx FIFOs are drained from interrupt into the reception ring */
+  CanRxHead   = 0U;
+  CanRxTail   = 0U;
+  CanRxPaused = 0U;
+
+  HAL_FDCAN_ActivateNotification(&hfdcan, (FDCAN_IT_RX_FIFO0_NEW_MESSAGE | FDCAN_IT_RX_FIFO1_NEW_MESSAGE), 0U);
+
+  HAL_NVIC_SetPriority(CANx_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(CANx_IRQn);
+
+  /* Start the FDCAN module */
+  HAL_FDCAN_Start(&hfdcan);
+}
+
+/**
+ * @brief  This function is used to wait until all the Tx buffers are sent.
+ * @note   The wait is bounded: without a host acknowledging them, the frames are never sent.
+ * @retval None.
+ */
+static void OPENBL_CAN_FlushTx(void)
+{
+  uint32_t tick = 0U;
+
+  if (hfdcan.State == HAL_FDCAN_STATE_BUSY)
+  {
+    while ((hfdcan.Instance->TXBRP != 0U) && (tick < CAN_TX_TIMEOUT))
+    {
+      OPENBL_IWDG_Refresh();
+      tick++;
+    }
+  }
+}
+
+/**
+ * @brief  This function is used to move the frames of a Rx FIFO to the reception ring.
+ * @note   When the ring is full, the reception is paused and the frames are left in the Rx FIFO
+ *         until a frame is consumed.
+ * @param  RxFifo The Rx FIFO to be drained: FDCAN_RX_FIFO0 or FDCAN_RX_FIFO1.
+ * @retval None.
+ */
+static void OPENBL_CAN_DrainRxFifo(uint32_t RxFifo)
+{
+  FDCAN_RxHeaderTypeDef rx_header;
+  OPENBL_CAN_FrameTypeDef *p_frame;
+
+  while ((HAL_FDCAN_GetRxFifoFillLevel(&hfdcan, RxFifo) > 0U) && (CanRxPaused == 0U))
+  {
+    if ((CanRxHead - CanRxTail) >= CAN_RX_RING_SIZE)
+    {
+      CanRxPaused = 1U;
+
+      HAL_FDCAN_DeactivateNotification(&hfdcan, (FDCAN_IT_RX_FIFO0_NEW_MESSAGE | FDCAN_IT_RX_FIFO1_NEW_MESSAGE));
+    }
+    else
+    {
+      p_frame = &CanRxRing[CanRxHead & (CAN_RX_RING_SIZE - 1U)];
+
+      if (HAL_FDCAN_GetRxMessage(&hfdcan, RxFifo, &rx_header, p_frame->Data) == HAL_OK)
+      {
+        p_frame->StdId = rx_header.Identifier;
+
+        /* The classic CAN data length codes above 8 also carry 8 bytes */
+        p_frame->DLC = (rx_header.DataLength < CAN_DLC_BYTES_8) ? rx_header.DataLength : CAN_DLC_BYTES_8;
+
+        CanRxHead = CanRxHead + 1U;
+      }
+    }
+  }
+}
+
+/**
+ * @brief  This function is used to get the next received frame from the reception ring.
+ * @param  pFrame Pointer to the frame to be filled.
+ * @retval None.
+ */
+static void OPENBL_CAN_GetFrame(OPENBL_CAN_FrameTypeDef *pFrame)
+{
+  /* Wait until at least one frame is received */
+  while (CanRxHead == CanRxTail)
+  {
+    OPENBL_IWDG_Refresh();
+  }
+
+  *pFrame   = CanRxRing[CanRxTail & (CAN_RX_RING_SIZE - 1U)];
+  CanRxTail = CanRxTail + 1U;
+
+  /* Resume the reception if it was paused because the ring was full. The frames already in
+     the Rx FIFOs raise no new interrupt, they are moved to the ring first */
+  if (CanRxPaused != 0U)
+  {
+    HAL_NVIC_DisableIRQ(CANx_IRQn);
+
+    CanRxPaused = 0U;
+
+    OPENBL_CAN_DrainRxFifo(FDCAN_RX_FIFO0);
+    OPENBL_CAN_DrainRxFifo(FDCAN_RX_FIFO1);
+
+    if (CanRxPaused == 0U)
+    {
+      HAL_FDCAN_ActivateNotification(&hfdcan, (FDCAN_IT_RX_FIFO0_NEW_MESSAGE | FDCAN_IT_RX_FIFO1_NEW_MESSAGE), 0U);
+    }
+
+    HAL_NVIC_EnableIRQ(CANx_IRQn);
+  }
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief  This function is used to configure CAN pins and then initialize the used FDCAN instance.
+ * @retval None.
+ */
+void OPENBL_CAN_Configuration(void)
+{
+  /* Enable all resources clocks --------------------------------------------*/
+  /* Enable used GPIOx clocks */
+  CANx_GPIO_CLK_ENABLE();
+
+  OPENBL_CAN_Init();
+}
+
+/**
+ * @brief  This function is used to De-initialize the CAN pins and instance.
+ * @retval None.
+ */
+void OPENBL_CAN_DeInit(void)
+{
+  /* Let the pending responses leave the Tx buffers, e.g. the ACK sent before a jump */
+  OPENBL_CAN_FlushTx();
+
+  /* Only de-initialize the CAN if it is not the current detected interface */
+  if (CanDetected == 0U)
+  {
+    HAL_NVIC_DisableIRQ(CANx_IRQn);
+
+    CANx_FORCE_RESET();
+    CANx_RELEASE_RESET();
+    HAL_GPIO_DeInit(CANx_TX_GPIO_PORT, CANx_TX_PIN);
+    HAL_GPIO_DeInit(CANx_RX_GPIO_PORT, CANx_RX_PIN);
+
+    CANx_CLK_DISABLE();
+  }
+}
+
+/**
+ * @brief  This function is used to detect if there is any activity on CAN protocol.
+ * @retval Returns 1 if interface is detected else 0.
+ */
+uint8_t OPENBL_CAN_ProtocolDetection(void)
+{
+  /* Check if at least one frame has been received */
+  if (CanRxHead != CanRxTail)
+  {
+    CanDetected = 1U;
+  }
+  else
+  {
+    CanDetected = 0U;
+  }
+
+  return CanDetected;
+}
+
+/**
+ * @brief  This function is used to get the command opcode from the host.
+ * @retval Returns the command.
+ */
+uint8_t OPENBL_CAN_GetCommandOpcode(void)
+{
+  uint32_t index;
+  OPENBL_CAN_FrameTypeDef frame;
+
+  OPENBL_CAN_GetFrame(&frame);
+
+  /* The command parameters are carried by the data bytes of the command frame */
+  for (index = 0U; index < frame.DLC; index++)
+  {
+    tCanRxData[index] = frame.Data[index];
+  }
+
+  /* The responses use the identifier of the command */
+  TxHeader.Identifier = frame.StdId;
+
+  return (uint8_t)frame.StdId;
+}
+
+/**
+  * @brief  This function is used to read one byte from CAN pipe.
+  * @retval Returns the read byte.
+  */
+uint8_t OPENBL_CAN_ReadByte(void)
+{
+  OPENBL_CAN_FrameTypeDef frame;
+
+  OPENBL_CAN_GetFrame(&frame);
+
+  return frame.Data[0];
+}
+
+/**
+  * @brief  This function is used to read bytes from CAN pipe.
+  * @param  Buffer The buffer where the received bytes are stored.
+  * @param  BufferSize The maximum number of bytes to be stored.
+  * @retval None.
+  */
+void OPENBL_CAN_ReadBytes(uint8_t *Buffer, uint32_t BufferSize)
+{
+  uint32_t index;
+  OPENBL_CAN_FrameTypeDef frame;
+
+  OPENBL_CAN_GetFrame(&frame);
+
+  for (index = 0U; (index < frame.DLC) && (index < BufferSize); index++)
+  {
+    Buffer[index] = frame.Data[index];
+  }
+}
+
+/**
+  * @brief  This function is used to send one byte through CAN pipe.
+  * @param  Byte The byte to be sent.
+  * @retval None.
+  */
+void OPENBL_CAN_SendByte(uint8_t Byte)
+{
+  OPENBL_CAN_SendBytes(&Byte, CAN_DLC_BYTES_1);
+}
+
+/**
+  * @brief  This function is used to send a buffer using CAN.
+  * @note   The frame is only queued in a free Tx buffer, the function does not wait for its
+  *         transmission so that the three Tx buffers are kept busy. The frame is dropped when
+  *         no Tx buffer is freed, e.g. when no host acknowledges the frames.
+  * @param  Buffer The data buffer to be sent.
+  * @param  BufferSize The size of the data buffer to be sent.
+  * @retval None.
+  */
+void OPENBL_CAN_SendBytes(uint8_t *Buffer, uint32_t BufferSize)
+{
+  uint32_t tick = 0U;
+
+  /* Wait for a free Tx buffer */
+  while ((HAL_FDCAN_GetTxFifoFreeLevel(&hfdcan) == 0U) && (tick < CAN_TX_TIMEOUT))
+  {
+    OPENBL_IWDG_Refresh();
+    tick++;
+  }
+
+  if (HAL_FDCAN_GetTxFifoFreeLevel(&hfdcan) != 0U)
+  {
+    TxHeader.DataLength = BufferSize;
+
+    /* The data are copied in the Tx buffer, the buffer can be reused on return */
+    HAL_FDCAN_AddMessageToTxFifoQ(&hfdcan, &TxHeader, Buffer);
+  }
+}
+
+/**
+  * @brief  This function is used to answer the host polling during a flash operation.
+  * @note   The host polls by sending one frame with the identifier of the running command,
+  *         it is answered with the busy frame. Any other frame is left in the reception ring
+  *         for the command. The function runs from RAM while the FLASH is busy, so the busy
+  *         frame is written to the message RAM directly instead of calling the HAL.
+  * @retval None.
+  */
+OPENBL_HOT_PATH void OPENBL_CAN_SendBusyState(void)
+{
+  uint32_t index;
+  uint32_t length;
+  uint32_t put_index;
+  uint32_t *p_element;
+  uint32_t a_words[2] = {0U, 0U};
+  uint8_t busy_frame[COMMON_BUSY_FRAME_SIZE];
+
+  if ((CanRxHead != CanRxTail) && (CanRxRing[CanRxTail & (CAN_RX_RING_SIZE - 1U)].StdId == TxHeader.Identifier)
+      && ((hfdcan.Instance->TXFQS & FDCAN_TXFQS_TFQF) == 0U))
+  {
+    /* Discard the poll frame */
+    CanRxTail = CanRxTail + 1U;
+
+    length = Common_SetBusyFrame(busy_frame);
+
+    for (index = 0U; index < length; index++)
+    {
+      a_words[index / 4U] |= (uint32_t)busy_frame[index] << (8U * (index % 4U));
+    }
+
+    put_index = (hfdcan.Instance->TXFQS & FDCAN_TXFQS_TFQPI) >> FDCAN_TXFQS_TFQPI_Pos;
+    p_element = (uint32_t *)(hfdcan.msgRam.TxFIFOQSA + (put_index * CAN_TX_ELEMENT_SIZE));
+
+    /* Classic data frame with the identifier of the running command */
+    p_element[0] = TxHeader.Identifier << CAN_ELEMENT_STD_ID_POS;
+    p_element[1] = length << CAN_ELEMENT_DLC_POS;
+    p_element[2] = a_words[0];
+    p_element[3] = a_words[1];
+
+    hfdcan.Instance->TXBAR = 1UL << put_index;
+  }
+}
+
+/**
+  * @brief  This function is used to check if a bus error occurred since its last call.
+  * @note   The CAN controller retransmits the corrupted frames by itself, the last error
+  *         code is the only trace of them. Reading it marks it as read.
+  * @retval Returns SET if a bus error was detected else returns RESET.
+  */
+FlagStatus OPENBL_CAN_GetLinkErrorStatus(void)
+{
+  FDCAN_ProtocolStatusTypeDef protocol_status;
+  FlagStatus status = RESET;
+
+  HAL_FDCAN_GetProtocolStatus(&hfdcan, &protocol_status);
+
+  if ((protocol_status.LastErrorCode != FDCAN_PROTOCOL_ERROR_NONE)
+      && (protocol_status.LastErrorCode != FDCAN_PROTOCOL_ERROR_NO_CHANGE))
+  {
+    status = SET;
+  }
+
+  return status;
+}
+
+/**
+  * @brief  This function is used to change the CAN speed.
+  * @note   The new speed is applied by the next OPENBL_CAN_Configuration() call.
+  * @param  Speed The index of the new speed in the CAN speed table:
+  *         1: 125 kbps, 2: 250 kbps, 3: 500 kbps, 4: 1 Mbps.
+  * @retval None.
+  */
+void OPENBL_CAN_ChangePrescaler(uint32_t Speed)
+{
+  if (Speed < CAN_SPEED_NB)
+  {
+    CanPrescaler = CANx_CLOCK_FREQ / (CAN_TIME_QUANTA * a_CanSpeedTable[Speed]);
+  }
+}
+
+/**
+  * @brief  Handle the FDCAN Rx FIFO 0 and Rx FIFO 1 new message interrupts.
+  * @note   This function must be called from the CANx_IRQn interrupt handler.
+  * @retval None.
+  */
+void OPENBL_CAN_IRQHandler(void)
+{
+  /* Clear the flags first, a frame received while draining raises the interrupt again */
+  __HAL_FDCAN_CLEAR_FLAG(&hfdcan, (FDCAN_FLAG_RX_FIFO0_NEW_MESSAGE | FDCAN_FLAG_RX_FIFO1_NEW_MESSAGE));
+
+  OPENBL_CAN_DrainRxFifo(FDCAN_RX_FIFO0);
+  OPENBL_CAN_DrainRxFifo(FDCAN_RX_FIFO1);
+}
@@ -20,13 +20,42 @@
 #include "platform.h"
 #include "flash_interface.h"
 #include "openbootloader_conf.h"
+#include "openbl_core.h"
+#include "openbl_mem.h"
+#include "interfaces_conf.h"
 #include "common_interface.h"
+#include "openbl_kernels.h"
 
 /* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint32_t Address;             /*!< Start address of the extent */
+  uint32_t Length;              /*!< Length in bytes of the extent */
+} OPENBL_ExtentTypeDef;
+
 /* Private define ------------------------------------------------------------*/
+#define COMMON_PAINT_PATTERN              0xCDCDCDCDU  /* Pattern of the unused stack and buffers */
+#define COMMON_PAINT_BYTE                 0xCDU        /* Pattern byte of the unused buffers */
+#define COMMON_STACK_MARGIN               64U          /* Bytes left unpainted below the current stack pointer */
+
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 static Function_Pointer ResetCallback;
+static uint8_t BroadcastStatus = ACK_BYTE;
+static uint32_t BroadcastAcks = 0U;
+static uint32_t SessionFrameSize = COMMON_FRAME_SIZE_MAX;
+static uint8_t SessionWindow = COMMON_WINDOW_DEPTH_MAX;
+static uint32_t LinkFrameSize = COMMON_FRAME_SIZE_MAX;
+static uint32_t LinkFrames = 0U;
+static uint32_t LinkErrors = 0U;
+static uint32_t LinkRetries = 0U;
+static uint32_t LinkStreak = 0U;
+static uint8_t LinkLastStatus = ACK_BYTE;
+static OPENBL_ExtentTypeDef a_Extents[COMMON_EXTENTS_MAX];
+static uint32_t ExtentsNumber = 0U;
+static uint32_t ExtentIndex = 0U;
+static uint32_t ExtentOffset = 0U;
+static uint32_t BusyStateNesting = 0U;
 
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
@@ -80,6 +109,30 @@ FlagStatus Common_GetProtectionStatus(void)
   return status;
 }
 
+/**
+  * @brief  Checks whether a part of a memory range is write protected or not.
+  * @param  Address The start address of the range.
+  * @param  Length The length of the range.
+  * @note   The page of the image metadata record is protected from the host, it is only
+  *         written by Common_SetImageMetadata.
+  * @retval Returns SET if a part of the range is write protected else return RESET.
+  */
+FlagStatus Common_GetWriteProtectionStatus(uint32_t Address, uint32_t Length)
+{
+  FlagStatus status;
+
+  if ((Address < (OPENBL_METADATA_ADDRESS + FLASH_PAGE_SIZE)) && ((Address + Length) > OPENBL_METADATA_ADDRESS))
+  {
+    status = SET;
+  }
+  else
+  {
+    status = OPENBL_FLASH_GetWriteProtectionStatus(Address, Length);
+  }
+
+  return status;
+}
+
 /**
   * @brief  Register a callback function to be called at the end of commands processing.
   * @retval None.
@@ -103,3 +156,885 @@ void Common_StartPostProcessing()
     ResetCallback = NULL;
   }
 }
+
+/**
+  * @brief  Start the core cycle counter without resetting it.
+  * @note   Used to time the flash operations, the measures are differences of the counter.
+  * @retval None.
+  */
+void Common_EnableCycleCounter(void)
+{
+  /* Enable the trace and debug blocks */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+  * @brief  Return the number of core cycles elapsed since the cycle counter start.
+  * @retval Returns the cycle counter value.
+  */
+uint32_t Common_GetCycleCounter(void)
+{
+  return DWT->CYCCNT;
+}
+
+/**
+  * @brief  Fill the unused part of the main stack with the paint pattern.
+  * @note   Called by OPENBL_Init before the interfaces initialization, so that
+  *         Common_GetStackUsage() reports the stack high-water mark.
+  * @retval None.
+  */
+void Common_PaintStack(void)
+{
+  uint32_t primask_bit;
+  uint32_t stack_top;
+  __IO uint32_t *p_stack;
+
+  /* The initial main stack pointer is the first entry of the vector table */
+  stack_top = *(__IO uint32_t *)(SCB->VTOR);
+  p_stack   = (__IO uint32_t *)(stack_top - OPENBL_STACK_SIZE);
+
+  /* Interrupts must not push a frame while the free stack is painted */
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  while ((uint32_t)p_stack < (__get_MSP() - COMMON_STACK_MARGIN))
+  {
+    *p_stack = COMMON_PAINT_PATTERN;
+    p_stack++;
+  }
+
+  __set_PRIMASK(primask_bit);
+}
+
+/**
+  * @brief  Fill a RAM buffer with the paint pattern.
+  * @param  pBuffer Pointer to the buffer to be painted.
+  * @param  Size The size of the buffer.
+  * @retval None.
+  */
+void Common_PaintBuffer(uint8_t *pBuffer, uint32_t Size)
+{
+  OPENBL_KERNEL_Fill(pBuffer, Size, COMMON_PAINT_BYTE);
+}
+
+/**
+  * @brief  Return the high-water mark of the main stack.
+  * @retval Returns the maximum number of stack bytes used since the stack has been painted.
+  */
+uint32_t Common_GetStackUsage(void)
+{
+  uint32_t stack_top;
+  __IO uint32_t *p_stack;
+
+  stack_top = *(__IO uint32_t *)(SCB->VTOR);
+  p_stack   = (__IO uint32_t *)(stack_top - OPENBL_STACK_SIZE);
+
+  /* The stack grows downward, the first overwritten word from the bottom is the high-water mark */
+  while (((uint32_t)p_stack < stack_top) && (*p_stack == COMMON_PAINT_PATTERN))
+  {
+    p_stack++;
+  }
+
+  return (stack_top - (uint32_t)p_stack);
+}
+
+/**
+  * @brief  Return the high-water mark of a painted RAM buffer.
+  * @param  pBuffer Pointer to the buffer.
+  * @param  Size The size of the buffer.
+  * @retval Returns the number of bytes from the buffer start up to the last overwritten byte.
+  */
+uint32_t Common_GetBufferUsage(uint8_t *pBuffer, uint32_t Size)
+{
+  uint32_t used = Size;
+
+  while ((used != 0U) && (pBuffer[used - 1U] == COMMON_PAINT_BYTE))
+  {
+    used--;
+  }
+
+  return used;
+}
+
+/**
+  * @brief  Add the usage of a RAM area to a RAM usage report.
+  * @param  pReport Pointer to the report entry to be filled.
+  * @param  Size The size of the RAM area, sent MSB first.
+  * @param  Used The number of used bytes of the RAM area, sent MSB first.
+  * @retval Returns the size of the report entry.
+  */
+uint32_t Common_SetRamUsageEntry(uint8_t *pReport, uint32_t Size, uint32_t Used)
+{
+  pReport[0] = (uint8_t)(Size >> 24);
+  pReport[1] = (uint8_t)(Size >> 16);
+  pReport[2] = (uint8_t)(Size >> 8);
+  pReport[3] = (uint8_t)(Size & 0xFFU);
+  pReport[4] = (uint8_t)(Used >> 24);
+  pReport[5] = (uint8_t)(Used >> 16);
+  pReport[6] = (uint8_t)(Used >> 8);
+  pReport[7] = (uint8_t)(Used & 0xFFU);
+
+  return COMMON_RAM_USAGE_ENTRY_SIZE;
+}
+
+/**
+  * @brief  Start or resume a FLASH erase that runs by slices of pages.
+  * @note   A bank option sent MSB first (FLASH_MASS_ERASE, FLASH_BANK1_ERASE or FLASH_BANK2_ERASE) starts a new
+  *         erase, an empty buffer resumes the suspended one. In both cases OPENBL_ERASE_SLICE_PAGES
+  *         pages are erased before the erase is suspended again, so that the host can read the
+  *         other memories between two requests.
+  * @param  pReport Pointer to the report: remaining pages MSB first, then ACK_BYTE or NACK_BYTE.
+  * @param  p_Data Pointer to the request buffer.
+  * @param  DataLength Size of the request buffer.
+  * @retval Returns the size of the report.
+  */
+uint32_t Common_SuspendableErase(uint8_t *pReport, uint8_t *p_Data, uint32_t DataLength)
+{
+  uint32_t remaining;
+  uint32_t first_page = 0U;
+  uint32_t pages_number = 0U;
+  uint16_t bank_option;
+  ErrorStatus status = SUCCESS;
+
+  if (DataLength >= 2U)
+  {
+    bank_option = (uint16_t)(((uint16_t)p_Data[0] << 8) | p_Data[1]);
+
+    if (bank_option == FLASH_MASS_ERASE)
+    {
+      pages_number = 2U * FLASH_PAGE_NB;
+    }
+    else if (bank_option == FLASH_BANK1_ERASE)
+    {
+      pages_number = FLASH_PAGE_NB;
+    }
+    else if (bank_option == FLASH_BANK2_ERASE)
+    {
+      first_page   = FLASH_PAGE_NB;
+      pages_number = FLASH_PAGE_NB;
+    }
+    else
+    {
+      status = ERROR;
+    }
+
+    if (status == SUCCESS)
+    {
+      status = OPENBL_MEM_StartSuspendableErase(OPENBL_DEFAULT_MEM, first_page, pages_number);
+    }
+
+    /* The job skips the metadata page: erase it with its bank, as the bank erase does */
+    if ((status == SUCCESS) && (OPENBL_METADATA_PAGE >= first_page)
+        && (OPENBL_METADATA_PAGE < (first_page + pages_number)))
+    {
+      status = OPENBL_FLASH_EraseMetadata();
+    }
+  }
+
+  if (status == SUCCESS)
+  {
+    status = OPENBL_MEM_ResumeErase(OPENBL_ERASE_SLICE_PAGES);
+  }
+
+  remaining = OPENBL_MEM_GetSuspendedErasePages();
+
+  pReport[0] = (uint8_t)(remaining >> 8);
+  pReport[1] = (uint8_t)(remaining & 0xFFU);
+  pReport[2] = (status == SUCCESS) ? ACK_BYTE : NACK_BYTE;
+
+  return COMMON_ERASE_REPORT_SIZE;
+}
+
+/**
+  * @brief  This function is used to enable the busy state sending during memory operations.
+  * @note   While enabled, the detected interface answers the host polling with its busy state.
+  *         The calls can be nested, e.g. a command enables it around an erase that flushes
+  *         the write cache.
+  * @retval None.
+  */
+void OPENBL_Enable_BusyState_Sending(void)
+{
+  BusyStateNesting++;
+
+  /* Enable Flash busy state sending */
+  OPENBL_Enable_BusyState_Flag();
+}
+
+/**
+  * @brief  This function is used to disable the busy state sending during memory operations.
+  * @note   The sending stops when the outermost enable is matched.
+  * @retval None.
+  */
+void OPENBL_Disable_BusyState_Sending(void)
+{
+  if (BusyStateNesting > 0U)
+  {
+    BusyStateNesting--;
+  }
+
+  if (BusyStateNesting == 0U)
+  {
+    /* Disable Flash busy state sending */
+    OPENBL_Disable_BusyState_Flag();
+  }
+}
+
+/**
+  * @brief  Fill a busy frame with the progress of the current flash request.
+  * @param  pFrame Pointer to the frame: busy byte, then operations done, operations total
+  *         and remaining time in ms, each of them 16-bit MSB first.
+  * @retval Returns the size of the busy frame.
+  */
+OPENBL_HOT_PATH uint32_t Common_SetBusyFrame(uint8_t *pFrame)
+{
+  pFrame[0] = BUSY_BYTE;
+  pFrame[1] = (uint8_t)(FlashProgress.Done >> 8);
+  pFrame[2] = (uint8_t)(FlashProgress.Done & 0xFFU);
+  pFrame[3] = (uint8_t)(FlashProgress.Total >> 8);
+  pFrame[4] = (uint8_t)(FlashProgress.Total & 0xFFU);
+  pFrame[5] = (uint8_t)(FlashProgress.RemainingTime >> 8);
+  pFrame[6] = (uint8_t)(FlashProgress.RemainingTime & 0xFFU);
+
+  return COMMON_BUSY_FRAME_SIZE;
+}
+
+/**
+  * @brief  Record an acknowledge of a broadcast command instead of sending it.
+  * @note   The nodes do not answer the broadcast commands, their outcome is
+  *         reported afterwards to each node by Common_GetBroadcastStatus.
+  * @param  Byte The byte that would have been sent to the host.
+  * @retval None.
+  */
+OPENBL_HOT_PATH void Common_RecordBroadcastByte(uint8_t Byte)
+{
+  if (Byte == ACK_BYTE)
+  {
+    BroadcastAcks++;
+  }
+  else if (Byte == NACK_BYTE)
+  {
+    BroadcastStatus = NACK_BYTE;
+  }
+  else
+  {
+    /* Other bytes of a broadcast command are dropped */
+  }
+}
+
+/**
+  * @brief  Report the outcome of the broadcast commands, the record is cleared once reported.
+  * @param  pReport Pointer to the report: status (ACK or NACK) then the number of
+  *         acknowledges of the broadcast commands, 32-bit MSB first.
+  * @retval Returns the size of the report.
+  */
+uint32_t Common_GetBroadcastStatus(uint8_t *pReport)
+{
+  pReport[0] = BroadcastStatus;
+  pReport[1] = (uint8_t)(BroadcastAcks >> 24);
+  pReport[2] = (uint8_t)(BroadcastAcks >> 16);
+  pReport[3] = (uint8_t)(BroadcastAcks >> 8);
+  pReport[4] = (uint8_t)(BroadcastAcks & 0xFFU);
+
+  BroadcastStatus = ACK_BYTE;
+  BroadcastAcks   = 0U;
+
+  return COMMON_BROADCAST_STATUS_SIZE;
+}
+
+/**
+  * @brief  Report the running estimates of the flash operations durations.
+  * @note   The estimates start from the datasheet values and are refined by each
+  *         operation, the host uses them to tune its timeouts.
+  * @param  pReport Pointer to the report: page erase, bank erase and quad-word program
+  *         durations in us, each of them 32-bit MSB first.
+  * @retval Returns the size of the report.
+  */
+uint32_t Common_GetFlashTiming(uint8_t *pReport)
+{
+  uint32_t index;
+  uint32_t a_timing[3];
+
+  a_timing[0] = FlashTiming.PageEraseTime;
+  a_timing[1] = FlashTiming.BankEraseTime;
+  a_timing[2] = FlashTiming.QuadWordProgramTime;
+
+  for (index = 0U; index < 3U; index++)
+  {
+    pReport[(4U * index)]      = (uint8_t)(a_timing[index] >> 24);
+    pReport[(4U * index) + 1U] = (uint8_t)(a_timing[index] >> 16);
+    pReport[(4U * index) + 2U] = (uint8_t)(a_timing[index] >> 8);
+    pReport[(4U * index) + 3U] = (uint8_t)(a_timing[index] & 0xFFU);
+  }
+
+  return COMMON_FLASH_TIMING_SIZE;
+}
+
+/**
+  * @brief  Apply the session parameters selected by the host during the handshake.
+  * @note   Each parameter is clamped to what the device supports, a null frame size
+  *         or window depth keeps the current value. The frames are always checked with
+  *         the XOR checksum, the integrity modes of the host are not used.
+  * @param  pSelection Pointer to the selection: frame size 16-bit MSB first, integrity
+  *         modes supported by the host (COMMON_INTEGRITY_xxx) then window depth.
+  * @retval None.
+  */
+void Common_SelectSession(const uint8_t *pSelection)
+{
+  uint32_t frame_size;
+
+  frame_size = ((uint32_t)pSelection[0] << 8) | (uint32_t)pSelection[1];
+
+  if (frame_size != 0U)
+  {
+    SessionFrameSize = (frame_size < COMMON_FRAME_SIZE_MAX) ? frame_size : COMMON_FRAME_SIZE_MAX;
+    LinkFrameSize    = SessionFrameSize;
+  }
+
+  if (pSelection[3] != 0U)
+  {
+    SessionWindow = (pSelection[3] < COMMON_WINDOW_DEPTH_MAX) ? pSelection[3] : (uint8_t)COMMON_WINDOW_DEPTH_MAX;
+  }
+
+  /* A new session starts with clean link statistics */
+  LinkFrames     = 0U;
+  LinkErrors     = 0U;
+  LinkRetries    = 0U;
+  LinkStreak     = 0U;
+  LinkLastStatus = ACK_BYTE;
+}
+
+/**
+  * @brief  Fill the header of the handshake report.
+  * @param  pReport Pointer to the report: protocol version, device ID, maximum frame size,
+  *         integrity modes, maximum window depth, speed options, then the selected frame
+  *         size, integrity mode and window depth. 16-bit fields are sent MSB first.
+  * @param  Version Protocol version of the interface.
+  * @param  SpeedOptions Bitmap of the values accepted by the Speed command, 0 if none.
+  * @retval Returns the size of the header.
+  */
+uint32_t Common_SetHandshakeHeader(uint8_t *pReport, uint8_t Version, uint8_t SpeedOptions)
+{
+  pReport[0]  = Version;
+  pReport[1]  = DEVICE_ID_MSB;
+  pReport[2]  = DEVICE_ID_LSB;
+  pReport[3]  = (uint8_t)(COMMON_FRAME_SIZE_MAX >> 8);
+  pReport[4]  = (uint8_t)(COMMON_FRAME_SIZE_MAX & 0xFFU);
+  pReport[5]  = COMMON_INTEGRITY_XOR;
+  pReport[6]  = COMMON_WINDOW_DEPTH_MAX;
+  pReport[7]  = SpeedOptions;
+  pReport[8]  = (uint8_t)(Common_GetFrameSize() >> 8);
+  pReport[9]  = (uint8_t)(Common_GetFrameSize() & 0xFFU);
+  pReport[10] = COMMON_INTEGRITY_XOR;
+  pReport[11] = SessionWindow;
+
+  return COMMON_HANDSHAKE_HEADER_SIZE;
+}
+
+/**
+  * @brief  Get the frame size selected for the session.
+  * @note   With OPENBL_ADAPTIVE_FRAME_SIZE, it is the frame size recommended from the link errors.
+  * @retval Returns the maximum number of data bytes of a read or write frame.
+  */
+uint32_t Common_GetFrameSize(void)
+{
+  uint32_t frame_size = SessionFrameSize;
+
+  /* The host learns the adapted frame size from the handshake or the link status */
+  if (OPENBL_ADAPTIVE_FRAME_SIZE != 0U)
+  {
+    frame_size = LinkFrameSize;
+  }
+
+  return frame_size;
+}
+
+/**
+  * @brief  Check that a read or write frame fits in the frame size selected for the session.
+  * @note   The frame size recommended from the link errors is only advised to the host,
+  *         the frames are checked against the frame size selected by the host.
+  * @param  Length The number of data bytes of the frame.
+  * @retval Returns 1 if the frame size is accepted else returns 0.
+  */
+uint8_t Common_CheckFrameSize(uint32_t Length)
+{
+  return (Length <= SessionFrameSize) ? 1U : 0U;
+}
+
+/**
+  * @brief  Record the integrity of a data frame received from the host.
+  * @note   An integrity failure halves the recommended frame size, down to COMMON_FRAME_SIZE_MIN,
+  *         and COMMON_LINK_GROW_FRAMES consecutive valid frames double it, up to the frame
+  *         size selected by the host. A frame received after a failure counts as a retry.
+  * @param  Status ACK_BYTE if the frame is valid, NACK_BYTE if its integrity check failed.
+  * @retval None.
+  */
+void Common_RecordLinkFrame(uint8_t Status)
+{
+  LinkFrames++;
+
+  if (LinkLastStatus == NACK_BYTE)
+  {
+    LinkRetries++;
+  }
+
+  if (Status == NACK_BYTE)
+  {
+    LinkErrors++;
+    LinkStreak = 0U;
+
+    if ((LinkFrameSize / 2U) >= COMMON_FRAME_SIZE_MIN)
+    {
+      LinkFrameSize = LinkFrameSize / 2U;
+    }
+  }
+  else
+  {
+    LinkStreak++;
+
+    if ((LinkStreak >= COMMON_LINK_GROW_FRAMES) && (LinkFrameSize < SessionFrameSize))
+    {
+      LinkStreak    = 0U;
+      LinkFrameSize = ((LinkFrameSize * 2U) < SessionFrameSize) ? (LinkFrameSize * 2U) : SessionFrameSize;
+    }
+  }
+
+  LinkLastStatus = Status;
+}
+
+/**
+  * @brief  Report the link error statistics of the session.
+  * @param  pReport Pointer to the report: received frames, integrity failures and retries,
+  *         each of them 32-bit MSB first, then the recommended frame size 16-bit MSB first.
+  * @retval Returns the size of the report.
+  */
+uint32_t Common_GetLinkStatus(uint8_t *pReport)
+{
+  uint32_t index;
+  uint32_t a_counters[3];
+
+  a_counters[0] = LinkFrames;
+  a_counters[1] = LinkErrors;
+  a_counters[2] = LinkRetries;
+
+  for (index = 0U; index < 3U; index++)
+  {
+    pReport[(4U * index)]      = (uint8_t)(a_counters[index] >> 24);
+    pReport[(4U * index) + 1U] = (uint8_t)(a_counters[index] >> 16);
+    pReport[(4U * index) + 2U] = (uint8_t)(a_counters[index] >> 8);
+    pReport[(4U * index) + 3U] = (uint8_t)(a_counters[index] & 0xFFU);
+  }
+
+  pReport[12] = (uint8_t)(LinkFrameSize >> 8);
+  pReport[13] = (uint8_t)(LinkFrameSize & 0xFFU);
+
+  return COMMON_LINK_STATUS_SIZE;
+}
+
+/**
+  * @brief  Hand the device over to the application without de-initializing each interface.
+  * @note   The peripherals used by the Open Bootloader are reset at once through the RCC
+  *         reset registers and their clocks are stopped. With OPENBL_HANDOFF_KEEP_CLOCKS,
+  *         the PLL and the flash latency stay configured and their state is written in the
+  *         hand-off block so that the application can skip its clock configuration.
+  * @retval None.
+  */
+void Common_FastHandOff(void)
+{
+  uint32_t index;
+  OPENBL_HandOffTypeDef *p_block;
+
+  /* The hand-off block is in the backup domain, its write access must be enabled */
+  __HAL_RCC_PWR_CLK_ENABLE();
+  __HAL_RCC_RTCAPB_CLK_ENABLE();
+  HAL_PWR_EnableBkUpAccess();
+
+  p_block = (OPENBL_HandOffTypeDef *)((uint32_t)&(TAMP->BKP0R) + (4U * OPENBL_HANDOFF_BKP_INDEX));
+
+  if (OPENBL_HANDOFF_KEEP_CLOCKS != 0U)
+  {
+    p_block->SysClockFreq = HAL_RCC_GetSysClockFreq();
+    p_block->Cfgr1        = RCC->CFGR1;
+    p_block->Cfgr2        = RCC->CFGR2;
+    p_block->Pll1Cfgr     = RCC->PLL1CFGR;
+    p_block->Pll1Divr     = RCC->PLL1DIVR;
+    p_block->FlashAcr     = FLASH->ACR;
+    p_block->Magic        = COMMON_HANDOFF_MAGIC;
+  }
+  else
+  {
+    p_block->Magic = 0U;
+
+    /* Back to the reset clock configuration, MSI at 4 MHz needs no wait state */
+    HAL_RCC_DeInit();
+    __HAL_FLASH_SET_LATENCY(FLASH_LATENCY_0);
+  }
+
+  Common_DisableIrq();
+
+  /* Stop the tick then disable and clear all the interrupts left by the interfaces */
+  SysTick->CTRL = 0U;
+
+  for (index = 0U; index < (sizeof(NVIC->ICER) / sizeof(NVIC->ICER[0])); index++)
+  {
+    NVIC->ICER[index] = 0xFFFFFFFFU;
+    NVIC->ICPR[index] = 0xFFFFFFFFU;
+  }
+
+  /* Reset the used peripherals at once */
+  RCC->AHB1RSTR  |= HANDOFF_AHB1_PERIPHERALS;
+  RCC->AHB2RSTR1 |= HANDOFF_AHB2_1_PERIPHERALS;
+  RCC->AHB2RSTR2 |= HANDOFF_AHB2_2_PERIPHERALS;
+  RCC->APB1RSTR1 |= HANDOFF_APB1_1_PERIPHERALS;
+  RCC->APB1RSTR2 |= HANDOFF_APB1_2_PERIPHERALS;
+  RCC->APB2RSTR  |= HANDOFF_APB2_PERIPHERALS;
+
+  RCC->AHB1RSTR  &= ~HANDOFF_AHB1_PERIPHERALS;
+  RCC->AHB2RSTR1 &= ~HANDOFF_AHB2_1_PERIPHERALS;
+  RCC->AHB2RSTR2 &= ~HANDOFF_AHB2_2_PERIPHERALS;
+  RCC->APB1RSTR1 &= ~HANDOFF_APB1_1_PERIPHERALS;
+  RCC->APB1RSTR2 &= ~HANDOFF_APB1_2_PERIPHERALS;
+  RCC->APB2RSTR  &= ~HANDOFF_APB2_PERIPHERALS;
+
+  /* Stop their clocks, the reset and clock enable registers share their bit positions */
+  RCC->AHB1ENR  &= ~HANDOFF_AHB1_PERIPHERALS;
+  RCC->AHB2ENR1 &= ~HANDOFF_AHB2_1_PERIPHERALS;
+  RCC->AHB2ENR2 &= ~HANDOFF_AHB2_2_PERIPHERALS;
+  RCC->APB1ENR1 &= ~HANDOFF_APB1_1_PERIPHERALS;
+  RCC->APB1ENR2 &= ~HANDOFF_APB1_2_PERIPHERALS;
+  RCC->APB2ENR  &= ~HANDOFF_APB2_PERIPHERALS;
+}
+
+/**
+  * @brief  Store the metadata of the programmed image, at the end of a successful session.
+  * @param  pReport Pointer to the report: ACK or NACK byte.
+  * @param  p_Data Pointer to the metadata: version, build hash, length and CRC32 of the
+  *         image, each of them 32-bit MSB first.
+  * @param  DataLength Size of the metadata buffer.
+  * @retval Returns the size of the report.
+  */
+uint32_t Common_SetImageMetadata(uint8_t *pReport, uint8_t *p_Data, uint32_t DataLength)
+{
+  OPENBL_ImageMetadataTypeDef metadata;
+  uint32_t a_fields[4];
+  uint32_t index;
+  ErrorStatus status = ERROR;
+
+  if (DataLength >= COMMON_METADATA_SIZE)
+  {
+    for (index = 0U; index < 4U; index++)
+    {
+      a_fields[index] = ((uint32_t)p_Data[(4U * index)] << 24) | ((uint32_t)p_Data[(4U * index) + 1U] << 16)
+                        | ((uint32_t)p_Data[(4U * index) + 2U] << 8) | (uint32_t)p_Data[(4U * index) + 3U];
+    }
+
+    metadata.Magic       = COMMON_METADATA_MAGIC;
+    metadata.Version     = a_fields[0];
+    metadata.BuildHash   = a_fields[1];
+    metadata.Length      = a_fields[2];
+    metadata.Crc         = a_fields[3];
+    metadata.Reserved[0] = 0xFFFFFFFFU;
+    metadata.Reserved[1] = 0xFFFFFFFFU;
+    metadata.Reserved[2] = 0xFFFFFFFFU;
+
+    /* The pages still in the write cache must reach the FLASH before the record vouches for them */
+    status = OPENBL_MEM_Flush();
+
+    if (status == SUCCESS)
+    {
+      status = OPENBL_FLASH_EraseMetadata();
+    }
+
+    if (status == SUCCESS)
+    {
+      status = OPENBL_MEM_Write(OPENBL_METADATA_ADDRESS, (uint8_t *)&metadata, sizeof(metadata));
+    }
+
+    if (status == SUCCESS)
+    {
+      status = OPENBL_MEM_Flush();
+    }
+
+    /* Read the record back, the ACK must not vouch for a record that did not program */
+    if ((status == SUCCESS)
+        && (OPENBL_KERNEL_Compare((const uint8_t *)OPENBL_METADATA_ADDRESS, (uint8_t *)&metadata,
+                                  sizeof(metadata)) != 0U))
+    {
+      status = ERROR;
+    }
+  }
+
+  pReport[0] = (status == SUCCESS) ? ACK_BYTE : NACK_BYTE;
+
+  return COMMON_METADATA_SET_SIZE;
+}
+
+/**
+  * @brief  Compare the stored image metadata with the host one, to skip a redundant programming.
+  * @param  pReport Pointer to the report: ACK if the metadata match else NACK, then the
+  *         stored version, build hash, length and CRC32, each of them 32-bit MSB first.
+  * @param  p_Data Pointer to the host metadata, as for Common_SetImageMetadata, optionally
+  *         followed by an options byte. With COMMON_METADATA_CONFIRM_CRC, a match is
+  *         confirmed by the CRC32 of the image in FLASH, computed by OPENBL_FLASH_ComputeDigest:
+  *         CRC-32/MPEG-2 over the little-endian 32-bit words of the image, not the reflected
+  *         CRC-32 of zlib.
+  * @param  DataLength Size of the request buffer.
+  * @retval Returns the size of the report.
+  */
+uint32_t Common_CheckImageMetadata(uint8_t *pReport, uint8_t *p_Data, uint32_t DataLength)
+{
+  OPENBL_ImageMetadataTypeDef *p_metadata;
+  uint32_t a_stored[4];
+  uint32_t index;
+  uint32_t value;
+  uint8_t match = 0U;
+
+  /* The pages still in the write cache are not in the FLASH yet */
+  OPENBL_MEM_Flush();
+
+  p_metadata = (OPENBL_ImageMetadataTypeDef *)OPENBL_METADATA_ADDRESS;
+
+  a_stored[0] = p_metadata->Version;
+  a_stored[1] = p_metadata->BuildHash;
+  a_stored[2] = p_metadata->Length;
+  a_stored[3] = p_metadata->Crc;
+
+  if ((DataLength >= COMMON_METADATA_SIZE) && (p_metadata->Magic == COMMON_METADATA_MAGIC))
+  {
+    match = 1U;
+
+    for (index = 0U; index < 4U; index++)
+    {
+      value = ((uint32_t)p_Data[(4U * index)] << 24) | ((uint32_t)p_Data[(4U * index) + 1U] << 16)
+              | ((uint32_t)p_Data[(4U * index) + 2U] << 8) | (uint32_t)p_Data[(4U * index) + 3U];
+
+      if (value != a_stored[index])
+      {
+        match = 0U;
+      }
+    }
+
+    /* Optional confirmation of the image content, at the cost of a full read */
+    if ((match != 0U) && (DataLength > COMMON_METADATA_SIZE)
+        && ((p_Data[COMMON_METADATA_SIZE] & COMMON_METADATA_CONFIRM_CRC) != 0U))
+    {
+      if (((p_metadata->Length & 0x3U) != 0U) || (p_metadata->Length > OPENBL_IMAGE_SLOT_SIZE)
+          || (OPENBL_FLASH_ComputeDigest(OPENBL_IMAGE_START_ADDRESS, p_metadata->Length) != p_metadata->Crc))
+      {
+        match = 0U;
+      }
+    }
+  }
+
+  pReport[0] = (match != 0U) ? ACK_BYTE : NACK_BYTE;
+
+  for (index = 0U; index < 4U; index++)
+  {
+    pReport[(4U * index) + 1U] = (uint8_t)(a_stored[index] >> 24);
+    pReport[(4U * index) + 2U] = (uint8_t)(a_stored[index] >> 16);
+    pReport[(4U * index) + 3U] = (uint8_t)(a_stored[index] >> 8);
+    pReport[(4U * index) + 4U] = (uint8_t)(a_stored[index] & 0xFFU);
+  }
+
+  return COMMON_METADATA_CHECK_SIZE;
+}
+
+/**
+  * @brief  Open a sparse upload session from the extent table of the image.
+  * @note   Each FLASH page touched by the extents is erased once, the data of the
+  *         extents is then received by Common_WriteExtentData without any address.
+  *         The table is rejected if an extent cannot be written or if one of the pages
+  *         it touches is write protected. Busy frames are sent while the pages are erased.
+  * @param  pReport Pointer to the report: ACK or NACK byte then number of erased pages 16-bit MSB first.
+  * @param  p_Data Pointer to the extent table: address then length of each extent, each of them
+  *         32-bit MSB first. The extents are in FLASH, sorted by address and do not overlap.
+  * @param  DataLength Size of the extent table.
+  * @retval Returns the size of the report.
+  */
+uint32_t Common_StartExtents(uint8_t *pReport, uint8_t *p_Data, uint32_t DataLength)
+{
+  uint32_t index;
+  uint32_t address;
+  uint32_t length;
+  uint32_t page;
+  uint32_t end_page;
+  uint32_t last_page = 0xFFFFFFFFU;
+  uint32_t previous_end = FLASH_START_ADDRESS;
+  uint32_t erased_pages = 0U;
+  uint16_t a_erase_request[2];
+  ErrorStatus status = SUCCESS;
+
+  ExtentsNumber = DataLength / COMMON_EXTENT_ENTRY_SIZE;
+  ExtentIndex   = 0U;
+  ExtentOffset  = 0U;
+
+  if ((ExtentsNumber == 0U) || (ExtentsNumber > COMMON_EXTENTS_MAX) || ((DataLength % COMMON_EXTENT_ENTRY_SIZE) != 0U))
+  {
+    status = ERROR;
+  }
+
+  for (index = 0U; (index < ExtentsNumber) && (status == SUCCESS); index++)
+  {
+    address = ((uint32_t)p_Data[0] << 24) | ((uint32_t)p_Data[1] << 16) | ((uint32_t)p_Data[2] << 8) | (uint32_t)p_Data[3];
+    length  = ((uint32_t)p_Data[4] << 24) | ((uint32_t)p_Data[5] << 16) | ((uint32_t)p_Data[6] << 8) | (uint32_t)p_Data[7];
+    p_Data += COMMON_EXTENT_ENTRY_SIZE;
+
+    if ((address < previous_end) || (address >= FLASH_END_ADDRESS) || (length == 0U)
+        || (length > (FLASH_END_ADDRESS - address)))
+    {
+      status = ERROR;
+    }
+    else if (OPENBL_MEM_CheckWriteRange(address, length) == 0U)
+    {
+      status = ERROR;
+    }
+    else
+    {
+      /* The whole pages touched by the extent are erased, none of them may be protected */
+      page     = FLASH_START_ADDRESS + (((address - FLASH_START_ADDRESS) / FLASH_PAGE_SIZE) * FLASH_PAGE_SIZE);
+      end_page = FLASH_START_ADDRESS + ((((address + length - 1U - FLASH_START_ADDRESS) / FLASH_PAGE_SIZE) + 1U)
+                                        * FLASH_PAGE_SIZE);
+
+      if (Common_GetWriteProtectionStatus(page, end_page - page) != RESET)
+      {
+        status = ERROR;
+      }
+    }
+
+    if (status == SUCCESS)
+    {
+      a_Extents[index].Address = address;
+      a_Extents[index].Length  = length;
+      previous_end             = address + length;
+    }
+  }
+
+  /* Erase request of one page: number of pages then page number */
+  a_erase_request[0] = 1U;
+
+  /* Up to a whole bank can be erased, the host is kept informed that the command is running */
+  OPENBL_Enable_BusyState_Sending();
+
+  /* The extents are sorted, a page shared by two of them is met twice in a row */
+  for (index = 0U; (index < ExtentsNumber) && (status == SUCCESS); index++)
+  {
+    page     = (a_Extents[index].Address - FLASH_START_ADDRESS) / FLASH_PAGE_SIZE;
+    end_page = (a_Extents[index].Address + a_Extents[index].Length - 1U - FLASH_START_ADDRESS) / FLASH_PAGE_SIZE;
+
+    while ((page <= end_page) && (status == SUCCESS))
+    {
+      if (page != last_page)
+      {
+        a_erase_request[1] = (uint16_t)page;
+
+        status = OPENBL_MEM_Erase(OPENBL_DEFAULT_MEM, (uint8_t *)a_erase_request, sizeof(a_erase_request));
+
+        if (status == SUCCESS)
+        {
+          erased_pages++;
+        }
+      }
+
+      last_page = page;
+      page++;
+    }
+  }
+
+  OPENBL_Disable_BusyState_Sending();
+
+  if (status != SUCCESS)
+  {
+    /* No data is accepted until a valid extent table is received */
+    ExtentsNumber = 0U;
+  }
+
+  pReport[0] = (status == SUCCESS) ? ACK_BYTE : NACK_BYTE;
+  pReport[1] = (uint8_t)(erased_pages >> 8);
+  pReport[2] = (uint8_t)(erased_pages & 0xFFU);
+
+  return COMMON_EXTENTS_REPORT_SIZE;
+}
+
+/**
+  * @brief  Write the next data of the sparse upload session.
+  * @note   The data follow the order of the extents and a buffer can span several of them.
+  *         The write cache is flushed once the last extent is complete. A programming
+  *         failure is reported by a NACK and closes the session.
+  * @param  pReport Pointer to the report: ACK or NACK byte then number of bytes still
+  *         expected, 32-bit MSB first.
+  * @param  p_Data Pointer to the data.
+  * @param  DataLength Size of the data.
+  * @retval Returns the size of the report.
+  */
+uint32_t Common_WriteExtentData(uint8_t *pReport, uint8_t *p_Data, uint32_t DataLength)
+{
+  uint32_t index;
+  uint32_t length;
+  uint32_t remaining = 0U;
+  ErrorStatus status = SUCCESS;
+
+  for (index = ExtentIndex; index < ExtentsNumber; index++)
+  {
+    remaining += a_Extents[index].Length;
+  }
+
+  remaining -= ExtentOffset;
+
+  /* Data beyond the end of the extents are rejected, nothing is written */
+  if ((DataLength == 0U) || (DataLength > remaining))
+  {
+    status = ERROR;
+  }
+  else
+  {
+    remaining -= DataLength;
+
+    while ((DataLength > 0U) && (status == SUCCESS))
+    {
+      length = a_Extents[ExtentIndex].Length - ExtentOffset;
+
+      if (length > DataLength)
+      {
+        length = DataLength;
+      }
+
+      status = OPENBL_MEM_Write(a_Extents[ExtentIndex].Address + ExtentOffset, p_Data, length);
+
+      p_Data       += length;
+      DataLength   -= length;
+      ExtentOffset += length;
+
+      if (ExtentOffset == a_Extents[ExtentIndex].Length)
+      {
+        ExtentIndex++;
+        ExtentOffset = 0U;
+      }
+    }
+
+    /* End of the session, program the pages left in the write cache */
+    if ((remaining == 0U) && (status == SUCCESS))
+    {
+      status = OPENBL_MEM_Flush();
+
+      ExtentsNumber = 0U;
+      ExtentIndex   = 0U;
+    }
+
+    if (status != SUCCESS)
+    {
+      /* The pages of the session can no longer be trusted, a new extent table is needed */
+      ExtentsNumber = 0U;
+      ExtentIndex   = 0U;
+      ExtentOffset  = 0U;
+    }
+  }
+
+  pReport[0] = (status == SUCCESS) ? ACK_BYTE : NACK_BYTE;
+  pReport[1] = (uint8_t)(remaining >> 24);
+  pReport[2] = (uint8_t)(remaining >> 16);
+  pReport[3] = (uint8_t)(remaining >> 8);
+  pReport[4] = (uint8_t)(remaining & 0xFFU);
+
+  return COMMON_EXTENT_DATA_REPORT_SIZE;
+}
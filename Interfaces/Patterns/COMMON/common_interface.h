@@ -28,15 +28,104 @@ extern "C" {
 /* Exported types ------------------------------------------------------------*/
 typedef void (*Function_Pointer)(void);
 
+/* Clock state left to the application by the fast hand-off, in the TAMP backup registers
+   starting at OPENBL_HANDOFF_BKP_INDEX */
+typedef struct
+{
+  uint32_t Magic;               /*!< COMMON_HANDOFF_MAGIC if the clocks were left configured, else 0 */
+  uint32_t SysClockFreq;        /*!< System clock frequency in Hz */
+  uint32_t Cfgr1;               /*!< RCC CFGR1: system clock source */
+  uint32_t Cfgr2;               /*!< RCC CFGR2: AHB and APB prescalers */
+  uint32_t Pll1Cfgr;            /*!< RCC PLL1CFGR: PLL1 source, input range and dividers enable */
+  uint32_t Pll1Divr;            /*!< RCC PLL1DIVR: PLL1 multiplier and dividers */
+  uint32_t FlashAcr;            /*!< FLASH ACR: latency and prefetch */
+} OPENBL_HandOffTypeDef;
+
+/* Image metadata record, in the FLASH page reserved at OPENBL_METADATA_ADDRESS */
+typedef struct
+{
+  uint32_t Magic;               /*!< COMMON_METADATA_MAGIC if the record is valid */
+  uint32_t Version;             /*!< Version of the image */
+  uint32_t BuildHash;           /*!< Build identifier of the image */
+  uint32_t Length;              /*!< Length in bytes of the image */
+  uint32_t Crc;                 /*!< CRC32 of the image, as computed by OPENBL_FLASH_ComputeDigest */
+  uint32_t Reserved[3];         /*!< Pads the record to two quad-words */
+} OPENBL_ImageMetadataTypeDef;
+
 /* Exported constants --------------------------------------------------------*/
+#define COMMON_RAM_USAGE_ENTRY_SIZE    8U   /* Size and used bytes of one RAM area */
+#define COMMON_RAM_USAGE_MAX_SIZE      (4U * COMMON_RAM_USAGE_ENTRY_SIZE)  /* Stack and up to three buffers */
+#define COMMON_ERASE_REPORT_SIZE       3U   /* Remaining pages then erase status */
+#define COMMON_BUSY_FRAME_SIZE         7U   /* Busy byte, progress done, progress total, remaining time */
+#define COMMON_BUSY_POLL_BYTE          BUSY_BYTE  /* Byte sent by a byte oriented host to poll the busy state */
+#define COMMON_BROADCAST_STATUS_SIZE   5U   /* Broadcast status then number of broadcast ACKs */
+#define COMMON_FLASH_TIMING_SIZE       12U  /* Page erase, bank erase and quad-word program durations */
+#define COMMON_HANDSHAKE_SELECTION_SIZE 4U  /* Frame size, integrity modes then window depth */
+#define COMMON_HANDSHAKE_HEADER_SIZE   12U  /* Version, device ID, capabilities then selected session */
+#define COMMON_FRAME_SIZE_MAX          256U /* Maximum number of data bytes of a read or write frame */
+#define COMMON_FRAME_SIZE_MIN          16U  /* Smallest frame size recommended on a noisy link */
+#define COMMON_LINK_GROW_FRAMES        16U  /* Consecutive valid frames before the recommended frame size doubles */
+#define COMMON_LINK_STATUS_SIZE        14U  /* Frames, integrity failures, retries then recommended frame size */
+#define COMMON_HANDOFF_MAGIC           0x48414E44U  /* "HAND", the hand-off block holds the clock state */
+#define COMMON_METADATA_MAGIC          0x4D455441U  /* "META", the metadata record is valid */
+#define COMMON_METADATA_SIZE           16U  /* Version, build hash, length and CRC32 of an image */
+#define COMMON_METADATA_SET_SIZE       1U   /* Store status */
+#define COMMON_METADATA_CHECK_SIZE     17U  /* Match status then stored metadata */
+#define COMMON_METADATA_CONFIRM_CRC    0x01U  /* Check option: confirm a match with the CRC32 of the image */
+#define COMMON_EXTENT_ENTRY_SIZE       8U   /* Address then length of an extent */
+#define COMMON_EXTENTS_MAX             16U  /* Extents of a table, as many as a special command buffer holds */
+#define COMMON_EXTENTS_REPORT_SIZE     3U   /* Status then number of erased pages */
+#define COMMON_EXTENT_DATA_REPORT_SIZE 5U   /* Status then number of bytes still expected */
+#define COMMON_WINDOW_DEPTH_MAX        1U   /* Frames that can be sent before waiting for their ACK */
+#define COMMON_INTEGRITY_XOR           0x01U  /* XOR checksum of the frames, the only integrity mode */
+
 /* Exported macro ------------------------------------------------------------*/
+/* Placement of the hot paths (per-byte transport loops, checksum kernels and memory copies).
+   They are executed from RAM at zero wait-state, the section can be redirected to an ITCM
+   output section by defining OPENBL_HOT_PATH_SECTION in the project settings */
+#ifndef OPENBL_HOT_PATH_SECTION
+#define OPENBL_HOT_PATH_SECTION        ".ramfunc"
+#endif /* OPENBL_HOT_PATH_SECTION */
+
+#if defined (__ICCARM__)
+#define OPENBL_HOT_PATH                __ramfunc
+#else
+#define OPENBL_HOT_PATH                __attribute__((section(OPENBL_HOT_PATH_SECTION)))
+#endif /* (__ICCARM__) */
+
 /* Exported functions ------------------------------------------------------- */
 void Common_SetMsp(uint32_t TopOfMainStack);
 void Common_EnableIrq(void);
 void Common_DisableIrq(void);
 FlagStatus Common_GetProtectionStatus(void);
+FlagStatus Common_GetWriteProtectionStatus(uint32_t Address, uint32_t Length);
 void Common_SetPostProcessingCallback(Function_Pointer Callback);
 void Common_StartPostProcessing(void);
+void Common_EnableCycleCounter(void);
+uint32_t Common_GetCycleCounter(void);
+void Common_PaintStack(void);
+void Common_PaintBuffer(uint8_t *pBuffer, uint32_t Size);
+uint32_t Common_GetStackUsage(void);
+uint32_t Common_GetBufferUsage(uint8_t *pBuffer, uint32_t Size);
+uint32_t Common_SetRamUsageEntry(uint8_t *pReport, uint32_t Size, uint32_t Used);
+uint32_t Common_SuspendableErase(uint8_t *pReport, uint8_t *p_Data, uint32_t DataLength);
+void OPENBL_Enable_BusyState_Sending(void);
+void OPENBL_Disable_BusyState_Sending(void);
+OPENBL_HOT_PATH uint32_t Common_SetBusyFrame(uint8_t *pFrame);
+OPENBL_HOT_PATH void Common_RecordBroadcastByte(uint8_t Byte);
+uint32_t Common_GetBroadcastStatus(uint8_t *pReport);
+uint32_t Common_GetFlashTiming(uint8_t *pReport);
+void Common_SelectSession(const uint8_t *pSelection);
+uint32_t Common_SetHandshakeHeader(uint8_t *pReport, uint8_t Version, uint8_t SpeedOptions);
+uint32_t Common_GetFrameSize(void);
+uint8_t Common_CheckFrameSize(uint32_t Length);
+void Common_RecordLinkFrame(uint8_t Status);
+uint32_t Common_GetLinkStatus(uint8_t *pReport);
+void Common_FastHandOff(void);
+uint32_t Common_SetImageMetadata(uint8_t *pReport, uint8_t *p_Data, uint32_t DataLength);
+uint32_t Common_CheckImageMetadata(uint8_t *pReport, uint8_t *p_Data, uint32_t DataLength);
+uint32_t Common_StartExtents(uint8_t *pReport, uint8_t *p_Data, uint32_t DataLength);
+uint32_t Common_WriteExtentData(uint8_t *pReport, uint8_t *p_Data, uint32_t DataLength);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,564 @@
+/**
+  ******************************************************************************
+  * @file    extnor_interface.c
+  * @author  MCD Application Team
+  * @brief   Contains external serial NOR access functions through OCTOSPI
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "platform.h"
+#include "interfaces_conf.h"
+#include "openbl_mem.h"
+#include "iwdg_interface.h"
+#include "extnor_interface.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define EXTNOR_TIMEOUT                    HAL_OSPI_TIMEOUT_DEFAULT_VALUE  /* Commands, transfers, program and erase in ms */
+#define EXTNOR_CHIP_ERASE_TIMEOUT         600000U  /* Chip erase in ms, minutes for the largest NOR */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static OSPI_HandleTypeDef hospi;
+static DMA_HandleTypeDef hdma_ospi;
+
+/* Private function prototypes -----------------------------------------------*/
+static HAL_StatusTypeDef OPENBL_EXTNOR_SendCommand(uint32_t Instruction, uint32_t Address, uint32_t DataMode,
+                                                   uint32_t NbData);
+static HAL_StatusTypeDef OPENBL_EXTNOR_WriteEnable(void);
+static HAL_StatusTypeDef OPENBL_EXTNOR_WaitReady(uint32_t Timeout);
+static HAL_StatusTypeDef OPENBL_EXTNOR_WaitTransfer(uint32_t Timeout);
+static HAL_StatusTypeDef OPENBL_EXTNOR_EnableMemoryMapped(void);
+
+/* Exported variables --------------------------------------------------------*/
+OPENBL_MemoryTypeDef EXTNOR_Descriptor =
+{
+  EXTNOR_START_ADDRESS,
+  EXTNOR_END_ADDRESS,
+  EXTNOR_BL_SIZE,
+  EXTNOR_AREA,
+  OPENBL_EXTNOR_Read,
+  OPENBL_EXTNOR_Write,
+  NULL,
+  NULL,
+  NULL,
+  OPENBL_EXTNOR_MassErase,
+  OPENBL_EXTNOR_Erase
+};
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  This function is used to configure the OCTOSPI pins, its DMA and the external NOR.
+  * @note   The NOR is left in memory-mapped mode, so that reads are plain memory accesses.
+  * @retval None.
+  */
+void OPENBL_EXTNOR_Configuration(void)
+{
+  GPIO_InitTypeDef GPIO_InitStruct;
+  OSPIM_CfgTypeDef ospim_config;
+
+  /* Enable all resources clocks --------------------------------------------*/
+  OSPIx_GPIO_CLK_ENABLE();
+  OSPIx_CLK_ENABLE();
+  OSPIx_DMA_CLK_ENABLE();
+
+  GPIO_InitStruct.Mode      = GPIO_MODE_AF_PP;
+  GPIO_InitStruct.Pull      = GPIO_NOPULL;
+  GPIO_InitStruct.Speed     = GPIO_SPEED_FREQ_VERY_HIGH;
+  GPIO_InitStruct.Alternate = OSPIx_ALTERNATE;
+
+  GPIO_InitStruct.Pin = OSPIx_CLK_PIN;
+  HAL_GPIO_Init(OSPIx_CLK_GPIO_PORT, &GPIO_InitStruct);
+
+  GPIO_InitStruct.Pin = OSPIx_NCS_PIN;
+  HAL_GPIO_Init(OSPIx_NCS_GPIO_PORT, &GPIO_InitStruct);
+
+  GPIO_InitStruct.Pin = OSPIx_IO0_PIN;
+  HAL_GPIO_Init(OSPIx_IO0_GPIO_PORT, &GPIO_InitStruct);
+
+  GPIO_InitStruct.Pin = OSPIx_IO1_PIN;
+  HAL_GPIO_Init(OSPIx_IO1_GPIO_PORT, &GPIO_InitStruct);
+
+  GPIO_InitStruct.Pin = OSPIx_IO2_PIN;
+  HAL_GPIO_Init(OSPIx_IO2_GPIO_PORT, &GPIO_InitStruct);
+
+  GPIO_InitStruct.Pin = OSPIx_IO3_PIN;
+  HAL_GPIO_Init(OSPIx_IO3_GPIO_PORT, &GPIO_InitStruct);
+
+  /* Page programming data are moved by DMA from RAM to the OCTOSPI FIFO */
+  hdma_ospi.Instance                   = OSPIx_DMA_CHANNEL;
+  hdma_ospi.Init.Request               = OSPIx_DMA_REQUEST;
+  hdma_ospi.Init.BlkHWRequest          = DMA_BREQ_SINGLE_BURST;
+  hdma_ospi.Init.Direction             = DMA_MEMORY_TO_PERIPH;
+  hdma_ospi.Init.SrcInc                = DMA_SINC_INCREMENTED;
+  hdma_ospi.Init.DestInc               = DMA_DINC_FIXED;
+  hdma_ospi.Init.SrcDataWidth          = DMA_SRC_DATAWIDTH_BYTE;
+  hdma_ospi.Init.DestDataWidth         = DMA_DEST_DATAWIDTH_BYTE;
+  hdma_ospi.Init.Priority              = DMA_LOW_PRIORITY_HIGH_WEIGHT;
+  hdma_ospi.Init.SrcBurstLength        = 1U;
+  hdma_ospi.Init.DestBurstLength       = 1U;
+  hdma_ospi.Init.TransferAllocatedPort = (DMA_SRC_ALLOCATED_PORT0 | DMA_DEST_ALLOCATED_PORT0);
+  hdma_ospi.Init.TransferEventMode     = DMA_TCEM_BLOCK_TRANSFER;
+  hdma_ospi.Init.Mode                  = DMA_NORMAL;
+  HAL_DMA_Init(&hdma_ospi);
+
+  __HAL_LINKDMA(&hospi, hdma, hdma_ospi);
+
+  hospi.Instance                     = OSPIx;
+  hospi.Init.FifoThreshold           = 4U;
+  hospi.Init.DualQuad                = HAL_OSPI_DUALQUAD_DISABLE;
+  hospi.Init.MemoryType              = HAL_OSPI_MEMTYPE_MICRON;
+  hospi.Init.DeviceSize              = POSITION_VAL(EXTNOR_BL_SIZE);
+  hospi.Init.ChipSelectHighTime      = 2U;
+  hospi.Init.FreeRunningClock        = HAL_OSPI_FREERUNCLK_DISABLE;
+  hospi.Init.ClockMode               = HAL_OSPI_CLOCK_MODE_0;
+  hospi.Init.WrapSize                = HAL_OSPI_WRAP_NOT_SUPPORTED;
+  hospi.Init.ClockPrescaler          = 2U;
+  hospi.Init.SampleShifting          = HAL_OSPI_SAMPLE_SHIFTING_HALFCYCLE;
+  hospi.Init.DelayHoldQuarterCycle   = HAL_OSPI_DHQC_DISABLE;
+  hospi.Init.ChipSelectBoundary      = 0U;
+  hospi.Init.DelayBlockBypass        = HAL_OSPI_DELAY_BLOCK_BYPASSED;
+  hospi.Init.MaxTran                 = 0U;
+  hospi.Init.Refresh                 = 0U;
+
+  if (HAL_OSPI_Init(&hospi) != HAL_OK)
+  {
+    while (1);
+  }
+
+  ospim_config.ClkPort     = 1U;
+  ospim_config.NCSPort     = 1U;
+  ospim_config.IOLowPort   = HAL_OSPIM_IOPORT_1_LOW;
+  ospim_config.IOHighPort  = HAL_OSPIM_IOPORT_NONE;
+  ospim_config.Req2AckTime = 1U;
+  HAL_OSPIM_Config(&hospi, &ospim_config, EXTNOR_TIMEOUT);
+
+  HAL_NVIC_SetPriority(OSPIx_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(OSPIx_IRQn);
+  HAL_NVIC_SetPriority(OSPIx_DMA_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(OSPIx_DMA_IRQn);
+
+  OPENBL_EXTNOR_EnableMemoryMapped();
+}
+
+/**
+  * @brief  This function is used to read data from a given address.
+  * @param  Address The address to be read.
+  * @retval Returns the read value.
+  */
+uint8_t OPENBL_EXTNOR_Read(uint32_t Address)
+{
+  return (*(__IO uint8_t *)(Address));
+}
+
+/**
+  * @brief  This function is used to write data in the external NOR.
+  * @note   The data are split on the NOR page boundaries and each page is programmed
+  *         with a single DMA transfer. The programming stops at the first failure.
+  * @param  Address The address where that data will be written.
+  * @param  Data The data to be written.
+  * @param  DataLength The length of the data to be written.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: Write operation done
+  *          - ERROR:   Write operation failed
+  */
+ErrorStatus OPENBL_EXTNOR_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength)
+{
+  uint32_t offset;
+  uint32_t length;
+  HAL_StatusTypeDef status;
+
+  /* Leave the memory-mapped mode to send indirect commands */
+  status = HAL_OSPI_Abort(&hospi);
+  offset = Address - EXTNOR_START_ADDRESS;
+
+  while ((DataLength > 0U) && (status == HAL_OK))
+  {
+    length = EXTNOR_PAGE_SIZE - (offset & (EXTNOR_PAGE_SIZE - 1U));
+
+    if (length > DataLength)
+    {
+      length = DataLength;
+    }
+
+    status = OPENBL_EXTNOR_WriteEnable();
+
+    if (status == HAL_OK)
+    {
+      status = OPENBL_EXTNOR_SendCommand(EXTNOR_CMD_QUAD_PAGE_PROGRAM, offset, HAL_OSPI_DATA_4_LINES, length);
+    }
+
+    if (status == HAL_OK)
+    {
+      status = HAL_OSPI_Transmit_DMA(&hospi, Data);
+    }
+
+    if (status == HAL_OK)
+    {
+      status = OPENBL_EXTNOR_WaitTransfer(EXTNOR_TIMEOUT);
+    }
+
+    if (status == HAL_OK)
+    {
+      status = OPENBL_EXTNOR_WaitReady(EXTNOR_TIMEOUT);
+    }
+
+    offset     += length;
+    Data       += length;
+    DataLength -= length;
+  }
+
+  /* The reads fault while the memory-mapped mode is not restored */
+  if (OPENBL_EXTNOR_EnableMemoryMapped() != HAL_OK)
+  {
+    status = HAL_ERROR;
+  }
+
+  return (status == HAL_OK) ? SUCCESS : ERROR;
+}
+
+/**
+  * @brief  This function is used to erase the whole external NOR.
+  * @param  *p_Data Pointer to the buffer that contains mass erase operation options.
+  * @param  DataLength Size of the Data buffer.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: Mass erase operation done
+  *          - ERROR:   Mass erase operation failed
+  */
+ErrorStatus OPENBL_EXTNOR_MassErase(uint8_t *p_Data, uint32_t DataLength)
+{
+  HAL_StatusTypeDef status;
+
+  status = HAL_OSPI_Abort(&hospi);
+
+  if (status == HAL_OK)
+  {
+    status = OPENBL_EXTNOR_WriteEnable();
+  }
+
+  if (status == HAL_OK)
+  {
+    status = OPENBL_EXTNOR_SendCommand(EXTNOR_CMD_CHIP_ERASE, 0U, HAL_OSPI_DATA_NONE, 0U);
+  }
+
+  if (status == HAL_OK)
+  {
+    status = OPENBL_EXTNOR_WaitReady(EXTNOR_CHIP_ERASE_TIMEOUT);
+  }
+
+  if (OPENBL_EXTNOR_EnableMemoryMapped() != HAL_OK)
+  {
+    status = HAL_ERROR;
+  }
+
+  return (status == HAL_OK) ? SUCCESS : ERROR;
+}
+
+/**
+  * @brief  This function is used to erase sectors of the external NOR.
+  * @note   The payload has the FLASH layout: the number of sectors then the sector numbers, all
+  *         16-bit LSB first. A run of sectors covering a whole aligned 64 KByte block is erased
+  *         with a single block erase, the other sectors with 4 KByte sector erases.
+  * @param  *p_Data Pointer to the buffer that contains the sectors to be erased.
+  * @param  DataLength Size of the Data buffer.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: Erase operation done
+  *          - ERROR:   Erase operation failed or a sector is not valid
+  */
+ErrorStatus OPENBL_EXTNOR_Erase(uint8_t *p_Data, uint32_t DataLength)
+{
+  uint32_t counter;
+  uint32_t index;
+  uint32_t sectors_number;
+  uint32_t sector;
+  uint32_t run;
+  uint32_t instruction;
+  HAL_StatusTypeDef status = HAL_ERROR;
+
+  if (DataLength >= 2U)
+  {
+    sectors_number = (uint32_t)p_Data[0] | ((uint32_t)p_Data[1] << 8);
+    p_Data        += 2U;
+
+    if (sectors_number > ((DataLength - 2U) / 2U))
+    {
+      sectors_number = (DataLength - 2U) / 2U;
+    }
+
+    status  = HAL_OSPI_Abort(&hospi);
+    counter = 0U;
+
+    while ((counter < sectors_number) && (status == HAL_OK))
+    {
+      sector = (uint32_t)p_Data[2U * counter] | ((uint32_t)p_Data[(2U * counter) + 1U] << 8);
+
+      /* Count the consecutive sectors listed from this one, up to a whole block */
+      run = 1U;
+
+      for (index = counter + 1U; (index < sectors_number) && (run < (EXTNOR_BLOCK_SIZE / EXTNOR_SECTOR_SIZE)); index++)
+      {
+        if (((uint32_t)p_Data[2U * index] | ((uint32_t)p_Data[(2U * index) + 1U] << 8)) != (sector + run))
+        {
+          break;
+        }
+
+        run++;
+      }
+
+      if ((((sector * EXTNOR_SECTOR_SIZE) & (EXTNOR_BLOCK_SIZE - 1U)) == 0U)
+          && (run == (EXTNOR_BLOCK_SIZE / EXTNOR_SECTOR_SIZE)))
+      {
+        instruction = EXTNOR_CMD_BLOCK_ERASE;
+      }
+      else
+      {
+        instruction = EXTNOR_CMD_SECTOR_ERASE;
+        run         = 1U;
+      }
+
+      if (sector >= (EXTNOR_BL_SIZE / EXTNOR_SECTOR_SIZE))
+      {
+        status = HAL_ERROR;
+      }
+      else
+      {
+        status = OPENBL_EXTNOR_WriteEnable();
+      }
+
+      if (status == HAL_OK)
+      {
+        status = OPENBL_EXTNOR_SendCommand(instruction, (sector * EXTNOR_SECTOR_SIZE), HAL_OSPI_DATA_NONE, 0U);
+      }
+
+      if (status == HAL_OK)
+      {
+        status = OPENBL_EXTNOR_WaitReady(EXTNOR_TIMEOUT);
+      }
+
+      counter += run;
+    }
+
+    if (OPENBL_EXTNOR_EnableMemoryMapped() != HAL_OK)
+    {
+      status = HAL_ERROR;
+    }
+  }
+
+  return (status == HAL_OK) ? SUCCESS : ERROR;
+}
+
+/**
+  * @brief  Handle OCTOSPI interrupt request.
+  * @note   This function must be called from the OCTOSPI interrupt handler.
+  * @retval None.
+  */
+void OPENBL_EXTNOR_IRQHandler(void)
+{
+  HAL_OSPI_IRQHandler(&hospi);
+}
+
+/**
+  * @brief  Handle OCTOSPI DMA channel interrupt request.
+  * @note   This function must be called from the interrupt handler of OSPIx_DMA_CHANNEL.
+  * @retval None.
+  */
+void OPENBL_EXTNOR_DMA_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_ospi);
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Send an indirect command to the external NOR.
+  * @param  Instruction The command opcode.
+  * @param  Address The address in the NOR, ignored when the command has no address.
+  * @param  DataMode The data phase mode, HAL_OSPI_DATA_NONE if the command has no data.
+  * @param  NbData The number of data bytes.
+  * @retval HAL_Status
+  */
+static HAL_StatusTypeDef OPENBL_EXTNOR_SendCommand(uint32_t Instruction, uint32_t Address, uint32_t DataMode,
+                                                   uint32_t NbData)
+{
+  OSPI_RegularCmdTypeDef command = {0};
+
+  command.OperationType      = HAL_OSPI_OPTYPE_COMMON_CFG;
+  command.FlashId            = HAL_OSPI_FLASH_ID_1;
+  command.Instruction        = Instruction;
+  command.InstructionMode    = HAL_OSPI_INSTRUCTION_1_LINE;
+  command.InstructionSize    = HAL_OSPI_INSTRUCTION_8_BITS;
+  command.InstructionDtrMode = HAL_OSPI_INSTRUCTION_DTR_DISABLE;
+  command.AddressSize        = HAL_OSPI_ADDRESS_32_BITS;
+  command.AddressDtrMode     = HAL_OSPI_ADDRESS_DTR_DISABLE;
+  command.AlternateBytesMode = HAL_OSPI_ALTERNATE_BYTES_NONE;
+  command.DataMode           = DataMode;
+  command.NbData             = NbData;
+  command.DataDtrMode        = HAL_OSPI_DATA_DTR_DISABLE;
+  command.DummyCycles        = 0U;
+  command.DQSMode            = HAL_OSPI_DQS_DISABLE;
+  command.SIOOMode           = HAL_OSPI_SIOO_INST_EVERY_CMD;
+
+  if ((Instruction == EXTNOR_CMD_WRITE_ENABLE) || (Instruction == EXTNOR_CMD_CHIP_ERASE))
+  {
+    command.AddressMode = HAL_OSPI_ADDRESS_NONE;
+  }
+  else
+  {
+    command.AddressMode = HAL_OSPI_ADDRESS_1_LINE;
+    command.Address     = Address;
+  }
+
+  return HAL_OSPI_Command(&hospi, &command, EXTNOR_TIMEOUT);
+}
+
+/**
+  * @brief  Set the write enable latch of the external NOR.
+  * @retval HAL_Status
+  */
+static HAL_StatusTypeDef OPENBL_EXTNOR_WriteEnable(void)
+{
+  return OPENBL_EXTNOR_SendCommand(EXTNOR_CMD_WRITE_ENABLE, 0U, HAL_OSPI_DATA_NONE, 0U);
+}
+
+/**
+  * @brief  Wait for the end of the external NOR program or erase operation.
+  * @note   The status register is polled by the OCTOSPI auto-polling mode, the CPU only
+  *         waits for its completion interrupt and keeps the watchdog refreshed.
+  * @param  Timeout Maximum duration of the operation in ms.
+  * @retval HAL_Status
+  */
+static HAL_StatusTypeDef OPENBL_EXTNOR_WaitReady(uint32_t Timeout)
+{
+  OSPI_RegularCmdTypeDef command = {0};
+  OSPI_AutoPollingTypeDef polling;
+  HAL_StatusTypeDef status;
+
+  command.OperationType      = HAL_OSPI_OPTYPE_COMMON_CFG;
+  command.FlashId            = HAL_OSPI_FLASH_ID_1;
+  command.Instruction        = EXTNOR_CMD_READ_STATUS;
+  command.InstructionMode    = HAL_OSPI_INSTRUCTION_1_LINE;
+  command.InstructionSize    = HAL_OSPI_INSTRUCTION_8_BITS;
+  command.InstructionDtrMode = HAL_OSPI_INSTRUCTION_DTR_DISABLE;
+  command.AddressMode        = HAL_OSPI_ADDRESS_NONE;
+  command.AlternateBytesMode = HAL_OSPI_ALTERNATE_BYTES_NONE;
+  command.DataMode           = HAL_OSPI_DATA_1_LINE;
+  command.NbData             = 1U;
+  command.DataDtrMode        = HAL_OSPI_DATA_DTR_DISABLE;
+  command.DummyCycles        = 0U;
+  command.DQSMode            = HAL_OSPI_DQS_DISABLE;
+  command.SIOOMode           = HAL_OSPI_SIOO_INST_EVERY_CMD;
+
+  polling.Match         = 0U;
+  polling.Mask          = EXTNOR_STATUS_WIP;
+  polling.MatchMode     = HAL_OSPI_MATCH_MODE_AND;
+  polling.AutomaticStop = HAL_OSPI_AUTOMATIC_STOP_ENABLE;
+  polling.Interval      = 0x10U;
+
+  status = HAL_OSPI_Command(&hospi, &command, EXTNOR_TIMEOUT);
+
+  if (status == HAL_OK)
+  {
+    status = HAL_OSPI_AutoPolling_IT(&hospi, &polling);
+  }
+
+  if (status == HAL_OK)
+  {
+    status = OPENBL_EXTNOR_WaitTransfer(Timeout);
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Wait for the end of the running OCTOSPI transfer or auto-polling.
+  * @note   The transfer is aborted when it does not complete in time, e.g. a stalled DMA or a
+  *         NOR that stays busy, so that the indirect and memory-mapped modes can be used again.
+  * @param  Timeout Maximum duration of the transfer in ms.
+  * @retval HAL_Status
+  */
+static HAL_StatusTypeDef OPENBL_EXTNOR_WaitTransfer(uint32_t Timeout)
+{
+  uint32_t tick_start;
+  HAL_StatusTypeDef status = HAL_OK;
+
+  tick_start = HAL_GetTick();
+
+  while (HAL_OSPI_GetState(&hospi) != HAL_OSPI_STATE_READY)
+  {
+    if ((HAL_GetTick() - tick_start) > Timeout)
+    {
+      HAL_OSPI_Abort(&hospi);
+
+      status = HAL_TIMEOUT;
+      break;
+    }
+
+    OPENBL_IWDG_Refresh();
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Configure the OCTOSPI memory-mapped mode with the quad I/O fast read.
+  * @retval HAL_Status
+  */
+static HAL_StatusTypeDef OPENBL_EXTNOR_EnableMemoryMapped(void)
+{
+  OSPI_RegularCmdTypeDef command = {0};
+  OSPI_MemoryMappedTypeDef memory_mapped;
+  HAL_StatusTypeDef status;
+
+  command.FlashId            = HAL_OSPI_FLASH_ID_1;
+  command.InstructionMode    = HAL_OSPI_INSTRUCTION_1_LINE;
+  command.InstructionSize    = HAL_OSPI_INSTRUCTION_8_BITS;
+  command.InstructionDtrMode = HAL_OSPI_INSTRUCTION_DTR_DISABLE;
+  command.AddressMode        = HAL_OSPI_ADDRESS_4_LINES;
+  command.AddressSize        = HAL_OSPI_ADDRESS_32_BITS;
+  command.AddressDtrMode     = HAL_OSPI_ADDRESS_DTR_DISABLE;
+  command.AlternateBytesMode = HAL_OSPI_ALTERNATE_BYTES_NONE;
+  command.DataMode           = HAL_OSPI_DATA_4_LINES;
+  command.DataDtrMode        = HAL_OSPI_DATA_DTR_DISABLE;
+  command.DQSMode            = HAL_OSPI_DQS_DISABLE;
+  command.SIOOMode           = HAL_OSPI_SIOO_INST_EVERY_CMD;
+
+  /* Read configuration */
+  command.OperationType = HAL_OSPI_OPTYPE_READ_CFG;
+  command.Instruction   = EXTNOR_CMD_QUAD_IO_READ;
+  command.DummyCycles   = EXTNOR_QUAD_IO_READ_DUMMY;
+
+  status = HAL_OSPI_Command(&hospi, &command, EXTNOR_TIMEOUT);
+
+  /* Write configuration, required by the memory-mapped mode but never used */
+  if (status == HAL_OK)
+  {
+    command.OperationType = HAL_OSPI_OPTYPE_WRITE_CFG;
+    command.Instruction   = EXTNOR_CMD_QUAD_PAGE_PROGRAM;
+    command.AddressMode   = HAL_OSPI_ADDRESS_1_LINE;
+    command.DummyCycles   = 0U;
+
+    status = HAL_OSPI_Command(&hospi, &command, EXTNOR_TIMEOUT);
+  }
+
+  if (status == HAL_OK)
+  {
+    memory_mapped.TimeOutActivation = HAL_OSPI_TIMEOUT_COUNTER_DISABLE;
+    memory_mapped.TimeOutPeriod     = 0U;
+
+    status = HAL_OSPI_MemoryMapped(&hospi, &memory_mapped);
+  }
+
+  return status;
+}
@@ -0,0 +1,60 @@
+/**
+  ******************************************************************************
+  * @file    extnor_interface.h
+  * @author  MCD Application Team
+  * @brief   Header for extnor_interface.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef EXTNOR_INTERFACE_H
+#define EXTNOR_INTERFACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+#define EXTNOR_PAGE_SIZE                  256U         /* Page programming size */
+#define EXTNOR_SECTOR_SIZE                0x1000U      /* Smallest erasable sector: 4 KByte */
+#define EXTNOR_BLOCK_SIZE                 0x10000U     /* Largest erasable block: 64 KByte */
+
+/* Serial NOR commands, 4-byte address variants */
+#define EXTNOR_CMD_WRITE_ENABLE           0x06U        /* Write enable */
+#define EXTNOR_CMD_READ_STATUS            0x05U        /* Read status register */
+#define EXTNOR_CMD_QUAD_IO_READ           0xECU        /* 1-4-4 fast read */
+#define EXTNOR_CMD_QUAD_PAGE_PROGRAM      0x34U        /* 1-1-4 page program */
+#define EXTNOR_CMD_SECTOR_ERASE           0x21U        /* 4 KByte sector erase */
+#define EXTNOR_CMD_BLOCK_ERASE            0xDCU        /* 64 KByte block erase */
+#define EXTNOR_CMD_CHIP_ERASE             0xC7U        /* Chip erase */
+
+#define EXTNOR_QUAD_IO_READ_DUMMY         6U           /* Dummy cycles of the fast read */
+#define EXTNOR_STATUS_WIP                 0x01U        /* Write in progress bit of the status register */
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+void OPENBL_EXTNOR_Configuration(void);
+uint8_t OPENBL_EXTNOR_Read(uint32_t Address);
+ErrorStatus OPENBL_EXTNOR_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength);
+ErrorStatus OPENBL_EXTNOR_MassErase(uint8_t *p_Data, uint32_t DataLength);
+ErrorStatus OPENBL_EXTNOR_Erase(uint8_t *p_Data, uint32_t DataLength);
+void OPENBL_EXTNOR_IRQHandler(void);
+void OPENBL_EXTNOR_DMA_IRQHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EXTNOR_INTERFACE_H */
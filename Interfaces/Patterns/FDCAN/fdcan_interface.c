@@ -23,9 +23,14 @@
 #include "openbl_fdcan_cmd.h"
 #include "fdcan_interface.h"
 #include "iwdg_interface.h"
+#include "common_interface.h"
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
+#define FDCAN_ELEMENT_SIZE                72U  /* Rx FIFO and Tx FIFO elements in the message RAM: header and 64 bytes */
+#define FDCAN_ELEMENT_XTD                 0x40000000U  /* Extended identifier bit of the first element word */
+#define FDCAN_ELEMENT_STD_ID              0x1FFC0000U  /* Standard identifier of the first element word */
+#define FDCAN_ELEMENT_STD_ID_POS          18U
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 static FDCAN_HandleTypeDef hfdcan;
@@ -33,6 +38,8 @@ static FDCAN_FilterTypeDef sFilterConfig;
 static FDCAN_TxHeaderTypeDef TxHeader;
 static FDCAN_RxHeaderTypeDef RxHeader;
 static uint8_t FdcanDetected = 0U;
+/* Size in bytes of the data field, indexed by the data length code FDCAN_DLC_BYTES_x */
+static const uint8_t a_FdcanFrameSizes[16] = {0U, 1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U, 12U, 16U, 20U, 24U, 32U, 48U, 64U};
 
 /* Exported variables --------------------------------------------------------*/
 uint8_t TxData[FDCAN_RAM_BUFFER_SIZE];
@@ -40,6 +47,7 @@ uint8_t RxData[FDCAN_RAM_BUFFER_SIZE];
 
 /* Private function prototypes -----------------------------------------------*/
 static void OPENBL_FDCAN_Init(void);
+static void OPENBL_FDCAN_SendSpecialReport(uint8_t *pBuffer, uint32_t Length);
 
 /* Private functions ---------------------------------------------------------*/
 /**
@@ -109,6 +117,47 @@ static void OPENBL_FDCAN_Init(void)
   HAL_FDCAN_Start(&hfdcan);
 }
 
+/**
+ * @brief  This function is used to send the answer of a special command: the data size,
+ *         the data then a NULL status size.
+ * @note   The data frame uses the smallest FDCAN data length that holds the data,
+ *         it is padded with zeros.
+ * @param  pBuffer Pointer to the data of the answer.
+ * @param  Length Size of the data, up to 64 bytes.
+ * @retval None.
+ */
+static void OPENBL_FDCAN_SendSpecialReport(uint8_t *pBuffer, uint32_t Length)
+{
+  uint32_t data_length_code = 0U;
+  uint32_t index;
+
+  /* The data length codes follow the sizes of this table */
+  while ((data_length_code < (sizeof(a_FdcanFrameSizes) - 1U)) && (a_FdcanFrameSizes[data_length_code] < Length))
+  {
+    data_length_code++;
+  }
+
+  /* Send data size */
+  TxData[0] = (uint8_t)(Length >> 8);
+  TxData[1] = (uint8_t)(Length & 0xFFU);
+
+  OPENBL_FDCAN_SendBytes(TxData, FDCAN_DLC_BYTES_2);
+
+  /* Send data, padded up to the data length code */
+  for (index = 0U; index < a_FdcanFrameSizes[data_length_code]; index++)
+  {
+    TxData[index] = (index < Length) ? pBuffer[index] : 0x00U;
+  }
+
+  OPENBL_FDCAN_SendBytes(TxData, data_length_code);
+
+  /* Send NULL status size */
+  TxData[0] = 0x0;
+  TxData[1] = 0x0;
+
+  OPENBL_FDCAN_SendBytes(TxData, FDCAN_DLC_BYTES_2);
+}
+
 /* Exported functions --------------------------------------------------------*/
 
 /**
@@ -122,6 +171,10 @@ void OPENBL_FDCAN_Configuration(void)
   FDCANx_GPIO_CLK_ENABLE();
 
   OPENBL_FDCAN_Init();
+
+  /* Paint the FDCAN buffers to be able to track their high-water marks */
+  Common_PaintBuffer(TxData, FDCAN_RAM_BUFFER_SIZE);
+  Common_PaintBuffer(RxData, FDCAN_RAM_BUFFER_SIZE);
 }
 
 /**
@@ -272,6 +325,59 @@ void OPENBL_FDCAN_SendBytes(uint8_t *Buffer, uint32_t BufferSize)
   (&hfdcan)->Instance->IR &= FDCAN_IR_TFE;
 }
 
+/**
+  * @brief  This function is used to answer the host polling during a flash operation.
+  * @note   The host polls by sending one frame with the identifier of the running command,
+  *         it is answered with the busy frame. Any other frame is left in the FIFO for the
+  *         command. The function runs from RAM while the FLASH is busy, so it accesses the
+  *         message RAM directly instead of calling the HAL.
+  * @retval None.
+  */
+OPENBL_HOT_PATH void OPENBL_FDCAN_SendBusyState(void)
+{
+  uint32_t index;
+  uint32_t get_index;
+  uint32_t put_index;
+  uint32_t length;
+  uint32_t *p_element;
+  uint32_t a_words[2] = {0U, 0U};
+  uint8_t busy_frame[COMMON_BUSY_FRAME_SIZE];
+
+  if ((FDCANx->RXF0S & FDCAN_RXF0S_F0FL) != 0U)
+  {
+    get_index = (FDCANx->RXF0S & FDCAN_RXF0S_F0GI) >> FDCAN_RXF0S_F0GI_Pos;
+    p_element = (uint32_t *)(hfdcan.msgRam.RxFIFO0SA + (get_index * FDCAN_ELEMENT_SIZE));
+
+    /* Peek the identifier, the frame is only acknowledged when it is a poll */
+    if (((p_element[0] & FDCAN_ELEMENT_XTD) == 0U)
+        && (((p_element[0] & FDCAN_ELEMENT_STD_ID) >> FDCAN_ELEMENT_STD_ID_POS) == TxHeader.Identifier))
+    {
+      FDCANx->RXF0A = get_index;
+
+      if ((FDCANx->TXFQS & FDCAN_TXFQS_TFQF) == 0U)
+      {
+        length = Common_SetBusyFrame(busy_frame);
+
+        for (index = 0U; index < length; index++)
+        {
+          a_words[index / 4U] |= (uint32_t)busy_frame[index] << (8U * (index % 4U));
+        }
+
+        put_index = (FDCANx->TXFQS & FDCAN_TXFQS_TFQPI) >> FDCAN_TXFQS_TFQPI_Pos;
+        p_element = (uint32_t *)(hfdcan.msgRam.TxFIFOQSA + (put_index * FDCAN_ELEMENT_SIZE));
+
+        /* Same header as OPENBL_FDCAN_SendBytes, with the busy frame data length */
+        p_element[0] = TxHeader.Identifier << FDCAN_ELEMENT_STD_ID_POS;
+        p_element[1] = (FDCAN_DLC_BYTES_7 << 16U) | TxHeader.FDFormat | TxHeader.BitRateSwitch;
+        p_element[2] = a_words[0];
+        p_element[3] = a_words[1];
+
+        FDCANx->TXBAR = 1UL << put_index;
+      }
+    }
+  }
+}
+
 /**
  * @brief  This function is used to process and execute the special commands.
  *         The user must define the special commands routine here.
@@ -279,12 +385,93 @@ void OPENBL_FDCAN_SendBytes(uint8_t *Buffer, uint32_t BufferSize)
  */
 void OPENBL_FDCAN_SpecialCommandProcess(OPENBL_SpecialCmdTypeDef *Frame)
 {
-  switch (Frame->OpCode)
+  uint8_t a_report[3U * COMMON_RAM_USAGE_ENTRY_SIZE];
+  uint32_t length;
+
+  /* Only the extent data has an extended form, the other extended commands are rejected */
+  if (Frame->CmdType != OPENBL_SPECIAL_CMD)
   {
-    /* Unknown command opcode */
-    default:
-      if (Frame->CmdType == OPENBL_SPECIAL_CMD)
-      {
+    if (Frame->OpCode == SPECIAL_CMD_EXTENT_DATA)
+    {
+      length = Common_WriteExtentData(a_report, Frame->Buffer2, Frame->SizeBuffer2);
+
+      /* Send status size */
+      TxData[0] = (uint8_t)(length >> 8);
+      TxData[1] = (uint8_t)(length & 0xFFU);
+
+      OPENBL_FDCAN_SendBytes(TxData, FDCAN_DLC_BYTES_2);
+
+      /* Send status */
+      OPENBL_FDCAN_SendBytes(a_report, FDCAN_DLC_BYTES_5);
+    }
+    else
+    {
+      /* Send NULL status size */
+      TxData[0] = 0x0;
+      TxData[1] = 0x0;
+
+      OPENBL_FDCAN_SendBytes(TxData, FDCAN_DLC_BYTES_2);
+    }
+  }
+  else
+  {
+    switch (Frame->OpCode)
+    {
+      /* Report the stack, TxData and RxData high-water marks */
+      case SPECIAL_CMD_GET_RAM_USAGE:
+        length  = Common_SetRamUsageEntry(a_report, OPENBL_STACK_SIZE, Common_GetStackUsage());
+        length += Common_SetRamUsageEntry(&a_report[length], FDCAN_RAM_BUFFER_SIZE,
+                                          Common_GetBufferUsage(TxData, FDCAN_RAM_BUFFER_SIZE));
+        length += Common_SetRamUsageEntry(&a_report[length], FDCAN_RAM_BUFFER_SIZE,
+                                          Common_GetBufferUsage(RxData, FDCAN_RAM_BUFFER_SIZE));
+
+        OPENBL_FDCAN_SendSpecialReport(a_report, length);
+        break;
+
+      /* Erase a FLASH bank by slices, the other memories can be read between two requests */
+      case SPECIAL_CMD_SUSPENDABLE_ERASE:
+        length = Common_SuspendableErase(a_report, Frame->Buffer1, Frame->SizeBuffer1);
+
+        OPENBL_FDCAN_SendSpecialReport(a_report, length);
+        break;
+
+      /* Report the measured durations of the flash operations to tune the host timeouts */
+      case SPECIAL_CMD_GET_FLASH_TIMING:
+        length = Common_GetFlashTiming(a_report);
+
+        OPENBL_FDCAN_SendSpecialReport(a_report, length);
+        break;
+
+      /* Report the link error statistics and the recommended frame size */
+      case SPECIAL_CMD_GET_LINK_STATUS:
+        length = Common_GetLinkStatus(a_report);
+
+        OPENBL_FDCAN_SendSpecialReport(a_report, length);
+        break;
+
+      /* Store the metadata of the image programmed during this session */
+      case SPECIAL_CMD_SET_IMAGE_METADATA:
+        length = Common_SetImageMetadata(a_report, Frame->Buffer1, Frame->SizeBuffer1);
+
+        OPENBL_FDCAN_SendSpecialReport(a_report, length);
+        break;
+
+      /* Compare the stored image metadata with the host one to skip a redundant programming */
+      case SPECIAL_CMD_CHECK_IMAGE_METADATA:
+        length = Common_CheckImageMetadata(a_report, Frame->Buffer1, Frame->SizeBuffer1);
+
+        OPENBL_FDCAN_SendSpecialReport(a_report, length);
+        break;
+
+      /* Erase the pages touched by an extent table and open a sparse upload session */
+      case SPECIAL_CMD_START_EXTENTS:
+        length = Common_StartExtents(a_report, Frame->Buffer1, Frame->SizeBuffer1);
+
+        OPENBL_FDCAN_SendSpecialReport(a_report, length);
+        break;
+
+      /* Unknown command opcode, the extent data is only an extended command */
+      default:
         /* Send NULL data size */
         TxData[0] = 0x0;
         TxData[1] = 0x0;
@@ -294,15 +481,7 @@ void OPENBL_FDCAN_SpecialCommandProcess(OPENBL_SpecialCmdTypeDef *Frame)
         TxData[3] = 0x0;
 
         OPENBL_FDCAN_SendBytes(TxData, FDCAN_DLC_BYTES_4);
-      }
-      else if (Frame->CmdType == OPENBL_EXTENDED_SPECIAL_CMD)
-      {
-        /* Send NULL status size */
-        TxData[0] = 0x0;
-        TxData[1] = 0x0;
-
-        OPENBL_FDCAN_SendBytes(TxData, FDCAN_DLC_BYTES_2);
-      }
-      break;
+        break;
+    }
   }
 }
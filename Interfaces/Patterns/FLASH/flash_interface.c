@@ -22,14 +22,40 @@
 #include "app_openbootloader.h"
 #include "common_interface.h"
 #include "flash_interface.h"
-#include "i2c_interface.h"
+#include "openbl_core.h"
 #include "optionbytes_interface.h"
 
 /* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint32_t StartAddress;        /*!< First protected address */
+  uint32_t EndAddress;          /*!< Address following the last protected one, equal to StartAddress if unused */
+} OPENBL_FLASH_WrpAreaTypeDef;
+
 /* Private define ------------------------------------------------------------*/
+#define FLASH_WRP_AREAS_NB             4U  /* Two write protection areas per bank */
+#define FLASH_OPERATION_DONE           0U  /* No operation waiting for its end of operation interrupt */
+#define FLASH_OPERATION_PENDING        1U  /* Operation started, completed by OPENBL_FLASH_IRQHandler */
+#define FLASH_TIMING_FILTER_SHIFT      3U  /* A new measure weighs 1/8 in the running estimates */
+#define FLASH_IMAGE_CRC_POLYNOMIAL     0x04C11DB7U  /* CRC32 polynomial of the image digest */
+#define FLASH_IMAGE_CRC_INIT           0xFFFFFFFFU  /* CRC32 initial value of the image digest */
+
+#if defined (__ARM_FEATURE_CMSE) && (__ARM_FEATURE_CMSE == 3U)
+#define FLASH_OPERATION_IRQn           FLASH_S_IRQn
+#else
+#define FLASH_OPERATION_IRQn           FLASH_IRQn
+#endif /* __ARM_FEATURE_CMSE */
+
+#if (OPENBL_FLASH_USE_IRQ == 1U)
+#define FLASH_OPERATION_IT             (FLASH_NSCR_EOPIE | FLASH_NSCR_ERRIE)  /* Interrupts of the operations */
+#else
+#define FLASH_OPERATION_IT             0U  /* The end of the operations is polled */
+#endif /* (OPENBL_FLASH_USE_IRQ == 1U) */
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 uint32_t Flash_BusyState = FLASH_BUSY_STATE_DISABLED;
+OPENBL_FLASH_ProgressTypeDef FlashProgress = {0U, 0U, 0U};
+OPENBL_FLASH_TimingTypeDef FlashTiming = {FLASH_PAGE_ERASE_TIME, FLASH_BANK_ERASE_TIME, FLASH_QUADWORD_PROGRAM_TIME};
 FLASH_ProcessTypeDef FlashProcess = {.Lock = HAL_UNLOCKED, \
                                      .ErrorCode = HAL_FLASH_ERROR_NONE, \
                                      .ProcedureOnGoing = 0U, \
@@ -38,18 +64,33 @@ FLASH_ProcessTypeDef FlashProcess = {.Lock = HAL_UNLOCKED, \
                                      .Page = 0U, \
                                      .NbPagesToErase = 0U
                                     };
+static OPENBL_FLASH_WrpAreaTypeDef a_FlashWrpMap[FLASH_WRP_AREAS_NB];
+static uint32_t FlashWrpMapValid = 0U;
+static __IO uint32_t FlashOperationState = FLASH_OPERATION_DONE;
+static __IO uint32_t FlashOperationErrors = 0U;
+static uint32_t FlashHostCycles = 0U;
 
 /* Private function prototypes -----------------------------------------------*/
-static void OPENBL_FLASH_ProgramQuadWord(uint32_t Address, uint32_t Data);
+static void OPENBL_FLASH_SetProgress(uint32_t Done, uint32_t Total, uint32_t OperationTime);
+static uint32_t OPENBL_FLASH_StartTiming(void);
+static void OPENBL_FLASH_UpdateTiming(uint32_t *pEstimate, uint32_t StartCycles, uint32_t Operations);
 static ErrorStatus OPENBL_FLASH_EnableWriteProtection(uint8_t *ListOfPages, uint32_t Length);
 static ErrorStatus OPENBL_FLASH_DisableWriteProtection(void);
+static void OPENBL_FLASH_LoadWriteProtectionMap(void);
+static OPENBL_FLASH_ImageCacheTypeDef *OPENBL_FLASH_GetImageCache(void);
+static void OPENBL_FLASH_InvalidateImageCache(void);
 #if defined (__ICCARM__)
-__ramfunc static HAL_StatusTypeDef OPENBL_FLASH_SendBusyState(uint32_t Timeout);
+__ramfunc static void OPENBL_FLASH_StartOperation(void);
+__ramfunc static HAL_StatusTypeDef OPENBL_FLASH_WaitForCompletion(uint32_t Timeout);
 __ramfunc static HAL_StatusTypeDef OPENBL_FLASH_WaitForLastOperation(uint32_t Timeout);
+__ramfunc static HAL_StatusTypeDef OPENBL_FLASH_ProgramQuadWord(uint32_t Address, uint32_t Data);
 __ramfunc static HAL_StatusTypeDef OPENBL_FLASH_ExtendedErase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *pPageError);
 #else
-__attribute__((section(".ramfunc"))) static HAL_StatusTypeDef OPENBL_FLASH_SendBusyState(uint32_t Timeout);
+__attribute__((section(".ramfunc"))) static void OPENBL_FLASH_StartOperation(void);
+__attribute__((section(".ramfunc"))) static HAL_StatusTypeDef OPENBL_FLASH_WaitForCompletion(uint32_t Timeout);
 __attribute__((section(".ramfunc"))) static HAL_StatusTypeDef OPENBL_FLASH_WaitForLastOperation(uint32_t Timeout);
+__attribute__((section(".ramfunc"))) static HAL_StatusTypeDef OPENBL_FLASH_ProgramQuadWord(uint32_t Address,
+                                                                                        uint32_t Data);
 __attribute__((section(".ramfunc"))) static HAL_StatusTypeDef OPENBL_FLASH_ExtendedErase(
   FLASH_EraseInitTypeDef *pEraseInit, uint32_t *pPageError);
 #endif /* (__ICCARM__) */
@@ -113,53 +154,97 @@ uint8_t OPENBL_FLASH_Read(uint32_t Address)
 
 /**
   * @brief  This function is used to write data in FLASH memory.
+  * @note   The address and the length do not need to be quad-word aligned: the head and
+  *         tail fragments are merged with the current content of their quad-word. Each
+  *         quad-word is staged in a word aligned buffer, the data buffer may have any alignment.
+  *         The programming stops at the first quad-word that fails.
   * @param  Address The address where that data will be written.
   * @param  Data The data to be written.
   * @param  DataLength The length of the data to be written.
-  * @retval None.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: Write operation done
+  *          - ERROR:   Write operation failed
   */
-void OPENBL_FLASH_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength)
+ErrorStatus OPENBL_FLASH_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength)
 {
   uint32_t index;
-  uint32_t length = DataLength;
-  uint32_t remainder;
-  uint8_t remainder_data[16] = {0x0};
+  uint32_t offset;
+  uint32_t length;
+  uint32_t quad_word_address;
+  uint32_t quad_words;
+  uint32_t start_cycles;
+  uint32_t counter = 0U;
+  uint32_t quad_word_data[4] = {0x0};
+  uint8_t *p_quad_word = (uint8_t *)quad_word_data;
+  ErrorStatus status = SUCCESS;
+
+  offset            = Address & 0xFU;
+  quad_word_address = Address - offset;
+  quad_words        = (offset + DataLength + 15U) / 16U;
+
+  OPENBL_FLASH_InvalidateImageCache();
+
+  /* Unlock the flash memory for write operation */
+  OPENBL_FLASH_Unlock();
 
-  /* Check the remaining of quad-word */
-  remainder = length & 0xFU;
+  /* The cycle counter times the operations to refine the estimates reported to the host */
+  Common_EnableCycleCounter();
 
-  if (remainder)
+  while (DataLength > 0U)
   {
-    length = (length & 0xFFFFFFF0U);
+    length = 16U - offset;
 
-    /* copy the remaining bytes */
-    for (index = 0U; index < remainder; index++)
+    if (length > DataLength)
     {
-      remainder_data[index] = *(Data + length + index);
+      length = DataLength;
     }
 
-    /* fill the upper bytes with 0xFF */
-    for (index = remainder; index < 16U; index++)
+    OPENBL_FLASH_SetProgress(counter, quad_words, FlashTiming.QuadWordProgramTime);
+
+    /* Answer the host polling between two quad-words */
+    if (Flash_BusyState == FLASH_BUSY_STATE_ENABLED)
     {
-      remainder_data[index] = 0xFF;
+      OPENBL_SendBusyState();
     }
-  }
 
-  /* Unlock the flash memory for write operation */
-  OPENBL_FLASH_Unlock();
+    if (length != 16U)
+    {
+      /* Merge the partial quad-word with its current content, erased bytes stay 0xFF */
+      for (index = 0U; index < 16U; index++)
+      {
+        p_quad_word[index] = *(__IO uint8_t *)(quad_word_address + index);
+      }
+    }
 
-  for (index = 0U; index < length; (index += 16U))
-  {
-    OPENBL_FLASH_ProgramQuadWord((Address + index), (uint32_t)((Data + index)));
-  }
+    for (index = 0U; index < length; index++)
+    {
+      p_quad_word[offset + index] = *(Data + index);
+    }
 
-  if (remainder)
-  {
-    OPENBL_FLASH_ProgramQuadWord((Address + length), (uint32_t)((remainder_data)));
+    start_cycles = OPENBL_FLASH_StartTiming();
+
+    if (OPENBL_FLASH_ProgramQuadWord(quad_word_address, (uint32_t)quad_word_data) != HAL_OK)
+    {
+      /* Stop at the first failure */
+      status = ERROR;
+      break;
+    }
+
+    OPENBL_FLASH_UpdateTiming(&FlashTiming.QuadWordProgramTime, start_cycles, 1U);
+
+    quad_word_address += 16U;
+    Data              += length;
+    DataLength        -= length;
+    offset             = 0U;
+    counter++;
   }
 
+  OPENBL_FLASH_SetProgress(quad_words, quad_words, FlashTiming.QuadWordProgramTime);
+
   /* Lock the Flash to disable the flash control register access */
   OPENBL_FLASH_Lock();
+
+  return status;
 }
 
 /**
@@ -171,18 +256,105 @@ void OPENBL_FLASH_JumpToAddress(uint32_t Address)
 {
   Function_Pointer jump_to_address;
 
-  /* De-initialize all HW resources used by the Open Bootloader to their reset values */
-  OPENBL_DeInit();
+  /* A corrupted application image is not started, the Open Bootloader keeps running */
+  if ((OPENBL_VERIFIED_BOOT == 0U) || (Address != OPENBL_IMAGE_START_ADDRESS)
+      || (OPENBL_FLASH_VerifyImage() == SUCCESS))
+  {
+    /* De-initialize all HW resources used by the Open Bootloader to their reset values */
+    if (OPENBL_FAST_HANDOFF != 0U)
+    {
+      Common_FastHandOff();
+    }
+    else
+    {
+      OPENBL_DeInit();
+    }
+
+    /* Enable IRQ */
+    Common_EnableIrq();
 
-  /* Enable IRQ */
-  Common_EnableIrq();
+    jump_to_address = (Function_Pointer)(*(__IO uint32_t *)(Address + 4U));
 
-  jump_to_address = (Function_Pointer)(*(__IO uint32_t *)(Address + 4U));
+    /* Initialize user application's stack pointer */
+    Common_SetMsp(*(__IO uint32_t *) Address);
+
+    jump_to_address();
+  }
+}
+
+/**
+  * @brief  Verify the application image against the digest of its footer.
+  * @note   A full verification is skipped when the image digest cache, kept in the
+  *         backup registers, matches the footer and no flash modification happened
+  *         since the last full verification.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: The image is valid
+  *          - ERROR:   No image or the image is corrupted
+  */
+ErrorStatus OPENBL_FLASH_VerifyImage(void)
+{
+  OPENBL_FLASH_ImageFooterTypeDef *p_footer;
+  OPENBL_FLASH_ImageCacheTypeDef *p_cache;
+  ErrorStatus status = ERROR;
+
+  p_footer = (OPENBL_FLASH_ImageFooterTypeDef *)(OPENBL_IMAGE_START_ADDRESS + OPENBL_IMAGE_SLOT_SIZE
+                                                  - sizeof(OPENBL_FLASH_ImageFooterTypeDef));
+  p_cache  = OPENBL_FLASH_GetImageCache();
+
+  if ((p_footer->Magic == FLASH_IMAGE_FOOTER_MAGIC) && ((p_footer->Length & 0x3U) == 0U)
+      && (p_footer->Length <= (OPENBL_IMAGE_SLOT_SIZE - sizeof(OPENBL_FLASH_ImageFooterTypeDef))))
+  {
+    if ((p_cache->Magic == FLASH_IMAGE_CACHE_MAGIC) && (p_cache->VerifiedGeneration == p_cache->Generation)
+        && (p_cache->Length == p_footer->Length) && (p_cache->Digest == p_footer->Digest))
+    {
+      /* Nothing was programmed since this image was fully verified */
+      status = SUCCESS;
+    }
+    else if (OPENBL_FLASH_ComputeDigest(OPENBL_IMAGE_START_ADDRESS, p_footer->Length) == p_footer->Digest)
+    {
+      p_cache->VerifiedGeneration = p_cache->Generation;
+      p_cache->Length             = p_footer->Length;
+      p_cache->Digest             = p_footer->Digest;
+      p_cache->Magic              = FLASH_IMAGE_CACHE_MAGIC;
 
-  /* Initialize user application's stack pointer */
-  Common_SetMsp(*(__IO uint32_t *) Address);
+      status = SUCCESS;
+    }
+    else
+    {
+      p_cache->Magic = 0U;
+    }
+  }
 
-  jump_to_address();
+  return status;
+}
+
+/**
+  * @brief  Compute the CRC32 of a word aligned area with the CRC peripheral.
+  * @note   CRC-32/MPEG-2 parameters: polynomial 0x04C11DB7, initial value 0xFFFFFFFF, no input
+  *         nor output reflection and no final XOR. The area is read as little-endian 32-bit
+  *         words fed MSB first, i.e. CRC-32/MPEG-2 of the area with the bytes of each word
+  *         swapped. Example: the bytes 0x78 0x56 0x34 0x12 give 0xDF8A8A2B.
+  * @param  Address The start address of the area.
+  * @param  Length The length of the area, multiple of 4.
+  * @retval Returns the CRC32 of the area.
+  */
+uint32_t OPENBL_FLASH_ComputeDigest(uint32_t Address, uint32_t Length)
+{
+  uint32_t index;
+
+  __HAL_RCC_CRC_CLK_ENABLE();
+
+  /* 32-bit polynomial, no input nor output reversal */
+  CRC->POL  = FLASH_IMAGE_CRC_POLYNOMIAL;
+  CRC->INIT = FLASH_IMAGE_CRC_INIT;
+  CRC->CR   = CRC_CR_RESET;
+
+  for (index = 0U; index < Length; index += 4U)
+  {
+    CRC->DR = *(__IO uint32_t *)(Address + index);
+  }
+
+  return CRC->DR;
 }
 
 /**
@@ -202,6 +374,36 @@ uint32_t OPENBL_FLASH_GetReadOutProtectionLevel(void)
   return flash_ob.RDPLevel;
 }
 
+/**
+  * @brief  Check if a FLASH range overlaps a write protected area.
+  * @note   The write protection areas are read once from the option bytes and kept in a map,
+  *         they only change through an option bytes launch that resets the device.
+  * @param  Address The start address of the range.
+  * @param  Length The length of the range.
+  * @retval Returns SET if a part of the range is write protected else returns RESET.
+  */
+FlagStatus OPENBL_FLASH_GetWriteProtectionStatus(uint32_t Address, uint32_t Length)
+{
+  uint32_t counter;
+  FlagStatus status = RESET;
+
+  if (FlashWrpMapValid == 0U)
+  {
+    OPENBL_FLASH_LoadWriteProtectionMap();
+  }
+
+  for (counter = 0U; counter < FLASH_WRP_AREAS_NB; counter++)
+  {
+    if ((Address < a_FlashWrpMap[counter].EndAddress)
+        && ((Address + Length) > a_FlashWrpMap[counter].StartAddress))
+    {
+      status = SET;
+    }
+  }
+
+  return status;
+}
+
 /**
   * @brief  Return the FLASH Read Protection level.
   * @param  Level Can be one of these values:
@@ -245,6 +447,9 @@ ErrorStatus OPENBL_FLASH_SetWriteProtection(FunctionalState State, uint8_t *List
 {
   ErrorStatus status = SUCCESS;
 
+  /* The option bytes are about to change, the map will be read again */
+  FlashWrpMapValid = 0U;
+
   if (State == ENABLE)
   {
     OPENBL_FLASH_EnableWriteProtection(ListOfPages, Length);
@@ -278,10 +483,14 @@ ErrorStatus OPENBL_FLASH_SetWriteProtection(FunctionalState State, uint8_t *List
 ErrorStatus OPENBL_FLASH_MassErase(uint8_t *p_Data, uint32_t DataLength)
 {
   uint32_t page_error;
+  uint32_t start_cycles;
+  uint32_t banks_number = 1U;
   uint16_t bank_option;
   ErrorStatus status   = SUCCESS;
   FLASH_EraseInitTypeDef erase_init_struct;
 
+  OPENBL_FLASH_InvalidateImageCache();
+
   /* Unlock the flash memory for erase operation */
   OPENBL_FLASH_Unlock();
 
@@ -294,6 +503,7 @@ ErrorStatus OPENBL_FLASH_MassErase(uint8_t *p_Data, uint32_t DataLength)
     if (bank_option == FLASH_MASS_ERASE)
     {
       erase_init_struct.Banks = 0U;
+      banks_number            = 2U;
     }
     else if (bank_option == FLASH_BANK1_ERASE)
     {
@@ -310,14 +520,23 @@ ErrorStatus OPENBL_FLASH_MassErase(uint8_t *p_Data, uint32_t DataLength)
 
     if (status == SUCCESS)
     {
+      OPENBL_FLASH_SetProgress(0U, banks_number, FlashTiming.BankEraseTime);
+
+      Common_EnableCycleCounter();
+      start_cycles = OPENBL_FLASH_StartTiming();
+
       if (OPENBL_FLASH_ExtendedErase(&erase_init_struct, &page_error) != HAL_OK)
       {
         status = ERROR;
       }
       else
       {
+        OPENBL_FLASH_UpdateTiming(&FlashTiming.BankEraseTime, start_cycles, banks_number);
+
         status = SUCCESS;
       }
+
+      OPENBL_FLASH_SetProgress(banks_number, banks_number, FlashTiming.BankEraseTime);
     }
   }
   else
@@ -344,10 +563,13 @@ ErrorStatus OPENBL_FLASH_Erase(uint8_t *p_Data, uint32_t DataLength)
   uint32_t counter;
   uint32_t pages_number;
   uint32_t page_error;
+  uint32_t start_cycles;
   uint32_t errors = 0U;
   ErrorStatus status = SUCCESS;
   FLASH_EraseInitTypeDef erase_init_struct;
 
+  OPENBL_FLASH_InvalidateImageCache();
+
   /* Unlock the flash memory for erase operation */
   OPENBL_FLASH_Unlock();
 
@@ -357,11 +579,21 @@ ErrorStatus OPENBL_FLASH_Erase(uint8_t *p_Data, uint32_t DataLength)
   pages_number  = (uint32_t)(*(uint16_t *)(p_Data));
   p_Data       += 2;
 
+  if (pages_number > (DataLength / 2U))
+  {
+    pages_number = DataLength / 2U;
+  }
+
   erase_init_struct.TypeErase = FLASH_TYPEERASE_PAGES;
   erase_init_struct.NbPages   = 1U;
 
-  for (counter = 0U; ((counter < pages_number) && (counter < (DataLength / 2U))) ; counter++)
+  /* The cycle counter times the operations to refine the estimates reported to the host */
+  Common_EnableCycleCounter();
+
+  for (counter = 0U; counter < pages_number; counter++)
   {
+    OPENBL_FLASH_SetProgress(counter, pages_number, FlashTiming.PageEraseTime);
+
     erase_init_struct.Page = ((uint32_t)(*(uint16_t *)(p_Data)));
 
     if (erase_init_struct.Page <= 127)
@@ -377,12 +609,25 @@ ErrorStatus OPENBL_FLASH_Erase(uint8_t *p_Data, uint32_t DataLength)
       status = ERROR;
     }
 
+    /* The metadata page is only erased by OPENBL_FLASH_EraseMetadata */
+    if (erase_init_struct.Page == OPENBL_METADATA_PAGE)
+    {
+      status = ERROR;
+      errors++;
+    }
+
     if (status != ERROR)
     {
+      start_cycles = OPENBL_FLASH_StartTiming();
+
       if (OPENBL_FLASH_ExtendedErase(&erase_init_struct, &page_error) != HAL_OK)
       {
         errors++;
       }
+      else
+      {
+        OPENBL_FLASH_UpdateTiming(&FlashTiming.PageEraseTime, start_cycles, 1U);
+      }
     }
     else
     {
@@ -393,6 +638,8 @@ ErrorStatus OPENBL_FLASH_Erase(uint8_t *p_Data, uint32_t DataLength)
     p_Data += 2;
   }
 
+  OPENBL_FLASH_SetProgress(pages_number, pages_number, FlashTiming.PageEraseTime);
+
   if (errors > 0)
   {
     status = ERROR;
@@ -408,6 +655,42 @@ ErrorStatus OPENBL_FLASH_Erase(uint8_t *p_Data, uint32_t DataLength)
   return status;
 }
 
+/**
+  * @brief  Erase the FLASH page reserved for the image metadata record.
+  * @note   The host erase requests skip this page, the record is only rewritten by
+  *         Common_SetImageMetadata.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: Erase operation done
+  *          - ERROR:   Erase operation failed
+  */
+ErrorStatus OPENBL_FLASH_EraseMetadata(void)
+{
+  FLASH_EraseInitTypeDef erase_init_struct;
+  uint32_t page_error = 0U;
+  ErrorStatus status = ERROR;
+
+  /* Unlock the flash memory for erase operation */
+  OPENBL_FLASH_Unlock();
+
+  /* Clear error programming flags */
+  __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
+
+  erase_init_struct.TypeErase = FLASH_TYPEERASE_PAGES;
+  erase_init_struct.Banks     = (OPENBL_METADATA_PAGE < FLASH_PAGE_NB) ? FLASH_BANK_1 : FLASH_BANK_2;
+  erase_init_struct.Page      = OPENBL_METADATA_PAGE;
+  erase_init_struct.NbPages   = 1U;
+
+  if (OPENBL_FLASH_ExtendedErase(&erase_init_struct, &page_error) == HAL_OK)
+  {
+    status = SUCCESS;
+  }
+
+  /* Lock the Flash to disable the flash control register access */
+  OPENBL_FLASH_Lock();
+
+  return status;
+}
+
 /**
  * @brief  This function is used to Set Flash busy state variable to activate busy state sending
  *         during flash operations
@@ -429,17 +712,118 @@ void OPENBL_Disable_BusyState_Flag(void)
   Flash_BusyState = FLASH_BUSY_STATE_DISABLED;
 }
 
+/**
+  * @brief  Handle the FLASH end of operation and operation error interrupts.
+  * @note   When OPENBL_FLASH_USE_IRQ is 1, this function must be called from the FLASH interrupt
+  *         handler (FLASH_S_IRQHandler when the bootloader runs in the secure world).
+  * @retval None.
+  */
+#if defined (__ICCARM__)
+__ramfunc void OPENBL_FLASH_IRQHandler(void)
+#else
+__attribute__((section(".ramfunc"))) void OPENBL_FLASH_IRQHandler(void)
+#endif /* (__ICCARM__) */
+{
+  uint32_t error;
+  __IO uint32_t *reg_sr;
+  __IO uint32_t *reg_cr;
+
+  /* Access to SECSR/SECCR or NSSR/NSCR registers depends on operation type */
+  reg_sr = IS_FLASH_SECURE_OPERATION() ? &(FLASH->SECSR) : &(FLASH_NS->NSSR);
+  reg_cr = IS_FLASH_SECURE_OPERATION() ? &(FLASH->SECCR) : &(FLASH_NS->NSCR);
+
+  /* Keep the errors for the waiting operation, then clear them with the end of operation flag */
+  error = ((*reg_sr) & FLASH_FLAG_SR_ERRORS);
+
+  FlashOperationErrors |= error;
+  (*reg_sr) = (error | FLASH_FLAG_EOP);
+
+  CLEAR_BIT((*reg_cr), (FLASH_NSCR_EOPIE | FLASH_NSCR_ERRIE));
+
+  FlashOperationState = FLASH_OPERATION_DONE;
+}
+
 /* Private functions ---------------------------------------------------------*/
 
 /**
-  * @brief  Program double word at a specified FLASH address.
-  * @param  Address specifies the address to be programmed.
-  * @param  Data specifies the data to be programmed.
+  * @brief  Update the progress of the current flash request reported to the host in busy state.
+  * @param  Done Number of flash operations already completed.
+  * @param  Total Number of flash operations of the current request.
+  * @param  OperationTime Estimated duration in us of one flash operation.
   * @retval None.
   */
-static void OPENBL_FLASH_ProgramQuadWord(uint32_t Address, uint32_t Data)
+static void OPENBL_FLASH_SetProgress(uint32_t Done, uint32_t Total, uint32_t OperationTime)
 {
-  HAL_FLASH_Program(FLASH_TYPEPROGRAM_QUADWORD, Address, Data);
+  uint32_t remaining_time;
+
+  /* Round the remaining time up to the next millisecond */
+  remaining_time = (((Total - Done) * OperationTime) + 999U) / 1000U;
+
+  if (remaining_time > 0xFFFFU)
+  {
+    remaining_time = 0xFFFFU;
+  }
+
+  FlashProgress.Done          = (uint16_t)Done;
+  FlashProgress.Total         = (uint16_t)Total;
+  FlashProgress.RemainingTime = (uint16_t)remaining_time;
+}
+
+/**
+  * @brief  Start the measure of a flash operation duration.
+  * @retval Returns the cycle counter value before the first operation.
+  */
+static uint32_t OPENBL_FLASH_StartTiming(void)
+{
+  FlashHostCycles = 0U;
+
+  return Common_GetCycleCounter();
+}
+
+/**
+  * @brief  Refine the running estimate of a flash operation duration with a new measure.
+  * @note   The cycles spent answering the host polling while waiting for the operations are
+  *         not part of the measure.
+  * @param  pEstimate Pointer to the running estimate in us.
+  * @param  StartCycles Cycle counter value returned by OPENBL_FLASH_StartTiming.
+  * @param  Operations Number of operations measured since StartCycles.
+  * @retval None.
+  */
+static void OPENBL_FLASH_UpdateTiming(uint32_t *pEstimate, uint32_t StartCycles, uint32_t Operations)
+{
+  uint32_t elapsed_time;
+
+  /* The subtraction stays valid across a single wrap of the cycle counter */
+  elapsed_time = (Common_GetCycleCounter() - StartCycles - FlashHostCycles) / (SystemCoreClock / 1000000U);
+  elapsed_time = elapsed_time / Operations;
+
+  *pEstimate = *pEstimate - (*pEstimate >> FLASH_TIMING_FILTER_SHIFT) + (elapsed_time >> FLASH_TIMING_FILTER_SHIFT);
+}
+
+/**
+  * @brief  Get the image digest cache and enable its write access.
+  * @retval Returns a pointer to the cache in the backup registers.
+  */
+static OPENBL_FLASH_ImageCacheTypeDef *OPENBL_FLASH_GetImageCache(void)
+{
+  __HAL_RCC_PWR_CLK_ENABLE();
+  __HAL_RCC_RTCAPB_CLK_ENABLE();
+  HAL_PWR_EnableBkUpAccess();
+
+  return (OPENBL_FLASH_ImageCacheTypeDef *)((uint32_t)&(TAMP->BKP0R) + (4U * OPENBL_IMAGE_CACHE_BKP_INDEX));
+}
+
+/**
+  * @brief  Record a flash modification, the next image verification is a full one.
+  * @retval None.
+  */
+static void OPENBL_FLASH_InvalidateImageCache(void)
+{
+  OPENBL_FLASH_ImageCacheTypeDef *p_cache;
+
+  p_cache = OPENBL_FLASH_GetImageCache();
+
+  p_cache->Generation++;
 }
 
 /**
@@ -575,50 +959,148 @@ static ErrorStatus OPENBL_FLASH_DisableWriteProtection(void)
 }
 
 /**
-  * @brief  Wait for a FLASH operation to complete.
-  * @param  Timeout maximum flash operation timeout.
+  * @brief  This function is used to read the write protection areas from the option bytes.
+  * @retval None.
+  */
+static void OPENBL_FLASH_LoadWriteProtectionMap(void)
+{
+  uint32_t counter;
+  uint32_t bank_address;
+  FLASH_OBProgramInitTypeDef flash_ob;
+  const uint32_t a_wrp_areas[FLASH_WRP_AREAS_NB] = {OB_WRPAREA_BANK1_AREAA, OB_WRPAREA_BANK1_AREAB,
+                                                    OB_WRPAREA_BANK2_AREAA, OB_WRPAREA_BANK2_AREAB
+                                                   };
+
+  for (counter = 0U; counter < FLASH_WRP_AREAS_NB; counter++)
+  {
+    flash_ob.OptionType = 0U;
+    flash_ob.WRPArea    = a_wrp_areas[counter];
+
+    HAL_FLASHEx_OBGetConfig(&flash_ob);
+
+    bank_address = (counter < 2U) ? FLASH_BASE : (FLASH_BASE + FLASH_BANK_SIZE);
+
+    /* An area is disabled when its start offset is above its end offset */
+    if (flash_ob.WRPStartOffset <= flash_ob.WRPEndOffset)
+    {
+      a_FlashWrpMap[counter].StartAddress = bank_address + (flash_ob.WRPStartOffset * FLASH_PAGE_SIZE);
+      a_FlashWrpMap[counter].EndAddress   = bank_address + ((flash_ob.WRPEndOffset + 1U) * FLASH_PAGE_SIZE);
+    }
+    else
+    {
+      a_FlashWrpMap[counter].StartAddress = bank_address;
+      a_FlashWrpMap[counter].EndAddress   = bank_address;
+    }
+  }
+
+  FlashWrpMapValid = 1U;
+}
+
+/**
+  * @brief  Prepare the completion of a FLASH operation through its interrupts.
+  * @note   Must be called before the operation is started, the FLASH_OPERATION_IT bits are set
+  *         together with the start bit of the operation. The FLASH interrupt is only enabled
+  *         when OPENBL_FLASH_USE_IRQ is 1.
+  * @retval None.
+  */
+#if defined (__ICCARM__)
+__ramfunc static void OPENBL_FLASH_StartOperation(void)
+#else
+__attribute__((section(".ramfunc"))) static void OPENBL_FLASH_StartOperation(void)
+#endif /* (__ICCARM__) */
+{
+  FlashOperationErrors = 0U;
+  FlashOperationState  = FLASH_OPERATION_PENDING;
+
+#if (OPENBL_FLASH_USE_IRQ == 1U)
+  NVIC_EnableIRQ(FLASH_OPERATION_IRQn);
+#endif /* (OPENBL_FLASH_USE_IRQ == 1U) */
+}
+
+/**
+  * @brief  Wait for the end of the FLASH operation started after OPENBL_FLASH_StartOperation.
+  * @note   With OPENBL_FLASH_USE_IRQ, the core sleeps until the end of operation or error interrupt,
+  *         or any other interrupt such as a transport reception, else the BSY flag is polled.
+  *         When the busy state is enabled, busy bytes are sent to the host instead.
+  * @param  Timeout maximum number of waiting iterations: polls of the BSY flag, busy states
+  *         sent or wake-ups.
   * @retval HAL_Status
   */
 #if defined (__ICCARM__)
-__ramfunc static HAL_StatusTypeDef OPENBL_FLASH_SendBusyState(uint32_t Timeout)
+__ramfunc static HAL_StatusTypeDef OPENBL_FLASH_WaitForCompletion(uint32_t Timeout)
 #else
-__attribute__((section(".ramfunc"))) static HAL_StatusTypeDef OPENBL_FLASH_SendBusyState(uint32_t Timeout)
+__attribute__((section(".ramfunc"))) static HAL_StatusTypeDef OPENBL_FLASH_WaitForCompletion(uint32_t Timeout)
 #endif /* (__ICCARM__) */
 {
-  uint32_t tick = 0;
+  uint32_t tick = 0U;
   uint32_t error;
+  uint32_t start_cycles;
+#if (OPENBL_FLASH_USE_IRQ == 1U)
+  uint32_t primask_bit;
+#endif /* (OPENBL_FLASH_USE_IRQ == 1U) */
   __IO uint32_t *reg_sr;
-  HAL_StatusTypeDef status;
+  __IO uint32_t *reg_cr;
+  HAL_StatusTypeDef status = HAL_OK;
 
-  /* While the FLASH is in busy state, send busy byte to the host */
-  while (__HAL_FLASH_GET_FLAG(FLASH_FLAG_BSY))
+  /* The BSY flag is checked too, so that the wait ends even if the interrupt is masked */
+  while ((FlashOperationState == FLASH_OPERATION_PENDING) && (__HAL_FLASH_GET_FLAG(FLASH_FLAG_BSY)))
   {
+    /* Every iteration counts, whether it polls, sends the busy state or sleeps */
     if (tick++ > Timeout)
     {
       status = HAL_TIMEOUT;
       break;
     }
+
+    if (Flash_BusyState == FLASH_BUSY_STATE_ENABLED)
+    {
+      /* Send the busy state through the detected interface, the host exchange is not
+         part of the operation duration. The cycle counter is read directly, this
+         function runs from RAM while the FLASH is busy */
+      start_cycles = DWT->CYCCNT;
+
+      OPENBL_SendBusyState();
+
+      FlashHostCycles += DWT->CYCCNT - start_cycles;
+    }
+#if (OPENBL_FLASH_USE_IRQ == 1U)
     else
     {
-      /* Send busy byte */
-      OPENBL_I2C_SendBusyByte();
+      /* Check again with the interrupts masked so that the end of operation cannot be missed,
+         the core is woken up by a pending interrupt even when it is masked */
+      primask_bit = __get_PRIMASK();
+      __disable_irq();
+
+      if ((FlashOperationState == FLASH_OPERATION_PENDING) && (__HAL_FLASH_GET_FLAG(FLASH_FLAG_BSY)))
+      {
+        __WFI();
+      }
+
+      __set_PRIMASK(primask_bit);
     }
+#endif /* (OPENBL_FLASH_USE_IRQ == 1U) */
   }
 
-  /* Access to SECSR or NSSR registers depends on operation type */
+  /* Access to SECSR/SECCR or NSSR/NSCR registers depends on operation type */
   reg_sr = IS_FLASH_SECURE_OPERATION() ? &(FLASH->SECSR) : &(FLASH_NS->NSSR);
+  reg_cr = IS_FLASH_SECURE_OPERATION() ? &(FLASH->SECCR) : &(FLASH_NS->NSCR);
 
-  /* Check FLASH operation error flags */
-  error = ((*reg_sr) & FLASH_FLAG_SR_ERRORS);
+  CLEAR_BIT((*reg_cr), (FLASH_NSCR_EOPIE | FLASH_NSCR_ERRIE));
+
+  /* Errors seen by the interrupt handler, or still pending when the interrupt is masked */
+  error = FlashOperationErrors | ((*reg_sr) & FLASH_FLAG_SR_ERRORS);
 
 #if defined (__ARM_FEATURE_CMSE) && (__ARM_FEATURE_CMSE == 3U)
   error |= (FLASH->NSSR & FLASH_FLAG_OPTWERR);
 #endif /* __ARM_FEATURE_CMSE */
 
-  if (error != 0u)
+  if (error != 0U)
   {
+    /* Save the error code */
+    FlashProcess.ErrorCode |= error;
+
     /* Clear error programming flags */
-    (*reg_sr) = error;
+    (*reg_sr) = ((*reg_sr) & FLASH_FLAG_SR_ERRORS);
 #if defined (__ARM_FEATURE_CMSE) && (__ARM_FEATURE_CMSE == 3U)
     if ((error & FLASH_FLAG_OPTWERR) != 0U)
     {
@@ -636,6 +1118,70 @@ __attribute__((section(".ramfunc"))) static HAL_StatusTypeDef OPENBL_FLASH_SendB
     (*reg_sr) = FLASH_FLAG_EOP;
   }
 
+  FlashOperationState = FLASH_OPERATION_DONE;
+
+  return status;
+}
+
+/**
+  * @brief  Program a quad-word at a specified FLASH address.
+  * @param  Address specifies the address to be programmed.
+  * @param  Data specifies the address of the 16 bytes to be programmed, must be word aligned.
+  * @retval HAL_Status
+  */
+#if defined (__ICCARM__)
+__ramfunc static HAL_StatusTypeDef OPENBL_FLASH_ProgramQuadWord(uint32_t Address, uint32_t Data)
+#else
+__attribute__((section(".ramfunc"))) static HAL_StatusTypeDef OPENBL_FLASH_ProgramQuadWord(uint32_t Address,
+                                                                                        uint32_t Data)
+#endif /* (__ICCARM__) */
+{
+  HAL_StatusTypeDef status;
+  uint32_t index;
+  uint32_t primask_bit;
+  __IO uint32_t *reg_cr;
+  __IO uint32_t *p_dest = (__IO uint32_t *)Address;
+  uint32_t *p_src = (uint32_t *)Data;
+
+  /* Process Locked */
+  __HAL_LOCK(&FlashProcess);
+
+  /* Verify that next operation can be proceed */
+  status = OPENBL_FLASH_WaitForLastOperation(PROGRAM_TIMEOUT);
+
+  if (status == HAL_OK)
+  {
+    /* Access to SECCR or NSCR registers depends on operation type */
+    reg_cr = IS_FLASH_SECURE_OPERATION() ? &(FLASH->SECCR) : &(FLASH_NS->NSCR);
+
+    OPENBL_FLASH_StartOperation();
+
+    /* Set PG bit with the end of operation and error interrupts */
+    SET_BIT((*reg_cr), (FLASH_NSCR_PG | FLASH_OPERATION_IT));
+
+    /* The four words of the quad-word must be written without interruption */
+    primask_bit = __get_PRIMASK();
+    __disable_irq();
+
+    for (index = 0U; index < 4U; index++)
+    {
+      *p_dest = *p_src;
+      p_dest++;
+      p_src++;
+    }
+
+    __set_PRIMASK(primask_bit);
+
+    /* Wait for the end of the programming, the core sleeps meanwhile */
+    status = OPENBL_FLASH_WaitForCompletion(PROGRAM_TIMEOUT);
+
+    /* If the program operation is completed, disable the PG bit */
+    CLEAR_BIT((*reg_cr), FLASH_NSCR_PG);
+  }
+
+  /* Process Unlocked */
+  __HAL_UNLOCK(&FlashProcess);
+
   return status;
 }
 
@@ -756,25 +1302,17 @@ __attribute__((section(".ramfunc"))) static HAL_StatusTypeDef OPENBL_FLASH_Exten
       SET_BIT((*reg_cr), FLASH_NSCR_BKER);
     }
 
-    /* Proceed to erase the page */
-    MODIFY_REG((*reg_cr), (FLASH_NSCR_PNB | FLASH_NSCR_PER | FLASH_NSCR_STRT),
-               (((pEraseInit->Page) << FLASH_NSCR_PNB_Pos) | FLASH_NSCR_PER | FLASH_NSCR_STRT));
+    OPENBL_FLASH_StartOperation();
 
-    if (Flash_BusyState == FLASH_BUSY_STATE_ENABLED)
-    {
-      /* Wait for last operation to be completed to send busy byte */
-      if (OPENBL_FLASH_SendBusyState(PROGRAM_TIMEOUT) != HAL_OK)
-      {
-        errors++;
-      }
-    }
-    else
+    /* Proceed to erase the page, completion is signaled by the end of operation interrupt */
+    MODIFY_REG((*reg_cr), (FLASH_NSCR_PNB | FLASH_NSCR_PER | FLASH_NSCR_STRT | FLASH_NSCR_EOPIE | FLASH_NSCR_ERRIE),
+               (((pEraseInit->Page) << FLASH_NSCR_PNB_Pos) | FLASH_NSCR_PER | FLASH_NSCR_STRT
+                | FLASH_OPERATION_IT));
+
+    /* Wait for the end of the erase, sending busy bytes to the host if enabled */
+    if (OPENBL_FLASH_WaitForCompletion(PROGRAM_TIMEOUT) != HAL_OK)
     {
-      /* Wait for last operation to be completed */
-      if (OPENBL_FLASH_WaitForLastOperation(PROGRAM_TIMEOUT) != HAL_OK)
-      {
-        errors++;
-      }
+      errors++;
     }
 
     /* If the erase operation is completed, disable the associated bits */
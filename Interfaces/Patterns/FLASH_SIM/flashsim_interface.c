@@ -0,0 +1,367 @@
+/**
+  ******************************************************************************
+  * @file    flashsim_interface.c
+  * @author  MCD Application Team
+  * @brief   Contains simulated FLASH access functions backed by a flash image
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "platform.h"
+#include "openbl_mem.h"
+#include "openbl_kernels.h"
+#include "flashsim_interface.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define FLASHSIM_ERASED_BYTE           0xFFU
+#define FLASHSIM_PAGES_NUMBER          (FLASH_BL_SIZE / FLASHSIM_PAGE_SIZE)
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static uint8_t *FlashSimImage = NULL;
+static OPENBL_FLASHSIM_TimingTypeDef FlashSimTiming = {0U, 0U, 0U, NULL};
+static uint32_t FlashSimErrors = FLASHSIM_ERROR_NONE;
+static uint32_t FlashSimElapsedTime = 0U;
+
+/* Private function prototypes -----------------------------------------------*/
+static void OPENBL_FLASHSIM_EraseArea(uint32_t Offset, uint32_t Size, uint32_t OperationTime);
+static ErrorStatus OPENBL_FLASHSIM_ProgramQuadWord(uint32_t Offset, uint8_t *Data);
+static void OPENBL_FLASHSIM_Elapse(uint32_t Time);
+
+/* Exported variables --------------------------------------------------------*/
+OPENBL_MemoryTypeDef FLASHSIM_Descriptor =
+{
+  FLASH_START_ADDRESS,
+  FLASH_END_ADDRESS,
+  FLASH_BL_SIZE,
+  FLASH_AREA,
+  OPENBL_FLASHSIM_Read,
+  OPENBL_FLASHSIM_Write,
+  NULL,
+  NULL,
+  NULL,
+  OPENBL_FLASHSIM_MassErase,
+  OPENBL_FLASHSIM_Erase
+};
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  This function is used to attach the simulated FLASH to its image.
+  * @note   The image content is left untouched so that, when it is backed by a
+  *         memory-mapped file, its state persists across simulated resets.
+  * @param  pImage Pointer to the image, it must be FLASH_BL_SIZE bytes long.
+  * @param  pTiming Simulated operations durations, NULL to run at memory speed.
+  * @retval None.
+  */
+void OPENBL_FLASHSIM_Init(uint8_t *pImage, const OPENBL_FLASHSIM_TimingTypeDef *pTiming)
+{
+  FlashSimImage = pImage;
+
+  if (pTiming != NULL)
+  {
+    FlashSimTiming = *pTiming;
+  }
+  else
+  {
+    FlashSimTiming.PageEraseTime       = 0U;
+    FlashSimTiming.BankEraseTime       = 0U;
+    FlashSimTiming.QuadWordProgramTime = 0U;
+    FlashSimTiming.Delay               = NULL;
+  }
+
+  FlashSimErrors      = FLASHSIM_ERROR_NONE;
+  FlashSimElapsedTime = 0U;
+}
+
+/**
+  * @brief  This function is used to read data from a given address.
+  * @param  Address The address to be read.
+  * @retval Returns the read value.
+  */
+uint8_t OPENBL_FLASHSIM_Read(uint32_t Address)
+{
+  return FlashSimImage[Address - FLASH_START_ADDRESS];
+}
+
+/**
+  * @brief  This function is used to write data in the simulated FLASH memory.
+  * @note   As for OPENBL_FLASH_Write, the head and tail fragments are merged with the
+  *         current content of their quad-word and only erased quad-words can be
+  *         programmed. Violations are recorded in the error flags and fail the write.
+  * @param  Address The address where that data will be written.
+  * @param  Data The data to be written.
+  * @param  DataLength The length of the data to be written.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: Write operation done
+  *          - ERROR:   Write operation failed
+  */
+ErrorStatus OPENBL_FLASHSIM_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength)
+{
+  uint32_t index;
+  uint32_t offset;
+  uint32_t length;
+  uint32_t quad_word_offset;
+  ErrorStatus status = SUCCESS;
+  uint8_t quad_word[FLASHSIM_QUADWORD_SIZE];
+
+  offset = Address - FLASH_START_ADDRESS;
+
+  if ((Address < FLASH_START_ADDRESS) || (offset > FLASH_BL_SIZE) || (DataLength > (FLASH_BL_SIZE - offset)))
+  {
+    FlashSimErrors |= FLASHSIM_ERROR_RANGE;
+    status          = ERROR;
+  }
+  else
+  {
+    quad_word_offset = offset & ~(FLASHSIM_QUADWORD_SIZE - 1U);
+    offset           = offset - quad_word_offset;
+
+    while (DataLength > 0U)
+    {
+      length = FLASHSIM_QUADWORD_SIZE - offset;
+
+      if (length > DataLength)
+      {
+        length = DataLength;
+      }
+
+      for (index = 0U; index < FLASHSIM_QUADWORD_SIZE; index++)
+      {
+        quad_word[index] = FlashSimImage[quad_word_offset + index];
+      }
+
+      for (index = 0U; index < length; index++)
+      {
+        quad_word[offset + index] = Data[index];
+      }
+
+      /* Stop at the first failure, as the real FLASH */
+      if (OPENBL_FLASHSIM_ProgramQuadWord(quad_word_offset, quad_word) != SUCCESS)
+      {
+        status = ERROR;
+        break;
+      }
+
+      quad_word_offset += FLASHSIM_QUADWORD_SIZE;
+      Data             += length;
+      DataLength       -= length;
+      offset            = 0U;
+    }
+  }
+
+  return status;
+}
+
+/**
+  * @brief  This function is used to start the simulated FLASH mass erase operation.
+  * @param  *p_Data Pointer to the buffer that contains mass erase operation options.
+  * @param  DataLength Size of the Data buffer.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: Mass erase operation done
+  *          - ERROR:   Mass erase operation failed or the value of one parameter is not OK
+  */
+ErrorStatus OPENBL_FLASHSIM_MassErase(uint8_t *p_Data, uint32_t DataLength)
+{
+  uint16_t bank_option;
+  ErrorStatus status = SUCCESS;
+
+  if (DataLength >= 2U)
+  {
+    bank_option = *(uint16_t *)(p_Data);
+
+    if (bank_option == FLASH_MASS_ERASE)
+    {
+      OPENBL_FLASHSIM_EraseArea(0U, FLASHSIM_BANK_SIZE, FlashSimTiming.BankEraseTime);
+      OPENBL_FLASHSIM_EraseArea(FLASHSIM_BANK_SIZE, FLASHSIM_BANK_SIZE, FlashSimTiming.BankEraseTime);
+    }
+    else if (bank_option == FLASH_BANK1_ERASE)
+    {
+      OPENBL_FLASHSIM_EraseArea(0U, FLASHSIM_BANK_SIZE, FlashSimTiming.BankEraseTime);
+    }
+    else if (bank_option == FLASH_BANK2_ERASE)
+    {
+      OPENBL_FLASHSIM_EraseArea(FLASHSIM_BANK_SIZE, FLASHSIM_BANK_SIZE, FlashSimTiming.BankEraseTime);
+    }
+    else
+    {
+      status = ERROR;
+    }
+  }
+  else
+  {
+    status = ERROR;
+  }
+
+  return status;
+}
+
+/**
+  * @brief  This function is used to erase the specified simulated FLASH pages.
+  * @param  *p_Data Pointer to the buffer that contains erase operation options.
+  * @param  DataLength Size of the Data buffer.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: Erase operation done
+  *          - ERROR:   Erase operation failed or the value of one parameter is not OK
+  */
+ErrorStatus OPENBL_FLASHSIM_Erase(uint8_t *p_Data, uint32_t DataLength)
+{
+  uint32_t counter;
+  uint32_t page;
+  uint32_t pages_number;
+  uint32_t errors = 0U;
+  ErrorStatus status;
+
+  pages_number  = (uint32_t)(*(uint16_t *)(p_Data));
+  p_Data       += 2;
+
+  if (pages_number > (DataLength / 2U))
+  {
+    pages_number = DataLength / 2U;
+  }
+
+  for (counter = 0U; counter < pages_number; counter++)
+  {
+    page = (uint32_t)(*(uint16_t *)(p_Data));
+
+    if (page < FLASHSIM_PAGES_NUMBER)
+    {
+      OPENBL_FLASHSIM_EraseArea((page * FLASHSIM_PAGE_SIZE), FLASHSIM_PAGE_SIZE, FlashSimTiming.PageEraseTime);
+    }
+    else
+    {
+      FlashSimErrors |= FLASHSIM_ERROR_RANGE;
+      errors++;
+    }
+
+    p_Data += 2;
+  }
+
+  if (errors > 0U)
+  {
+    status = ERROR;
+  }
+  else
+  {
+    status = SUCCESS;
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Compute the CRC32 of a word aligned area of the simulated FLASH.
+  * @note   Same digest as OPENBL_FLASH_ComputeDigest with the CRC peripheral, so that
+  *         the image footer and metadata checks can run on the simulated FLASH.
+  * @param  Address The start address of the area.
+  * @param  Length The length of the area, multiple of 4.
+  * @retval Returns the CRC32 of the area.
+  */
+uint32_t OPENBL_FLASHSIM_ComputeDigest(uint32_t Address, uint32_t Length)
+{
+  uint32_t digest = OPENBL_KERNEL_CRC32_INIT;
+  uint32_t offset;
+
+  offset = Address - FLASH_START_ADDRESS;
+
+  if ((Address < FLASH_START_ADDRESS) || (offset > FLASH_BL_SIZE) || (Length > (FLASH_BL_SIZE - offset)))
+  {
+    FlashSimErrors |= FLASHSIM_ERROR_RANGE;
+  }
+  else
+  {
+    digest = OPENBL_KERNEL_Crc32(digest, &FlashSimImage[offset], Length);
+  }
+
+  return digest;
+}
+
+/**
+  * @brief  This function is used to get the errors recorded since the initialization.
+  * @retval Returns a combination of FLASHSIM_ERROR_xxx flags.
+  */
+uint32_t OPENBL_FLASHSIM_GetErrors(void)
+{
+  return FlashSimErrors;
+}
+
+/**
+  * @brief  This function is used to get the simulated time spent in FLASH operations.
+  * @retval Returns the elapsed time in us since the initialization.
+  */
+uint32_t OPENBL_FLASHSIM_GetElapsedTime(void)
+{
+  return FlashSimElapsedTime;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Erase an area of the simulated FLASH.
+  * @param  Offset Offset of the area in the image.
+  * @param  Size Size of the area.
+  * @param  OperationTime Simulated duration in us of the erase.
+  * @retval None.
+  */
+static void OPENBL_FLASHSIM_EraseArea(uint32_t Offset, uint32_t Size, uint32_t OperationTime)
+{
+  OPENBL_KERNEL_Fill(&FlashSimImage[Offset], Size, FLASHSIM_ERASED_BYTE);
+
+  OPENBL_FLASHSIM_Elapse(OperationTime);
+}
+
+/**
+  * @brief  Program a quad-word at a specified offset of the simulated FLASH.
+  * @param  Offset Quad-word aligned offset in the image.
+  * @param  Data Pointer to the 16 bytes to be programmed.
+  * @retval Returns ERROR if the quad-word is not erased else SUCCESS.
+  */
+static ErrorStatus OPENBL_FLASHSIM_ProgramQuadWord(uint32_t Offset, uint8_t *Data)
+{
+  uint32_t index;
+  ErrorStatus status = SUCCESS;
+
+  /* As the real FLASH, refuse to program a quad-word that is not erased */
+  if (OPENBL_KERNEL_IsFilled(&FlashSimImage[Offset], FLASHSIM_QUADWORD_SIZE, FLASHSIM_ERASED_BYTE) == 0U)
+  {
+    FlashSimErrors |= FLASHSIM_ERROR_NOT_ERASED;
+    status          = ERROR;
+  }
+  else
+  {
+    for (index = 0U; index < FLASHSIM_QUADWORD_SIZE; index++)
+    {
+      FlashSimImage[Offset + index] = Data[index];
+    }
+  }
+
+  OPENBL_FLASHSIM_Elapse(FlashSimTiming.QuadWordProgramTime);
+
+  return status;
+}
+
+/**
+  * @brief  Account the duration of a simulated FLASH operation.
+  * @param  Time Duration in us of the operation.
+  * @retval None.
+  */
+static void OPENBL_FLASHSIM_Elapse(uint32_t Time)
+{
+  FlashSimElapsedTime += Time;
+
+  if (FlashSimTiming.Delay != NULL)
+  {
+    FlashSimTiming.Delay(Time);
+  }
+}
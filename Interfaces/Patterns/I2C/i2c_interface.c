@@ -27,13 +27,17 @@
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
+
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 static uint8_t I2cDetected = 0;
+static uint8_t I2cBroadcast = 0U;
 
 /* Exported variables --------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
 static void OPENBL_I2C_Init(void);
+static uint8_t OPENBL_I2C_IsBroadcastCommand(uint8_t Command);
+static void OPENBL_I2C_SendSpecialReport(uint8_t *pBuffer, uint32_t Length);
 
 /* Private functions ---------------------------------------------------------*/
 
@@ -54,9 +58,81 @@ static void OPENBL_I2C_Init(void)
   I2C_InitStruct.OwnAddrSize         = LL_I2C_OWNADDRESS1_7BIT;
 
   LL_I2C_Init(I2Cx, &I2C_InitStruct);
+
+  if (I2C_BROADCAST_MODE != 0U)
+  {
+    /* All the devices of the bus also answer to the broadcast address */
+    if (I2C_GROUP_ADDRESS == 0x00U)
+    {
+      LL_I2C_EnableGeneralCall(I2Cx);
+    }
+    else
+    {
+      LL_I2C_SetOwnAddress2(I2Cx, I2C_GROUP_ADDRESS, LL_I2C_OWNADDRESS2_NOMASK);
+      LL_I2C_EnableOwnAddress2(I2Cx);
+    }
+  }
+
   LL_I2C_Enable(I2Cx);
 }
 
+/**
+ * @brief  This function is used to check if a command can be broadcast.
+ * @note   Only the write and erase commands are accepted, the commands that return data
+ *         must be sent to the device address.
+ * @param  Command The command opcode.
+ * @retval Returns 1 if the command can be broadcast else 0.
+ */
+static uint8_t OPENBL_I2C_IsBroadcastCommand(uint8_t Command)
+{
+  uint8_t status;
+
+  switch (Command)
+  {
+    case CMD_WRITE_MEMORY:
+    case CMD_NS_WRITE_MEMORY:
+    case CMD_EXT_ERASE_MEMORY:
+    case CMD_NS_ERASE_MEMORY:
+      status = 1U;
+      break;
+
+    default:
+      status = 0U;
+      break;
+  }
+
+  return status;
+}
+
+/**
+ * @brief  This function is used to send the answer of a special command: the data size,
+ *         the data then a NULL status size.
+ * @param  pBuffer Pointer to the data of the answer.
+ * @param  Length Size of the data.
+ * @retval None.
+ */
+static void OPENBL_I2C_SendSpecialReport(uint8_t *pBuffer, uint32_t Length)
+{
+  uint32_t index;
+
+  /* Send data size */
+  OPENBL_I2C_SendByte((uint8_t)(Length >> 8));
+  OPENBL_I2C_SendByte((uint8_t)(Length & 0xFFU));
+
+  /* Send data */
+  for (index = 0U; index < Length; index++)
+  {
+    OPENBL_I2C_SendByte(pBuffer[index]);
+  }
+
+  /* Wait for address to match */
+  OPENBL_I2C_WaitAddress();
+
+  /* Send NULL status size */
+  OPENBL_I2C_SendByte(0x00U);
+  OPENBL_I2C_SendByte(0x00U);
+}
+
 /* Exported functions --------------------------------------------------------*/
 
 /**
@@ -138,6 +214,16 @@ uint8_t OPENBL_I2C_GetCommandOpcode(void)
     OPENBL_IWDG_Refresh();
   }
 
+  /* A command sent to the broadcast address is processed without answering the host */
+  if ((I2C_BROADCAST_MODE != 0U) && (LL_I2C_GetAddressMatchCode(I2Cx) != I2C_ADDRESS))
+  {
+    I2cBroadcast = 1U;
+  }
+  else
+  {
+    I2cBroadcast = 0U;
+  }
+
   LL_I2C_ClearFlag_ADDR(I2Cx);
 
   /* Get the command opcode */
@@ -148,6 +234,14 @@ uint8_t OPENBL_I2C_GetCommandOpcode(void)
   {
     command_opc = ERROR_COMMAND;
   }
+  else if ((I2cBroadcast != 0U) && (OPENBL_I2C_IsBroadcastCommand(command_opc) == 0U))
+  {
+    command_opc = ERROR_COMMAND;
+  }
+  else
+  {
+    /* The command can be processed */
+  }
 
   OPENBL_I2C_WaitStop();
 
@@ -158,13 +252,14 @@ uint8_t OPENBL_I2C_GetCommandOpcode(void)
   * @brief  This function is used to read one byte from I2C pipe.
   * @retval Returns the read byte.
   */
-uint8_t OPENBL_I2C_ReadByte(void)
+OPENBL_HOT_PATH uint8_t OPENBL_I2C_ReadByte(void)
 {
   uint32_t timeout = 0U;
 
   while (LL_I2C_IsActiveFlag_RXNE(I2Cx) == 0)
   {
-    OPENBL_IWDG_Refresh();
+    /* Refresh IWDG: reload counter */
+    IWDG->KR = IWDG_KEY_RELOAD;
 
     if ((timeout++) >= OPENBL_I2C_TIMEOUT)
     {
@@ -178,28 +273,37 @@ uint8_t OPENBL_I2C_ReadByte(void)
 
 /**
   * @brief  This function is used to send one byte through I2C pipe.
+  * @note   During a broadcast command the byte is only recorded, the host cannot read it.
   * @param  Byte The byte to be sent.
   * @retval None.
   */
-void OPENBL_I2C_SendByte(uint8_t Byte)
+OPENBL_HOT_PATH void OPENBL_I2C_SendByte(uint8_t Byte)
 {
   uint32_t timeout = 0U;
 
-  if (LL_I2C_IsActiveFlag_TXIS(I2Cx) == 0)
+  if (I2cBroadcast != 0U)
+  {
+    Common_RecordBroadcastByte(Byte);
+  }
+  else
   {
-    while (LL_I2C_IsActiveFlag_TXIS(I2Cx) == 0)
+    if (LL_I2C_IsActiveFlag_TXIS(I2Cx) == 0)
     {
-      OPENBL_IWDG_Refresh();
-
-      if ((timeout++) >= OPENBL_I2C_TIMEOUT)
+      while (LL_I2C_IsActiveFlag_TXIS(I2Cx) == 0)
       {
-        /* System Reset */
-        NVIC_SystemReset();
+        /* Refresh IWDG: reload counter */
+        IWDG->KR = IWDG_KEY_RELOAD;
+
+        if ((timeout++) >= OPENBL_I2C_TIMEOUT)
+        {
+          /* System Reset */
+          NVIC_SystemReset();
+        }
       }
     }
-  }
 
-  LL_I2C_TransmitData8(I2Cx, Byte);
+    LL_I2C_TransmitData8(I2Cx, Byte);
+  }
 }
 
 /**
@@ -294,22 +398,33 @@ __attribute__((section(".ramfunc"))) void OPENBL_I2C_WaitStop(void)
   */
 void OPENBL_I2C_SendAcknowledgeByte(uint8_t Byte)
 {
-  /* Wait until address is matched */
-  OPENBL_I2C_WaitAddress();
+  if (I2cBroadcast != 0U)
+  {
+    /* The host cannot read from the broadcast address, the acknowledge is
+       reported later by the SPECIAL_CMD_GET_NODE_STATUS command */
+    Common_RecordBroadcastByte(Byte);
+  }
+  else
+  {
+    /* Wait until address is matched */
+    OPENBL_I2C_WaitAddress();
 
-  /* Send ACK or NACK byte */
-  OPENBL_I2C_SendByte(Byte);
+    /* Send ACK or NACK byte */
+    OPENBL_I2C_SendByte(Byte);
 
-  /* Wait until NACK is detected */
-  OPENBL_I2C_WaitNack();
+    /* Wait until NACK is detected */
+    OPENBL_I2C_WaitNack();
 
-  /* Wait until STOP byte is detected*/
-  OPENBL_I2C_WaitStop();
+    /* Wait until STOP byte is detected*/
+    OPENBL_I2C_WaitStop();
+  }
 }
 
 /**
   * @brief  This function is used to send busy byte through I2C pipe.
-  * @param
+  * @note   The busy byte is followed by the progress of the flash request (operations done
+  *         and total, MSB first) and by its estimated remaining time in ms (MSB first).
+  *         A host that reads only one byte gets the legacy busy answer.
   * @retval None.
   */
 #if defined (__ICCARM__)
@@ -319,6 +434,9 @@ __attribute__((section(".ramfunc"))) void OPENBL_I2C_SendBusyByte(void)
 #endif /* (__ICCARM__) */
 {
   uint32_t timeout = 0;
+  uint32_t index;
+  uint32_t length;
+  uint8_t busy_frame[COMMON_BUSY_FRAME_SIZE];
 
   /* Wait for the received address to match with the device address */
   if (((I2Cx->ISR & I2C_ISR_ADDR) != 0))
@@ -326,27 +444,41 @@ __attribute__((section(".ramfunc"))) void OPENBL_I2C_SendBusyByte(void)
     /* Clear the flag of address match*/
     I2Cx->ICR |= I2C_ICR_ADDRCF;
 
-    /* While the transmit data is not empty, refresh the IWDG,
-    if the timeout is reached a system reset occurs */
-    while ((I2Cx->ISR & I2C_ISR_TXIS) == 0)
+    length = Common_SetBusyFrame(busy_frame);
+
+    for (index = 0U; index < length; index++)
     {
-      IWDG->KR = IWDG_KEY_RELOAD;
+      /* While the transmit data is not empty and the host did not end the read, refresh the IWDG,
+      if the timeout is reached a system reset occurs */
+      while ((I2Cx->ISR & (I2C_ISR_TXIS | I2C_ISR_NACKF)) == 0)
+      {
+        IWDG->KR = IWDG_KEY_RELOAD;
+
+        if ((timeout++) >= OPENBL_I2C_TIMEOUT)
+        {
+          /* System Reset */
+          SCB->AIRCR  = ((0x5FAUL << SCB_AIRCR_VECTKEY_Pos)    |
+                         (SCB->AIRCR & SCB_AIRCR_PRIGROUP_Msk) |
+                         SCB_AIRCR_SYSRESETREQ_Msk);
+        }
+      }
 
-      if ((timeout++) >= OPENBL_I2C_TIMEOUT)
+      /* The host ends the read by a NACK */
+      if ((I2Cx->ISR & I2C_ISR_NACKF) != 0)
       {
-        /* System Reset */
-        SCB->AIRCR  = ((0x5FAUL << SCB_AIRCR_VECTKEY_Pos)    |
-                       (SCB->AIRCR & SCB_AIRCR_PRIGROUP_Msk) |
-                       SCB_AIRCR_SYSRESETREQ_Msk);
+        break;
       }
-    }
 
-    /* Send busy byte */
-    I2Cx->TXDR = BUSY_BYTE;
+      /* Send busy frame byte */
+      I2Cx->TXDR = busy_frame[index];
+    }
 
     /* Wait until NACK is detected */
     OPENBL_I2C_WaitNack();
 
+    /* Flush the byte that may remain in the transmit data register */
+    I2Cx->ISR |= I2C_ISR_TXE;
+
     /* Wait until STOP byte is detected */
     OPENBL_I2C_WaitStop();
   }
@@ -360,12 +492,96 @@ __attribute__((section(".ramfunc"))) void OPENBL_I2C_SendBusyByte(void)
  */
 void OPENBL_I2C_SpecialCommandProcess(OPENBL_SpecialCmdTypeDef *SpecialCmd)
 {
-  switch (SpecialCmd->OpCode)
+  uint8_t a_report[COMMON_RAM_USAGE_MAX_SIZE];
+  uint32_t length;
+  uint32_t index;
+
+  /* Only the extent data has an extended form, the other extended commands are rejected */
+  if (SpecialCmd->CmdType != OPENBL_SPECIAL_CMD)
   {
-    /* Unknown command opcode */
-    default:
-      if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
+    if (SpecialCmd->OpCode == SPECIAL_CMD_EXTENT_DATA)
+    {
+      length = Common_WriteExtentData(a_report, SpecialCmd->Buffer2, SpecialCmd->SizeBuffer2);
+
+      /* Send status size */
+      OPENBL_I2C_SendByte((uint8_t)(length >> 8));
+      OPENBL_I2C_SendByte((uint8_t)(length & 0xFFU));
+
+      /* Send status */
+      for (index = 0U; index < length; index++)
       {
+        OPENBL_I2C_SendByte(a_report[index]);
+      }
+    }
+    else
+    {
+      /* Send NULL status size */
+      OPENBL_I2C_SendByte(0x00U);
+      OPENBL_I2C_SendByte(0x00U);
+    }
+  }
+  else
+  {
+    switch (SpecialCmd->OpCode)
+    {
+      /* Report the stack and RAM buffer high-water marks */
+      case SPECIAL_CMD_GET_RAM_USAGE:
+        length = OPENBL_I2C_GetRamUsage(a_report);
+
+        OPENBL_I2C_SendSpecialReport(a_report, length);
+        break;
+
+      /* Erase a FLASH bank by slices, the other memories can be read between two requests */
+      case SPECIAL_CMD_SUSPENDABLE_ERASE:
+        length = Common_SuspendableErase(a_report, SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1);
+
+        OPENBL_I2C_SendSpecialReport(a_report, length);
+        break;
+
+      /* Report the outcome of the broadcast commands */
+      case SPECIAL_CMD_GET_NODE_STATUS:
+        length = Common_GetBroadcastStatus(a_report);
+
+        OPENBL_I2C_SendSpecialReport(a_report, length);
+        break;
+
+      /* Report the measured durations of the flash operations to tune the host timeouts */
+      case SPECIAL_CMD_GET_FLASH_TIMING:
+        length = Common_GetFlashTiming(a_report);
+
+        OPENBL_I2C_SendSpecialReport(a_report, length);
+        break;
+
+      /* Report the link error statistics and the recommended frame size */
+      case SPECIAL_CMD_GET_LINK_STATUS:
+        length = Common_GetLinkStatus(a_report);
+
+        OPENBL_I2C_SendSpecialReport(a_report, length);
+        break;
+
+      /* Store the metadata of the image programmed during this session */
+      case SPECIAL_CMD_SET_IMAGE_METADATA:
+        length = Common_SetImageMetadata(a_report, SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1);
+
+        OPENBL_I2C_SendSpecialReport(a_report, length);
+        break;
+
+      /* Compare the stored image metadata with the host one to skip a redundant programming */
+      case SPECIAL_CMD_CHECK_IMAGE_METADATA:
+        length = Common_CheckImageMetadata(a_report, SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1);
+
+        OPENBL_I2C_SendSpecialReport(a_report, length);
+        break;
+
+      /* Erase the pages touched by an extent table and open a sparse upload session */
+      case SPECIAL_CMD_START_EXTENTS:
+        length = Common_StartExtents(a_report, SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1);
+
+        OPENBL_I2C_SendSpecialReport(a_report, length);
+        break;
+
+      /* Unknown command opcode, the extent data is only an extended command */
+      default:
         /* Send NULL data size */
         OPENBL_I2C_SendByte(0x00U);
         OPENBL_I2C_SendByte(0x00U);
@@ -376,34 +592,8 @@ void OPENBL_I2C_SpecialCommandProcess(OPENBL_SpecialCmdTypeDef *SpecialCmd)
         /* Send NULL status size */
         OPENBL_I2C_SendByte(0x00U);
         OPENBL_I2C_SendByte(0x00U);
-      }
-      else if (SpecialCmd->CmdType == OPENBL_EXTENDED_SPECIAL_CMD)
-      {
-        /* Send NULL status size */
-        OPENBL_I2C_SendByte(0x00U);
-        OPENBL_I2C_SendByte(0x00U);
-      }
-      break;
+        break;
+    }
   }
 }
 
-/**
- * @brief  This function is used to Set Flash busy state variable to activate busy state sending
- *         during flash operations
- * @retval None.
-*/
-void OPENBL_Enable_BusyState_Sending(void)
-{
-  /* Enable Flash busy state sending */
-  OPENBL_Enable_BusyState_Flag();
-}
-
-/**
- * @brief  This function is used to disable the send of busy state in I2C non stretch mode.
- * @retval None.
-*/
-void OPENBL_Disable_BusyState_Sending(void)
-{
-  /* Disable Flash busy state sending */
-  OPENBL_Disable_BusyState_Flag();
-}
@@ -38,13 +38,11 @@ void OPENBL_I2C_DeInit(void);
 uint8_t OPENBL_I2C_ProtocolDetection(void);
 
 uint8_t OPENBL_I2C_GetCommandOpcode(void);
-uint8_t OPENBL_I2C_ReadByte(void);
-void OPENBL_I2C_SendByte(uint8_t Byte);
+OPENBL_HOT_PATH uint8_t OPENBL_I2C_ReadByte(void);
+OPENBL_HOT_PATH void OPENBL_I2C_SendByte(uint8_t Byte);
 void OPENBL_I2C_WaitAddress(void);
 void OPENBL_I2C_SendAcknowledgeByte(uint8_t Byte);
 void OPENBL_I2C_SpecialCommandProcess(OPENBL_SpecialCmdTypeDef *Frame);
-void OPENBL_Enable_BusyState_Sending(void);
-void OPENBL_Disable_BusyState_Sending(void);
 
 #if defined (__ICCARM__)
 __ramfunc void OPENBL_I2C_WaitNack(void);
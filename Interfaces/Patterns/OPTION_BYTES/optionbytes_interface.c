@@ -96,10 +96,14 @@ void BL_FLASH_WriteOptKeys(void)
   * @param  Address The address where that data will be written.
   * @param  Data The data to be written.
   * @param  DataLength The length of the data to be written.
-  * @retval None.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: Write operation done
+  *          - ERROR:   Write operation failed
   */
-void OPENBL_OB_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength)
+ErrorStatus OPENBL_OB_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength)
 {
+  ErrorStatus status = SUCCESS;
+
   /* Unlock the FLASH & Option Bytes Registers access */
   HAL_FLASH_Unlock();
   HAL_FLASH_OB_Unlock();
@@ -198,4 +202,6 @@ void OPENBL_OB_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength)
 
   /* Register system reset callback */
   Common_SetPostProcessingCallback(OPENBL_OB_Launch);
+
+  return status;
 }
@@ -30,7 +30,7 @@ extern "C" {
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
 uint8_t OPENBL_OTP_Read(uint32_t Address);
-void OPENBL_OTP_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength);
+ErrorStatus OPENBL_OTP_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength);
 
 #ifdef __cplusplus
 }
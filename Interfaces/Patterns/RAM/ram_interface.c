@@ -62,12 +62,15 @@ uint8_t OPENBL_RAM_Read(uint32_t Address)
   * @param  Address The address where that data will be written.
   * @param  pData The data to be written.
   * @param  DataLength The length of the data to be written.
-  * @retval None.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: Write operation done
+  *          - ERROR:   Write operation failed
   */
-void OPENBL_RAM_Write(uint32_t Address, uint8_t *pData, uint32_t DataLength)
+OPENBL_HOT_PATH ErrorStatus OPENBL_RAM_Write(uint32_t Address, uint8_t *pData, uint32_t DataLength)
 {
   uint32_t index;
   uint32_t aligned_length = DataLength;
+  ErrorStatus status = SUCCESS;
 
   if (aligned_length & 0x3)
   {
@@ -78,6 +81,8 @@ void OPENBL_RAM_Write(uint32_t Address, uint8_t *pData, uint32_t DataLength)
   {
     *(__IO uint32_t *)(Address + index) = *(__IO uint32_t *)(pData + index);
   }
+
+  return status;
 }
 
 /**
@@ -90,7 +95,14 @@ void OPENBL_RAM_JumpToAddress(uint32_t Address)
   Function_Pointer jump_to_address;
 
   /* De-initialize all HW resources used by the Open Bootloader to their reset values */
-  OPENBL_DeInit();
+  if (OPENBL_FAST_HANDOFF != 0U)
+  {
+    Common_FastHandOff();
+  }
+  else
+  {
+    OPENBL_DeInit();
+  }
 
   /* Enable IRQ */
   Common_EnableIrq();
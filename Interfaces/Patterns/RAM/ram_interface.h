@@ -25,13 +25,15 @@ extern "C" {
 #endif
 
 /* Includes ------------------------------------------------------------------*/
+#include "common_interface.h"
+
 /* Exported types ------------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
 void OPENBL_RAM_JumpToAddress(uint32_t Address);
 uint8_t OPENBL_RAM_Read(uint32_t Address);
-void OPENBL_RAM_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength);
+OPENBL_HOT_PATH ErrorStatus OPENBL_RAM_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength);
 
 #ifdef __cplusplus
 }
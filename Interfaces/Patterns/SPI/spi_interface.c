@@ -23,21 +23,26 @@
 #include "openbl_spi_cmd.h"
 #include "spi_interface.h"
 #include "iwdg_interface.h"
+#include "common_interface.h"
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
 #define SPI_DUMMY_BYTE                    0x00U  /* Dummy byte */
 #define SPI_SYNC_BYTE                     0x5AU  /* Synchronization byte */
+#define SPI_BATCHED_SYNC_BYTE             0x5BU  /* Synchronization byte requesting the batched ACK mode */
 #define SPI_BUSY_BYTE                     0xA5U  /* Busy byte */
 
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 static volatile uint8_t SpiRxNotEmpty = 0U;
 static uint8_t SpiDetected = 0U;
+static uint8_t SpiBatchedAck = 0U;
 
 /* Exported variables --------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
 static void OPENBL_SPI_Init(void);
+static void OPENBL_SPI_AcknowledgeProcedure(uint8_t Byte);
+static void OPENBL_SPI_SendSpecialReport(uint8_t *pBuffer, uint32_t Length);
 #if defined (__ICCARM__)
 __ramfunc void OPENBL_SPI_ClearFlag_OVR(void);
 #else
@@ -78,6 +83,53 @@ static void OPENBL_SPI_Init(void)
   LL_SPI_Enable(SPIx);
 }
 
+/**
+  * @brief  This function is used to run the acknowledge procedure described in AN4286.
+  * @param  Byte The acknowledge byte to be sent.
+  * @retval None.
+  */
+static void OPENBL_SPI_AcknowledgeProcedure(uint8_t Byte)
+{
+  /* Check the AN4286 for the acknowledge procedure */
+  if (Byte == ACK_BYTE)
+  {
+    /* Send dummy byte */
+    OPENBL_SPI_SendByte(SPI_DUMMY_BYTE);
+  }
+
+  OPENBL_SPI_SendByte(Byte);
+
+  /* Wait for the host to send ACK synchronization byte */
+  while (OPENBL_SPI_ReadByte() != ACK_BYTE)
+  {}
+}
+
+/**
+ * @brief  This function is used to send the answer of a special command: the data size,
+ *         the data then a NULL status size.
+ * @param  pBuffer Pointer to the data of the answer.
+ * @param  Length Size of the data.
+ * @retval None.
+ */
+static void OPENBL_SPI_SendSpecialReport(uint8_t *pBuffer, uint32_t Length)
+{
+  uint32_t index;
+
+  /* Send data size */
+  OPENBL_SPI_SendByte((uint8_t)(Length >> 8));
+  OPENBL_SPI_SendByte((uint8_t)(Length & 0xFFU));
+
+  /* Send data */
+  for (index = 0U; index < Length; index++)
+  {
+    OPENBL_SPI_SendByte(pBuffer[index]);
+  }
+
+  /* Send NULL status size */
+  OPENBL_SPI_SendByte(0x00U);
+  OPENBL_SPI_SendByte(0x00U);
+}
+
 /* Exported functions --------------------------------------------------------*/
 
 /**
@@ -154,14 +206,28 @@ void OPENBL_SPI_DeInit(void)
  */
 uint8_t OPENBL_SPI_ProtocolDetection(void)
 {
+  uint8_t data;
+
   /* Check if there is any activity on SPI */
   if (LL_SPI_IsActiveFlag_RXNE(SPIx) != 0)
   {
+    data = LL_SPI_ReceiveData8(SPIx);
+
     /* Check that Synchronization byte has been received on SPI */
-    if (LL_SPI_ReceiveData8(SPIx) == SPI_SYNC_BYTE)
+    if ((data == SPI_SYNC_BYTE) || (data == SPI_BATCHED_SYNC_BYTE))
     {
       SpiDetected = 1U;
 
+      /* The host selects the batched ACK mode through the synchronization byte */
+      if (data == SPI_BATCHED_SYNC_BYTE)
+      {
+        SpiBatchedAck = 1U;
+      }
+      else
+      {
+        SpiBatchedAck = 0U;
+      }
+
       /* Enable the interrupt of Rx not empty buffer */
       LL_SPI_EnableIT_RXNE(SPIx);
 
@@ -169,7 +235,7 @@ uint8_t OPENBL_SPI_ProtocolDetection(void)
       OPENBL_SPI_SendByte(SYNC_BYTE);
 
       /* Send acknowledgment */
-      OPENBL_SPI_SendAcknowledgeByte(ACK_BYTE);
+      OPENBL_SPI_SendStatusByte(ACK_BYTE);
     }
     else
     {
@@ -240,6 +306,66 @@ __attribute__((section(".ramfunc"))) uint8_t OPENBL_SPI_ReadByte(void)
   return data;
 }
 
+/**
+  * @brief  This function is used to read a block of bytes from SPI pipe.
+  * @note   The frames stay 8-bit on the line. While at least four frames are in the RxFIFO
+  *         they are read at once with a packed 32-bit access of RXDR, the remaining frames
+  *         are read one by one. The block is polled, the Rx not empty interrupt is only
+  *         enabled again at its end.
+  * @param  Buffer The buffer where the received bytes are stored.
+  * @param  BufferSize The number of bytes to be received.
+  * @retval None.
+  */
+#if defined (__ICCARM__)
+__ramfunc void OPENBL_SPI_ReadBytes(uint8_t *Buffer, uint32_t BufferSize)
+#else
+__attribute__((section(".ramfunc"))) void OPENBL_SPI_ReadBytes(uint8_t *Buffer, uint32_t BufferSize)
+#endif /* (__ICCARM__) */
+{
+  uint32_t index = 0U;
+  uint32_t data;
+
+  /* Disable the interrupt of Rx not empty buffer, a pending frame stays in the RxFIFO */
+  SPIx->IER &= ~SPI_IER_RXPIE;
+  SpiRxNotEmpty = 0U;
+
+  while ((BufferSize - index) >= 4U)
+  {
+    /* Wait until at least four frames are received */
+    while ((SPIx->SR & SPI_SR_RXWNE) == 0U)
+    {
+      /* Refresh IWDG: reload counter */
+      IWDG->KR = IWDG_KEY_RELOAD;
+    }
+
+    /* The first received frame is in the least significant byte */
+    data = SPIx->RXDR;
+
+    Buffer[index]      = (uint8_t)(data & 0xFFU);
+    Buffer[index + 1U] = (uint8_t)((data >> 8) & 0xFFU);
+    Buffer[index + 2U] = (uint8_t)((data >> 16) & 0xFFU);
+    Buffer[index + 3U] = (uint8_t)(data >> 24);
+
+    index += 4U;
+  }
+
+  while (index < BufferSize)
+  {
+    while ((SPIx->SR & SPI_SR_RXP) == 0U)
+    {
+      /* Refresh IWDG: reload counter */
+      IWDG->KR = IWDG_KEY_RELOAD;
+    }
+
+    Buffer[index] = *((__IO uint8_t *)&SPIx->RXDR);
+
+    index++;
+  }
+
+  /* Enable the interrupt of Rx not empty buffer */
+  SPIx->IER |= SPI_IER_RXPIE;
+}
+
 /**
   * @brief  This function is used to send one busy byte each receive interrupt through SPI pipe.
   *         Read operation is synchronized on SPI Rx buffer not empty interrupt.
@@ -271,6 +397,24 @@ __attribute__((section(".ramfunc"))) void OPENBL_SPI_SendBusyByte(void)
   SPIx->IER |= SPI_IER_RXPIE;
 }
 
+/**
+  * @brief  This function is used to answer the host polling during a flash operation.
+  * @note   The busy byte is only sent when the host has clocked a byte, so that the
+  *         function never waits for the host.
+  * @retval None.
+  */
+#if defined (__ICCARM__)
+__ramfunc void OPENBL_SPI_SendBusyState(void)
+#else
+__attribute__((section(".ramfunc"))) void OPENBL_SPI_SendBusyState(void)
+#endif /* (__ICCARM__) */
+{
+  if (SpiRxNotEmpty != 0U)
+  {
+    OPENBL_SPI_SendBusyByte();
+  }
+}
+
 /**
   * @brief  This function is used to send one byte through SPI pipe.
   * @retval None.
@@ -294,22 +438,30 @@ __attribute__((section(".ramfunc"))) void OPENBL_SPI_SendByte(uint8_t Byte)
 
 /**
   * @brief  This function is used to send acknowledge byte through SPI pipe.
+  * @note   In batched ACK mode the intermediate ACKs are merged into the command status,
+  *         so only NACKs are sent. The host monitors MISO while it clocks the command frame
+  *         and aborts it as soon as a NACK is seen.
+  * @param  Byte The acknowledge byte to be sent.
   * @retval None.
   */
 void OPENBL_SPI_SendAcknowledgeByte(uint8_t Byte)
 {
-  /* Check the AN4286 for the acknowledge procedure */
-  if (Byte == ACK_BYTE)
+  if ((SpiBatchedAck == 0U) || (Byte != ACK_BYTE))
   {
-    /* Send dummy byte */
-    OPENBL_SPI_SendByte(SPI_DUMMY_BYTE);
+    OPENBL_SPI_AcknowledgeProcedure(Byte);
   }
+}
 
-  OPENBL_SPI_SendByte(Byte);
-
-  /* Wait for the host to send ACK synchronization byte */
-  while (OPENBL_SPI_ReadByte() != ACK_BYTE)
-  {}
+/**
+  * @brief  This function is used to send the status byte of a command through SPI pipe.
+  * @note   The status is exchanged in both ACK modes. It is the only acknowledge
+  *         of a command frame when the batched ACK mode is selected.
+  * @param  Byte The status byte to be sent.
+  * @retval None.
+  */
+void OPENBL_SPI_SendStatusByte(uint8_t Byte)
+{
+  OPENBL_SPI_AcknowledgeProcedure(Byte);
 }
 
 /**
@@ -383,12 +535,89 @@ __attribute__((section(".ramfunc"))) void OPENBL_SPI_ClearFlag_OVR(void)
  */
 void OPENBL_SPI_SpecialCommandProcess(OPENBL_SpecialCmdTypeDef *SpecialCmd)
 {
-  switch (SpecialCmd->OpCode)
+  uint8_t a_report[COMMON_RAM_USAGE_MAX_SIZE];
+  uint32_t length;
+  uint32_t index;
+
+  /* Only the extent data has an extended form, the other extended commands are rejected */
+  if (SpecialCmd->CmdType != OPENBL_SPECIAL_CMD)
   {
-    /* Unknown command opcode */
-    default:
-      if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
+    if (SpecialCmd->OpCode == SPECIAL_CMD_EXTENT_DATA)
+    {
+      length = Common_WriteExtentData(a_report, SpecialCmd->Buffer2, SpecialCmd->SizeBuffer2);
+
+      /* Send status size */
+      OPENBL_SPI_SendByte((uint8_t)(length >> 8));
+      OPENBL_SPI_SendByte((uint8_t)(length & 0xFFU));
+
+      /* Send status */
+      for (index = 0U; index < length; index++)
       {
+        OPENBL_SPI_SendByte(a_report[index]);
+      }
+    }
+    else
+    {
+      /* Send NULL status size */
+      OPENBL_SPI_SendByte(0x00U);
+      OPENBL_SPI_SendByte(0x00U);
+    }
+  }
+  else
+  {
+    switch (SpecialCmd->OpCode)
+    {
+      /* Report the stack and RAM buffer high-water marks */
+      case SPECIAL_CMD_GET_RAM_USAGE:
+        length = OPENBL_SPI_GetRamUsage(a_report);
+
+        OPENBL_SPI_SendSpecialReport(a_report, length);
+        break;
+
+      /* Erase a FLASH bank by slices, the other memories can be read between two requests */
+      case SPECIAL_CMD_SUSPENDABLE_ERASE:
+        length = Common_SuspendableErase(a_report, SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1);
+
+        OPENBL_SPI_SendSpecialReport(a_report, length);
+        break;
+
+      /* Report the measured durations of the flash operations to tune the host timeouts */
+      case SPECIAL_CMD_GET_FLASH_TIMING:
+        length = Common_GetFlashTiming(a_report);
+
+        OPENBL_SPI_SendSpecialReport(a_report, length);
+        break;
+
+      /* Report the link error statistics and the recommended frame size */
+      case SPECIAL_CMD_GET_LINK_STATUS:
+        length = Common_GetLinkStatus(a_report);
+
+        OPENBL_SPI_SendSpecialReport(a_report, length);
+        break;
+
+      /* Store the metadata of the image programmed during this session */
+      case SPECIAL_CMD_SET_IMAGE_METADATA:
+        length = Common_SetImageMetadata(a_report, SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1);
+
+        OPENBL_SPI_SendSpecialReport(a_report, length);
+        break;
+
+      /* Compare the stored image metadata with the host one to skip a redundant programming */
+      case SPECIAL_CMD_CHECK_IMAGE_METADATA:
+        length = Common_CheckImageMetadata(a_report, SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1);
+
+        OPENBL_SPI_SendSpecialReport(a_report, length);
+        break;
+
+      /* Erase the pages touched by an extent table and open a sparse upload session */
+      case SPECIAL_CMD_START_EXTENTS:
+        length = Common_StartExtents(a_report, SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1);
+
+        OPENBL_SPI_SendSpecialReport(a_report, length);
+        break;
+
+      /* Unknown command opcode, the extent data is only an extended command */
+      default:
         /* Send NULL data size */
         OPENBL_SPI_SendByte(0x00U);
         OPENBL_SPI_SendByte(0x00U);
@@ -396,13 +625,7 @@ void OPENBL_SPI_SpecialCommandProcess(OPENBL_SpecialCmdTypeDef *SpecialCmd)
         /* Send NULL status size */
         OPENBL_SPI_SendByte(0x00U);
         OPENBL_SPI_SendByte(0x00U);
-      }
-      else if (SpecialCmd->CmdType == OPENBL_EXTENDED_SPECIAL_CMD)
-      {
-        /* Send NULL status size */
-        OPENBL_SPI_SendByte(0x00U);
-        OPENBL_SPI_SendByte(0x00U);
-      }
-      break;
+        break;
+    }
   }
 }
@@ -26,13 +26,24 @@
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
+#define USART_ADDRESS_MARK                0x100U  /* Ninth bit of the address characters in RS-485 mode */
+#define USART_NODE_SELECTED               0x0U    /* The node is addressed, it answers the host */
+#define USART_NODE_BROADCAST              0x1U    /* All the nodes are addressed, they do not answer */
+#define USART_NODE_UNSELECTED             0x2U    /* Another node is addressed, the traffic is skipped */
+#define USART_NO_PENDING_BYTE             0xFFFFU /* No character was set aside while answering the polling */
+
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 static uint8_t UsartDetected = 0U;
+static uint8_t UsartNodeSelection = USART_NODE_SELECTED;
+static uint16_t UsartPendingByte = USART_NO_PENDING_BYTE;
 
 /* Exported variables --------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
 static void OPENBL_USART_Init(void);
+OPENBL_HOT_PATH static void OPENBL_USART_SelectNode(uint8_t Address);
+static uint8_t OPENBL_USART_ReadCommandByte(void);
+static void OPENBL_USART_SendSpecialReport(uint8_t *pBuffer, uint32_t Length);
 
 /* Private functions ---------------------------------------------------------*/
 
@@ -53,6 +64,25 @@ static void OPENBL_USART_Init(void)
   USART_InitStruct.TransferDirection   = LL_USART_DIRECTION_TX_RX;
   USART_InitStruct.OverSampling        = LL_USART_OVERSAMPLING_16;
 
+  if (USARTx_RS485_MODE != 0U)
+  {
+    /* The ninth bit carries the address mark, so the parity is not used */
+    USART_InitStruct.Parity = LL_USART_PARITY_NONE;
+
+    /* The transceiver is driven by the DE pin only while a frame is transmitted */
+    LL_USART_EnableDEMode(USARTx);
+    LL_USART_SetDESignalPolarity(USARTx, LL_USART_DE_POLARITY_HIGH);
+    LL_USART_SetDEAssertionTime(USARTx, USARTx_DE_TIME);
+    LL_USART_SetDEDeassertionTime(USARTx, USARTx_DE_TIME);
+
+    /* Stay silent until the host addresses this node */
+    UsartNodeSelection = USART_NODE_BROADCAST;
+  }
+
+  /* Block transfers end on the receiver timeout when the host stalls */
+  LL_USART_SetRxTimeout(USARTx, USARTx_RX_TIMEOUT);
+  LL_USART_EnableRxTimeout(USARTx);
+
   if (IS_USART_AUTOBAUDRATE_DETECTION_INSTANCE(USARTx))
   {
     LL_USART_EnableAutoBaudRate(USARTx);
@@ -68,6 +98,90 @@ static void OPENBL_USART_Init(void)
   LL_USART_Enable(USARTx);
 }
 
+/**
+ * @brief  This function is used to update the node selection on a RS-485 address character.
+ * @param  Address The address carried by the character.
+ * @retval None.
+ */
+OPENBL_HOT_PATH static void OPENBL_USART_SelectNode(uint8_t Address)
+{
+  if (Address == USARTx_NODE_ADDRESS)
+  {
+    UsartNodeSelection = USART_NODE_SELECTED;
+  }
+  else if (Address == USARTx_BROADCAST_ADDRESS)
+  {
+    UsartNodeSelection = USART_NODE_BROADCAST;
+  }
+  else
+  {
+    UsartNodeSelection = USART_NODE_UNSELECTED;
+  }
+}
+
+/**
+ * @brief  This function is used to read the first byte of a command in RS-485 mode.
+ * @note   The address characters select the nodes that process the next commands,
+ *         the commands addressed to the other nodes are skipped with their payload.
+ * @retval Returns the read byte.
+ */
+static uint8_t OPENBL_USART_ReadCommandByte(void)
+{
+  uint16_t character;
+
+  do
+  {
+    /* A character received while answering the polling comes first */
+    if (UsartPendingByte != USART_NO_PENDING_BYTE)
+    {
+      character        = UsartPendingByte;
+      UsartPendingByte = USART_NO_PENDING_BYTE;
+    }
+    else
+    {
+      while (!LL_USART_IsActiveFlag_RXNE_RXFNE(USARTx))
+      {
+        OPENBL_IWDG_Refresh();
+      }
+
+      character = LL_USART_ReceiveData9(USARTx);
+    }
+
+    if ((character & USART_ADDRESS_MARK) != 0U)
+    {
+      OPENBL_USART_SelectNode((uint8_t)character);
+    }
+  } while (((character & USART_ADDRESS_MARK) != 0U) || (UsartNodeSelection == USART_NODE_UNSELECTED));
+
+  return (uint8_t)character;
+}
+
+/**
+ * @brief  This function is used to send the answer of a special command: the data size,
+ *         the data then a NULL status size.
+ * @param  pBuffer Pointer to the data of the answer.
+ * @param  Length Size of the data.
+ * @retval None.
+ */
+static void OPENBL_USART_SendSpecialReport(uint8_t *pBuffer, uint32_t Length)
+{
+  uint32_t index;
+
+  /* Send data size */
+  OPENBL_USART_SendByte((uint8_t)(Length >> 8));
+  OPENBL_USART_SendByte((uint8_t)(Length & 0xFFU));
+
+  /* Send data */
+  for (index = 0U; index < Length; index++)
+  {
+    OPENBL_USART_SendByte(pBuffer[index]);
+  }
+
+  /* Send NULL status size */
+  OPENBL_USART_SendByte(0x00U);
+  OPENBL_USART_SendByte(0x00U);
+}
+
 /* Exported functions --------------------------------------------------------*/
 
 /**
@@ -85,6 +199,18 @@ void OPENBL_USART_Configuration(void)
   /* Enable USART clock */
   __HAL_RCC_USART1_CLK_ENABLE();
 
+  /* Enable the DMA clock used by the block transfers */
+  USARTx_DMA_CLK_ENABLE();
+
+  /* USART reception DMA channel: RDR to the block buffer, one byte per request */
+  LL_DMA_SetPeriphRequest(USARTx_DMA, USARTx_DMA_CHANNEL, USARTx_DMA_REQUEST);
+  LL_DMA_SetDataTransferDirection(USARTx_DMA, USARTx_DMA_CHANNEL, LL_DMA_DIRECTION_PERIPH_TO_MEMORY);
+  LL_DMA_SetSrcIncMode(USARTx_DMA, USARTx_DMA_CHANNEL, LL_DMA_SRC_FIXED);
+  LL_DMA_SetDestIncMode(USARTx_DMA, USARTx_DMA_CHANNEL, LL_DMA_DEST_INCREMENT);
+  LL_DMA_SetSrcDataWidth(USARTx_DMA, USARTx_DMA_CHANNEL, LL_DMA_SRC_DATAWIDTH_BYTE);
+  LL_DMA_SetDestDataWidth(USARTx_DMA, USARTx_DMA_CHANNEL, LL_DMA_DEST_DATAWIDTH_BYTE);
+  LL_DMA_SetSrcAddress(USARTx_DMA, USARTx_DMA_CHANNEL, (uint32_t)&USARTx->RDR);
+
   /* USARTx pins configuration -----------------------------------------------*/
 
   GPIO_InitStruct.Pin       = USARTx_TX_PIN;
@@ -97,6 +223,13 @@ void OPENBL_USART_Configuration(void)
   GPIO_InitStruct.Pin = USARTx_RX_PIN;
   HAL_GPIO_Init(USARTx_RX_GPIO_PORT, &GPIO_InitStruct);
 
+  if (USARTx_RS485_MODE != 0U)
+  {
+    GPIO_InitStruct.Pin  = USARTx_DE_PIN;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+    HAL_GPIO_Init(USARTx_DE_GPIO_PORT, &GPIO_InitStruct);
+  }
+
   OPENBL_USART_Init();
 }
 
@@ -149,7 +282,14 @@ uint8_t OPENBL_USART_GetCommandOpcode(void)
   uint8_t command_opc = 0x0;
 
   /* Get the command opcode */
-  command_opc = OPENBL_USART_ReadByte();
+  if (USARTx_RS485_MODE != 0U)
+  {
+    command_opc = OPENBL_USART_ReadCommandByte();
+  }
+  else
+  {
+    command_opc = OPENBL_USART_ReadByte();
+  }
 
   /* Check the data integrity */
   if ((command_opc ^ OPENBL_USART_ReadByte()) != 0xFF)
@@ -164,27 +304,164 @@ uint8_t OPENBL_USART_GetCommandOpcode(void)
   * @brief  This function is used to read one byte from USART pipe.
   * @retval Returns the read byte.
   */
-uint8_t OPENBL_USART_ReadByte(void)
+OPENBL_HOT_PATH uint8_t OPENBL_USART_ReadByte(void)
 {
-  while (!LL_USART_IsActiveFlag_RXNE_RXFNE(USARTx))
+  uint8_t byte;
+
+  /* A byte received while answering the polling comes first */
+  if (UsartPendingByte != USART_NO_PENDING_BYTE)
+  {
+    byte             = (uint8_t)UsartPendingByte;
+    UsartPendingByte = USART_NO_PENDING_BYTE;
+  }
+  else
+  {
+    while (!LL_USART_IsActiveFlag_RXNE_RXFNE(USARTx))
+    {
+      /* Refresh IWDG: reload counter */
+      IWDG->KR = IWDG_KEY_RELOAD;
+    }
+
+    byte = LL_USART_ReceiveData8(USARTx);
+  }
+
+  return byte;
+}
+
+/**
+  * @brief  This function is used to receive a block of bytes through USART pipe.
+  * @note   The bytes are moved by DMA. The block is aborted as soon as the line stays idle
+  *         longer than the receiver timeout, so a lost byte is reported within one character
+  *         time instead of ending in a watchdog reset.
+  * @param  Buffer The buffer where the received bytes are stored.
+  * @param  BufferSize The number of bytes to be received.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: The whole block is received
+  *          - ERROR:   The host stalled before the end of the block
+  */
+ErrorStatus OPENBL_USART_ReadBytes(uint8_t *Buffer, uint32_t BufferSize)
+{
+  ErrorStatus status = SUCCESS;
+
+  LL_USART_ClearFlag_RTO(USARTx);
+
+  LL_DMA_SetDestAddress(USARTx_DMA, USARTx_DMA_CHANNEL, (uint32_t)Buffer);
+  LL_DMA_SetBlkDataLength(USARTx_DMA, USARTx_DMA_CHANNEL, BufferSize);
+  LL_DMA_EnableChannel(USARTx_DMA, USARTx_DMA_CHANNEL);
+  LL_USART_EnableDMAReq_RX(USARTx);
+
+  while ((LL_DMA_IsActiveFlag_TC(USARTx_DMA, USARTx_DMA_CHANNEL) == 0U) && (status == SUCCESS))
   {
     OPENBL_IWDG_Refresh();
+
+    /* The last byte may have been received since the transfer complete check */
+    if ((LL_USART_IsActiveFlag_RTO(USARTx) != 0U)
+        && (LL_DMA_IsActiveFlag_TC(USARTx_DMA, USARTx_DMA_CHANNEL) == 0U))
+    {
+      status = ERROR;
+    }
+  }
+
+  LL_USART_DisableDMAReq_RX(USARTx);
+
+  if (status == ERROR)
+  {
+    /* Abort the partial block */
+    LL_DMA_SuspendChannel(USARTx_DMA, USARTx_DMA_CHANNEL);
+
+    while (LL_DMA_IsActiveFlag_SUSP(USARTx_DMA, USARTx_DMA_CHANNEL) == 0U)
+    {
+    }
+
+    LL_DMA_ResetChannel(USARTx_DMA, USARTx_DMA_CHANNEL);
+    LL_DMA_ClearFlag_SUSP(USARTx_DMA, USARTx_DMA_CHANNEL);
   }
 
-  return LL_USART_ReceiveData8(USARTx);
+  LL_DMA_ClearFlag_TC(USARTx_DMA, USARTx_DMA_CHANNEL);
+  LL_USART_ClearFlag_RTO(USARTx);
+
+  return status;
 }
 
 /**
   * @brief  This function is used to send one byte through USART pipe.
+  * @note   In RS-485 mode the nodes do not answer the broadcast commands, the acknowledges
+  *         are recorded instead and reported by the SPECIAL_CMD_GET_NODE_STATUS command.
   * @param  Byte The byte to be sent.
   * @retval None.
   */
-void OPENBL_USART_SendByte(uint8_t Byte)
+OPENBL_HOT_PATH void OPENBL_USART_SendByte(uint8_t Byte)
 {
-  LL_USART_TransmitData8(USARTx, (Byte & 0xFF));
+  if (UsartNodeSelection == USART_NODE_SELECTED)
+  {
+    LL_USART_TransmitData8(USARTx, (Byte & 0xFF));
 
-  while (!LL_USART_IsActiveFlag_TC(USARTx))
+    while (!LL_USART_IsActiveFlag_TC(USARTx))
+    {
+    }
+  }
+  else
   {
+    Common_RecordBroadcastByte(Byte);
+  }
+}
+
+/**
+  * @brief  This function is used to answer the host polling during a flash operation.
+  * @note   The host polls by sending COMMON_BUSY_POLL_BYTE, it is answered with the busy frame.
+  *         In RS-485 mode, the host can also poll a node by its address during a broadcast
+  *         command: the addressed node answers and the node selection of the running command
+  *         is restored. Any other byte starts the next command, it is set aside for the next
+  *         read and the following bytes are left in the receiver. The function returns
+  *         immediately when no poll byte is pending.
+  * @retval None.
+  */
+OPENBL_HOT_PATH void OPENBL_USART_SendBusyState(void)
+{
+  uint32_t index;
+  uint32_t length;
+  uint16_t character;
+  uint8_t selection;
+  uint8_t busy_frame[COMMON_BUSY_FRAME_SIZE];
+
+  if ((UsartPendingByte == USART_NO_PENDING_BYTE) && LL_USART_IsActiveFlag_RXNE_RXFNE(USARTx))
+  {
+    selection = UsartNodeSelection;
+
+    if (USARTx_RS485_MODE != 0U)
+    {
+      character = LL_USART_ReceiveData9(USARTx);
+    }
+    else
+    {
+      character = LL_USART_ReceiveData8(USARTx);
+    }
+
+    if ((character & USART_ADDRESS_MARK) != 0U)
+    {
+      /* The address poll selects the node for the busy frame only */
+      OPENBL_USART_SelectNode((uint8_t)character);
+    }
+    else if (character != COMMON_BUSY_POLL_BYTE)
+    {
+      UsartPendingByte = character;
+    }
+    else
+    {
+      /* Poll byte of the selected node */
+    }
+
+    if ((UsartNodeSelection == USART_NODE_SELECTED) && (UsartPendingByte == USART_NO_PENDING_BYTE))
+    {
+      length = Common_SetBusyFrame(busy_frame);
+
+      for (index = 0U; index < length; index++)
+      {
+        OPENBL_USART_SendByte(busy_frame[index]);
+      }
+    }
+
+    UsartNodeSelection = selection;
   }
 }
 
@@ -196,12 +473,96 @@ void OPENBL_USART_SendByte(uint8_t Byte)
  */
 void OPENBL_USART_SpecialCommandProcess(OPENBL_SpecialCmdTypeDef *SpecialCmd)
 {
-  switch (SpecialCmd->OpCode)
+  uint8_t a_report[COMMON_RAM_USAGE_MAX_SIZE];
+  uint32_t length;
+  uint32_t index;
+
+  /* Only the extent data has an extended form, the other extended commands are rejected */
+  if (SpecialCmd->CmdType != OPENBL_SPECIAL_CMD)
   {
-    /* Unknown command opcode */
-    default:
-      if (SpecialCmd->CmdType == OPENBL_SPECIAL_CMD)
+    if (SpecialCmd->OpCode == SPECIAL_CMD_EXTENT_DATA)
+    {
+      length = Common_WriteExtentData(a_report, SpecialCmd->Buffer2, SpecialCmd->SizeBuffer2);
+
+      /* Send status size */
+      OPENBL_USART_SendByte((uint8_t)(length >> 8));
+      OPENBL_USART_SendByte((uint8_t)(length & 0xFFU));
+
+      /* Send status */
+      for (index = 0U; index < length; index++)
       {
+        OPENBL_USART_SendByte(a_report[index]);
+      }
+    }
+    else
+    {
+      /* Send NULL status size */
+      OPENBL_USART_SendByte(0x00U);
+      OPENBL_USART_SendByte(0x00U);
+    }
+  }
+  else
+  {
+    switch (SpecialCmd->OpCode)
+    {
+      /* Report the stack and RAM buffer high-water marks */
+      case SPECIAL_CMD_GET_RAM_USAGE:
+        length = OPENBL_USART_GetRamUsage(a_report);
+
+        OPENBL_USART_SendSpecialReport(a_report, length);
+        break;
+
+      /* Erase a FLASH bank by slices, the other memories can be read between two requests */
+      case SPECIAL_CMD_SUSPENDABLE_ERASE:
+        length = Common_SuspendableErase(a_report, SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1);
+
+        OPENBL_USART_SendSpecialReport(a_report, length);
+        break;
+
+      /* Report the outcome of the broadcast commands */
+      case SPECIAL_CMD_GET_NODE_STATUS:
+        length = Common_GetBroadcastStatus(a_report);
+
+        OPENBL_USART_SendSpecialReport(a_report, length);
+        break;
+
+      /* Report the measured durations of the flash operations to tune the host timeouts */
+      case SPECIAL_CMD_GET_FLASH_TIMING:
+        length = Common_GetFlashTiming(a_report);
+
+        OPENBL_USART_SendSpecialReport(a_report, length);
+        break;
+
+      /* Report the link error statistics and the recommended frame size */
+      case SPECIAL_CMD_GET_LINK_STATUS:
+        length = Common_GetLinkStatus(a_report);
+
+        OPENBL_USART_SendSpecialReport(a_report, length);
+        break;
+
+      /* Store the metadata of the image programmed during this session */
+      case SPECIAL_CMD_SET_IMAGE_METADATA:
+        length = Common_SetImageMetadata(a_report, SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1);
+
+        OPENBL_USART_SendSpecialReport(a_report, length);
+        break;
+
+      /* Compare the stored image metadata with the host one to skip a redundant programming */
+      case SPECIAL_CMD_CHECK_IMAGE_METADATA:
+        length = Common_CheckImageMetadata(a_report, SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1);
+
+        OPENBL_USART_SendSpecialReport(a_report, length);
+        break;
+
+      /* Erase the pages touched by an extent table and open a sparse upload session */
+      case SPECIAL_CMD_START_EXTENTS:
+        length = Common_StartExtents(a_report, SpecialCmd->Buffer1, SpecialCmd->SizeBuffer1);
+
+        OPENBL_USART_SendSpecialReport(a_report, length);
+        break;
+
+      /* Unknown command opcode, the extent data is only an extended command */
+      default:
         /* Send NULL data size */
         OPENBL_USART_SendByte(0x00U);
         OPENBL_USART_SendByte(0x00U);
@@ -209,13 +570,7 @@ void OPENBL_USART_SpecialCommandProcess(OPENBL_SpecialCmdTypeDef *SpecialCmd)
         /* Send NULL status size */
         OPENBL_USART_SendByte(0x00U);
         OPENBL_USART_SendByte(0x00U);
-      }
-      else if (SpecialCmd->CmdType == OPENBL_EXTENDED_SPECIAL_CMD)
-      {
-        /* Send NULL status size */
-        OPENBL_USART_SendByte(0x00U);
-        OPENBL_USART_SendByte(0x00U);
-      }
-      break;
+        break;
+    }
   }
 }
@@ -22,6 +22,7 @@
 #include "app_usbx_device.h"
 #include "app_azure_rtos.h"
 #include "openbl_core.h"
+#include "extnor_interface.h"
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
@@ -107,14 +108,18 @@ uint8_t OPENBL_USB_ProtocolDetection(void)
 
 /**
   * @brief  Gets the page of a given address.
-  * @param  Address Address of the FLASH Memory.
-  * @retval The page of a given address.
+  * @param  Address Address of the FLASH Memory or of the external NOR.
+  * @retval The page of a given address, the 4 KByte sector for the external NOR.
   */
 uint32_t OPENBL_USB_GetPage(uint32_t Address)
 {
   uint32_t page;
 
-  if (Address < (FLASH_BASE + FLASH_BANK_SIZE))
+  if ((Address >= EXTNOR_START_ADDRESS) && (Address < EXTNOR_END_ADDRESS))
+  {
+    page = (Address - EXTNOR_START_ADDRESS) / EXTNOR_SECTOR_SIZE;
+  }
+  else if (Address < (FLASH_BASE + FLASH_BANK_SIZE))
   {
     /* Bank 1 */
     page = (Address - FLASH_BASE) / FLASH_PAGE_SIZE;
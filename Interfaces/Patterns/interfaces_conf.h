@@ -28,8 +28,9 @@ extern "C" {
 #include "stm32u5xx_ll_usart.h"
 #include "stm32u5xx_ll_i2c.h"
 #include "stm32u5xx_ll_spi.h"
+#include "stm32u5xx_ll_dma.h"
 
-#define MEMORIES_SUPPORTED                7U
+#define MEMORIES_SUPPORTED                8U
 
 /* ------------------------- Definitions for USART -------------------------- */
 #define USARTx                            USART3
@@ -44,6 +45,19 @@ extern "C" {
 #define USARTx_RX_GPIO_PORT               GPIOD
 #define USARTx_ALTERNATE                  GPIO_AF7_USART3
 
+#define USARTx_RS485_MODE                 0U     /* 1: RS-485 multi-drop addressed mode, 0: point to point mode */
+#define USARTx_NODE_ADDRESS               0x01U  /* Address of this node on the RS-485 line */
+#define USARTx_BROADCAST_ADDRESS          0xFFU  /* Address accepted by all the nodes, they do not answer */
+#define USARTx_DE_PIN                     GPIO_PIN_12
+#define USARTx_DE_GPIO_PORT               GPIOD
+#define USARTx_DE_TIME                    8U     /* DE assertion and deassertion times in sample time units */
+
+#define USARTx_DMA                        GPDMA1
+#define USARTx_DMA_CLK_ENABLE()           __HAL_RCC_GPDMA1_CLK_ENABLE()
+#define USARTx_DMA_CHANNEL                LL_DMA_CHANNEL_11
+#define USARTx_DMA_REQUEST                LL_GPDMA1_REQUEST_USART3_RX
+#define USARTx_RX_TIMEOUT                 11U    /* Receiver timeout in bit durations, one 8E1 character */
+
 /* ------------------------- Definitions for I2C -------------------------- */
 #define I2Cx                              I2C2
 #define I2Cx_CLK_ENABLE()                 __HAL_RCC_I2C2_CLK_ENABLE()
@@ -59,6 +73,8 @@ extern "C" {
 #define I2C_ADDRESS                       0x000000B4U
 #define OPENBL_I2C_TIMEOUT                0xFFFFF000U
 #define I2C_TIMING                        0x00800000U
+#define I2C_BROADCAST_MODE                0U     /* 1: accept the broadcast write and erase commands */
+#define I2C_GROUP_ADDRESS                 0x00U  /* Broadcast address: 0x00 for the general call, else a shared address */
 
 /* ------------------------- Definitions for FDCAN -------------------------- */
 #define FDCANx                            FDCAN1
@@ -80,6 +96,49 @@ extern "C" {
 #define FDCANx_FORCE_RESET()              __HAL_RCC_FDCAN1_FORCE_RESET()
 #define FDCANx_RELEASE_RESET()            __HAL_RCC_FDCAN1_RELEASE_RESET()
 
+/* -------------------------- Definitions for CAN --------------------------- */
+/* The CAN interface runs the FDCAN instance in classic CAN mode: register either the CAN or the FDCAN interface */
+#define CANx                              FDCANx
+#define CANx_CLK_DISABLE()                FDCANx_CLK_DISABLE()
+#define CANx_GPIO_CLK_ENABLE()            FDCANx_GPIO_CLK_ENABLE()
+#define CANx_CLOCK_FREQ                   20000000U  /* FDCAN kernel clock frequency */
+
+#define CANx_TX_PIN                       FDCANx_TX_PIN
+#define CANx_TX_GPIO_PORT                 FDCANx_TX_GPIO_PORT
+#define CANx_RX_PIN                       FDCANx_RX_PIN
+#define CANx_RX_GPIO_PORT                 FDCANx_RX_GPIO_PORT
+
+#define CANx_IRQn                         FDCANx_IT0_IRQn  /* Both Rx FIFOs interrupts use the line 0 */
+
+#define CANx_FORCE_RESET()                FDCANx_FORCE_RESET()
+#define CANx_RELEASE_RESET()              FDCANx_RELEASE_RESET()
+
+/* ----------------------- Definitions for external NOR --------------------- */
+#define OSPIx                             OCTOSPI1
+#define OSPIx_CLK_ENABLE()                __HAL_RCC_OSPI1_CLK_ENABLE()
+#define OSPIx_CLK_DISABLE()               __HAL_RCC_OSPI1_CLK_DISABLE()
+#define OSPIx_GPIO_CLK_ENABLE()           do { __HAL_RCC_GPIOE_CLK_ENABLE(); __HAL_RCC_GPIOF_CLK_ENABLE(); } while (0)
+#define OSPIx_IRQn                        OCTOSPI1_IRQn
+#define OSPIx_ALTERNATE                   GPIO_AF10_OCTOSPI1
+
+#define OSPIx_DMA_CLK_ENABLE()            __HAL_RCC_GPDMA1_CLK_ENABLE()
+#define OSPIx_DMA_CHANNEL                 GPDMA1_Channel12
+#define OSPIx_DMA_REQUEST                 GPDMA1_REQUEST_OCTOSPI1
+#define OSPIx_DMA_IRQn                    GPDMA1_Channel12_IRQn
+
+#define OSPIx_CLK_PIN                     GPIO_PIN_10
+#define OSPIx_CLK_GPIO_PORT               GPIOF
+#define OSPIx_NCS_PIN                     GPIO_PIN_11
+#define OSPIx_NCS_GPIO_PORT               GPIOE
+#define OSPIx_IO0_PIN                     GPIO_PIN_12
+#define OSPIx_IO0_GPIO_PORT               GPIOE
+#define OSPIx_IO1_PIN                     GPIO_PIN_13
+#define OSPIx_IO1_GPIO_PORT               GPIOE
+#define OSPIx_IO2_PIN                     GPIO_PIN_14
+#define OSPIx_IO2_GPIO_PORT               GPIOE
+#define OSPIx_IO3_PIN                     GPIO_PIN_15
+#define OSPIx_IO3_GPIO_PORT               GPIOE
+
 /* -------------------------- Definitions for SPI --------------------------- */
 #define SPIx                              SPI1
 #define SPIx_CLK_ENABLE()                 __HAL_RCC_SPI1_CLK_ENABLE()
@@ -98,6 +157,17 @@ extern "C" {
 #define SPIx_NSS_PIN_PORT                 GPIOA
 #define SPIx_ALTERNATE                    GPIO_AF5_SPI1
 
+/* --------------------- Definitions for the fast hand-off ------------------ */
+/* Peripherals used by the interfaces above, reset at once on Go when OPENBL_FAST_HANDOFF is set */
+#define HANDOFF_AHB1_PERIPHERALS          RCC_AHB1RSTR_GPDMA1RST
+#define HANDOFF_AHB2_1_PERIPHERALS        (RCC_AHB2RSTR1_GPIOARST | RCC_AHB2RSTR1_GPIOBRST | RCC_AHB2RSTR1_GPIODRST \
+                                           | RCC_AHB2RSTR1_GPIOERST | RCC_AHB2RSTR1_GPIOFRST | RCC_AHB2RSTR1_GPIOHRST \
+                                           | RCC_AHB2RSTR1_OTGRST)
+#define HANDOFF_AHB2_2_PERIPHERALS        RCC_AHB2RSTR2_OCTOSPI1RST
+#define HANDOFF_APB1_1_PERIPHERALS        (RCC_APB1RSTR1_USART3RST | RCC_APB1RSTR1_I2C2RST)
+#define HANDOFF_APB1_2_PERIPHERALS        RCC_APB1RSTR2_FDCAN1RST
+#define HANDOFF_APB2_PERIPHERALS          RCC_APB2RSTR_SPI1RST
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,161 @@
+/**
+  ******************************************************************************
+  * @file    can_interface.c
+  * @author  MCD Application Team
+  * @brief   Contains CAN HW configuration
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "platform.h"
+#include "interfaces_conf.h"
+#include "openbl_core.h"
+#include "openbl_can_cmd.h"
+#include "can_interface.h"
+#include "iwdg_interface.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static uint8_t CanDetected = 0U;
+
+/* Exported variables --------------------------------------------------------*/
+uint8_t tCanRxData[CAN_RAM_BUFFER_SIZE];
+
+/* Private function prototypes -----------------------------------------------*/
+static void OPENBL_CAN_Init(void);
+
+/* Private functions ---------------------------------------------------------*/
+/**
+ * @brief  This function is used to initialize the used CAN instance.
+ * @retval None.
+ */
+static void OPENBL_CAN_Init(void)
+{
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief  This function is used to configure CAN pins and then initialize the used CAN instance.
+ * @retval None.
+ */
+void OPENBL_CAN_Configuration(void)
+{
+}
+
+/**
+ * @brief  This function is used to De-initialize the CAN pins and instance.
+ * @retval None.
+ */
+void OPENBL_CAN_DeInit(void)
+{
+}
+
+/**
+ * @brief  This function is used to detect if there is any activity on CAN protocol.
+ * @retval Returns 1 if interface is detected else 0.
+ */
+uint8_t OPENBL_CAN_ProtocolDetection(void)
+{
+  return CanDetected;
+}
+
+/**
+ * @brief  This function is used to get the command opcode from the host.
+ * @retval Returns the command.
+ */
+uint8_t OPENBL_CAN_GetCommandOpcode(void)
+{
+  uint8_t command_opc = 0x0;
+
+  return command_opc;
+}
+
+/**
+  * @brief  This function is used to read one byte from CAN pipe.
+  * @retval Returns the read byte.
+  */
+uint8_t OPENBL_CAN_ReadByte(void)
+{
+  uint8_t byte;
+
+  return byte;
+}
+
+/**
+  * @brief  This function is used to read bytes from CAN pipe.
+  * @param  Buffer The buffer where the received bytes are stored.
+  * @param  BufferSize The maximum number of bytes to be stored.
+  * @retval None.
+  */
+void OPENBL_CAN_ReadBytes(uint8_t *Buffer, uint32_t BufferSize)
+{
+}
+
+/**
+  * @brief  This function is used to send one byte through CAN pipe.
+  * @param  Byte The byte to be sent.
+  * @retval None.
+  */
+void OPENBL_CAN_SendByte(uint8_t Byte)
+{
+}
+
+/**
+  * @brief  This function is used to send a buffer using CAN.
+  * @param  Buffer The data buffer to be sent.
+  * @param  BufferSize The size of the data buffer to be sent.
+  * @retval None.
+  */
+void OPENBL_CAN_SendBytes(uint8_t *Buffer, uint32_t BufferSize)
+{
+}
+
+/**
+  * @brief  This function is used to answer the host polling during a flash operation.
+  * @retval None.
+  */
+OPENBL_HOT_PATH void OPENBL_CAN_SendBusyState(void)
+{
+}
+
+/**
+  * @brief  This function is used to check if a bus error occurred since its last call.
+  * @note   The CAN controller retransmits the corrupted frames by itself, the last error
+  *         code is the only trace of them. It is marked as read by each call.
+  * @retval Returns SET if a bus error was detected else returns RESET.
+  */
+FlagStatus OPENBL_CAN_GetLinkErrorStatus(void)
+{
+  return RESET;
+}
+
+/**
+  * @brief  This function is used to change the CAN speed.
+  * @param  Speed The index of the new speed in the CAN speed table:
+  *         1: 125 kbps, 2: 250 kbps, 3: 500 kbps, 4: 1 Mbps.
+  * @retval None.
+  */
+void OPENBL_CAN_ChangePrescaler(uint32_t Speed)
+{
+}
+
+/**
+  * @brief  Handle the CAN Rx FIFO 0 and Rx FIFO 1 interrupt requests.
+  * @retval None.
+  */
+void OPENBL_CAN_IRQHandler(void)
+{
+}
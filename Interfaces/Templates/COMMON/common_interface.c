@@ -68,6 +68,17 @@ FlagStatus Common_GetProtectionStatus(void)
   return status;
 }
 
+/**
+  * @brief  Checks whether a part of a memory range is write protected or not.
+  * @param  Address The start address of the range.
+  * @param  Length The length of the range.
+  * @retval Returns SET if a part of the range is write protected else return RESET.
+  */
+FlagStatus Common_GetWriteProtectionStatus(uint32_t Address, uint32_t Length)
+{
+  return RESET;
+}
+
 /**
   * @brief  Register a callback function to be called at the end of commands processing.
   * @retval None.
@@ -84,3 +95,281 @@ void Common_SetPostProcessingCallback(Function_Pointer Callback)
 void Common_StartPostProcessing()
 {
 }
+
+/**
+  * @brief  Start the core cycle counter without resetting it.
+  * @note   Used to time the flash operations, the measures are differences of the counter.
+  * @retval None.
+  */
+void Common_EnableCycleCounter(void)
+{
+}
+
+/**
+  * @brief  Return the number of core cycles elapsed since the cycle counter start.
+  * @retval Returns the cycle counter value.
+  */
+uint32_t Common_GetCycleCounter(void)
+{
+  return 0U;
+}
+
+/**
+  * @brief  Fill the unused part of the main stack with the paint pattern.
+  * @note   Called by OPENBL_Init before the interfaces initialization.
+  * @retval None.
+  */
+void Common_PaintStack(void)
+{
+}
+
+/**
+  * @brief  Fill a RAM buffer with the paint pattern.
+  * @retval None.
+  */
+void Common_PaintBuffer(uint8_t *pBuffer, uint32_t Size)
+{
+}
+
+/**
+  * @brief  Return the high-water mark of the main stack.
+  * @retval Returns the maximum number of stack bytes used since the stack has been painted.
+  */
+uint32_t Common_GetStackUsage(void)
+{
+  return 0U;
+}
+
+/**
+  * @brief  Return the high-water mark of a painted RAM buffer.
+  * @retval Returns the number of bytes from the buffer start up to the last overwritten byte.
+  */
+uint32_t Common_GetBufferUsage(uint8_t *pBuffer, uint32_t Size)
+{
+  return 0U;
+}
+
+/**
+  * @brief  Add the usage of a RAM area to a RAM usage report.
+  * @retval Returns the size of the report entry.
+  */
+uint32_t Common_SetRamUsageEntry(uint8_t *pReport, uint32_t Size, uint32_t Used)
+{
+  return 0U;
+}
+
+/**
+  * @brief  Start or resume a FLASH erase that runs by slices of pages.
+  * @note   A bank option sent MSB first (FLASH_MASS_ERASE, FLASH_BANK1_ERASE or FLASH_BANK2_ERASE) starts a new
+  *         erase, an empty buffer resumes the suspended one. In both cases OPENBL_ERASE_SLICE_PAGES
+  *         pages are erased before the erase is suspended again, so that the host can read the
+  *         other memories between two requests.
+  * @param  pReport Pointer to the report: remaining pages MSB first, then ACK_BYTE or NACK_BYTE.
+  * @param  p_Data Pointer to the request buffer.
+  * @param  DataLength Size of the request buffer.
+  * @retval Returns the size of the report.
+  */
+uint32_t Common_SuspendableErase(uint8_t *pReport, uint8_t *p_Data, uint32_t DataLength)
+{
+  return 0U;
+}
+
+/**
+  * @brief  This function is used to enable the busy state sending during memory operations.
+  * @retval None.
+  */
+void OPENBL_Enable_BusyState_Sending(void)
+{
+}
+
+/**
+  * @brief  This function is used to disable the busy state sending during memory operations.
+  * @retval None.
+  */
+void OPENBL_Disable_BusyState_Sending(void)
+{
+}
+
+/**
+  * @brief  Fill a busy frame with the progress of the current flash request.
+  * @param  pFrame Pointer to the frame: busy byte, then operations done, operations total
+  *         and remaining time in ms, each of them 16-bit MSB first.
+  * @retval Returns the size of the busy frame.
+  */
+OPENBL_HOT_PATH uint32_t Common_SetBusyFrame(uint8_t *pFrame)
+{
+  return 0U;
+}
+
+/**
+  * @brief  Record an acknowledge of a broadcast command instead of sending it.
+  * @param  Byte The byte that would have been sent to the host.
+  * @retval None.
+  */
+OPENBL_HOT_PATH void Common_RecordBroadcastByte(uint8_t Byte)
+{
+}
+
+/**
+  * @brief  Report the outcome of the broadcast commands, the record is cleared once reported.
+  * @param  pReport Pointer to the report: status (ACK or NACK) then the number of
+  *         acknowledges of the broadcast commands, 32-bit MSB first.
+  * @retval Returns the size of the report.
+  */
+uint32_t Common_GetBroadcastStatus(uint8_t *pReport)
+{
+  return 0U;
+}
+
+/**
+  * @brief  Report the running estimates of the flash operations durations.
+  * @note   The estimates start from the datasheet values and are refined by each
+  *         operation, the host uses them to tune its timeouts.
+  * @param  pReport Pointer to the report: page erase, bank erase and quad-word program
+  *         durations in us, each of them 32-bit MSB first.
+  * @retval Returns the size of the report.
+  */
+uint32_t Common_GetFlashTiming(uint8_t *pReport)
+{
+  return 0U;
+}
+
+/**
+  * @brief  Apply the session parameters selected by the host during the handshake.
+  * @note   Each parameter is clamped to what the device supports, a null frame size
+  *         or window depth keeps the current value. The frames are always checked with
+  *         the XOR checksum, the integrity modes of the host are not used.
+  * @param  pSelection Pointer to the selection: frame size 16-bit MSB first, integrity
+  *         modes supported by the host (COMMON_INTEGRITY_xxx) then window depth.
+  * @retval None.
+  */
+void Common_SelectSession(const uint8_t *pSelection)
+{
+}
+
+/**
+  * @brief  Fill the header of the handshake report.
+  * @param  pReport Pointer to the report: protocol version, device ID, maximum frame size,
+  *         integrity modes, maximum window depth, speed options, then the selected frame
+  *         size, integrity mode and window depth. 16-bit fields are sent MSB first.
+  * @param  Version Protocol version of the interface.
+  * @param  SpeedOptions Bitmap of the values accepted by the Speed command, 0 if none.
+  * @retval Returns the size of the header.
+  */
+uint32_t Common_SetHandshakeHeader(uint8_t *pReport, uint8_t Version, uint8_t SpeedOptions)
+{
+  return 0U;
+}
+
+/**
+  * @brief  Get the frame size selected for the session.
+  * @note   With OPENBL_ADAPTIVE_FRAME_SIZE, it is the frame size recommended from the link errors.
+  * @retval Returns the maximum number of data bytes of a read or write frame.
+  */
+uint32_t Common_GetFrameSize(void)
+{
+  return 0U;
+}
+
+/**
+  * @brief  Check that a read or write frame fits in the frame size selected for the session.
+  * @param  Length The number of data bytes of the frame.
+  * @retval Returns 1 if the frame size is accepted else returns 0.
+  */
+uint8_t Common_CheckFrameSize(uint32_t Length)
+{
+  return 0U;
+}
+
+/**
+  * @brief  Record the integrity of a data frame received from the host.
+  * @note   An integrity failure halves the recommended frame size, down to COMMON_FRAME_SIZE_MIN,
+  *         and COMMON_LINK_GROW_FRAMES consecutive valid frames double it, up to the frame
+  *         size selected by the host. A frame received after a failure counts as a retry.
+  * @param  Status ACK_BYTE if the frame is valid, NACK_BYTE if its integrity check failed.
+  * @retval None.
+  */
+void Common_RecordLinkFrame(uint8_t Status)
+{
+}
+
+/**
+  * @brief  Report the link error statistics of the session.
+  * @param  pReport Pointer to the report: received frames, integrity failures and retries,
+  *         each of them 32-bit MSB first, then the recommended frame size 16-bit MSB first.
+  * @retval Returns the size of the report.
+  */
+uint32_t Common_GetLinkStatus(uint8_t *pReport)
+{
+  return 0U;
+}
+
+/**
+  * @brief  Hand the device over to the application without de-initializing each interface.
+  * @note   The peripherals used by the Open Bootloader are reset at once through the RCC
+  *         reset registers and their clocks are stopped. With OPENBL_HANDOFF_KEEP_CLOCKS,
+  *         the PLL and the flash latency stay configured and their state is written in the
+  *         hand-off block so that the application can skip its clock configuration.
+  * @retval None.
+  */
+void Common_FastHandOff(void)
+{
+}
+
+/**
+  * @brief  Store the metadata of the programmed image, at the end of a successful session.
+  * @param  pReport Pointer to the report: ACK or NACK byte.
+  * @param  p_Data Pointer to the metadata: version, build hash, length and CRC32 of the
+  *         image, each of them 32-bit MSB first.
+  * @param  DataLength Size of the metadata buffer.
+  * @retval Returns the size of the report.
+  */
+uint32_t Common_SetImageMetadata(uint8_t *pReport, uint8_t *p_Data, uint32_t DataLength)
+{
+  return 0U;
+}
+
+/**
+  * @brief  Compare the stored image metadata with the host one, to skip a redundant programming.
+  * @param  pReport Pointer to the report: ACK if the metadata match else NACK, then the
+  *         stored version, build hash, length and CRC32, each of them 32-bit MSB first.
+  * @param  p_Data Pointer to the host metadata, as for Common_SetImageMetadata, optionally
+  *         followed by an options byte. With COMMON_METADATA_CONFIRM_CRC, a match is
+  *         confirmed by the CRC32 of the image in FLASH.
+  * @param  DataLength Size of the request buffer.
+  * @retval Returns the size of the report.
+  */
+uint32_t Common_CheckImageMetadata(uint8_t *pReport, uint8_t *p_Data, uint32_t DataLength)
+{
+  return 0U;
+}
+
+/**
+  * @brief  Open a sparse upload session from the extent table of the image.
+  * @note   Each FLASH page touched by the extents is erased once, the data of the
+  *         extents is then received by Common_WriteExtentData without any address.
+  * @param  pReport Pointer to the report: ACK or NACK byte then number of erased pages 16-bit MSB first.
+  * @param  p_Data Pointer to the extent table: address then length of each extent, each of them
+  *         32-bit MSB first. The extents are in FLASH, sorted by address and do not overlap.
+  * @param  DataLength Size of the extent table.
+  * @retval Returns the size of the report.
+  */
+uint32_t Common_StartExtents(uint8_t *pReport, uint8_t *p_Data, uint32_t DataLength)
+{
+  return 0U;
+}
+
+/**
+  * @brief  Write the next data of the sparse upload session.
+  * @note   The data follow the order of the extents and a buffer can span several of them.
+  *         The write cache is flushed once the last extent is complete.
+  * @param  pReport Pointer to the report: ACK or NACK byte then number of bytes still
+  *         expected, 32-bit MSB first.
+  * @param  p_Data Pointer to the data.
+  * @param  DataLength Size of the data.
+  * @retval Returns the size of the report.
+  */
+uint32_t Common_WriteExtentData(uint8_t *pReport, uint8_t *p_Data, uint32_t DataLength)
+{
+  return 0U;
+}
@@ -0,0 +1,123 @@
+/**
+  ******************************************************************************
+  * @file    extnor_interface.c
+  * @author  MCD Application Team
+  * @brief   Contains external serial NOR access functions through OCTOSPI
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "platform.h"
+#include "interfaces_conf.h"
+#include "openbl_mem.h"
+#include "iwdg_interface.h"
+#include "extnor_interface.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Exported variables --------------------------------------------------------*/
+OPENBL_MemoryTypeDef EXTNOR_Descriptor =
+{
+  EXTNOR_START_ADDRESS,
+  EXTNOR_END_ADDRESS,
+  EXTNOR_BL_SIZE,
+  EXTNOR_AREA,
+  OPENBL_EXTNOR_Read,
+  OPENBL_EXTNOR_Write,
+  NULL,
+  NULL,
+  NULL,
+  OPENBL_EXTNOR_MassErase,
+  OPENBL_EXTNOR_Erase
+};
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  This function is used to configure the OCTOSPI pins, its DMA and the external NOR.
+  * @retval None.
+  */
+void OPENBL_EXTNOR_Configuration(void)
+{
+}
+
+/**
+  * @brief  This function is used to read data from a given address.
+  * @param  Address The address to be read.
+  * @retval Returns the read value.
+  */
+uint8_t OPENBL_EXTNOR_Read(uint32_t Address)
+{
+  return (*(uint8_t *)(Address));
+}
+
+/**
+  * @brief  This function is used to write data in the external NOR.
+  * @param  Address The address where that data will be written.
+  * @param  Data The data to be written.
+  * @param  DataLength The length of the data to be written.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: Write operation done
+  *          - ERROR:   Write operation failed
+  */
+ErrorStatus OPENBL_EXTNOR_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength)
+{
+  ErrorStatus status = SUCCESS;
+
+  return status;
+}
+
+/**
+  * @brief  This function is used to erase the whole external NOR.
+  * @param  *p_Data Pointer to the buffer that contains mass erase operation options.
+  * @param  DataLength Size of the Data buffer.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: Mass erase operation done
+  *          - ERROR:   Mass erase operation failed
+  */
+ErrorStatus OPENBL_EXTNOR_MassErase(uint8_t *p_Data, uint32_t DataLength)
+{
+  return SUCCESS;
+}
+
+/**
+  * @brief  This function is used to erase a range of the external NOR.
+  * @param  *p_Data Pointer to the range: start address then length, both 32-bit MSB first.
+  * @param  DataLength Size of the Data buffer.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: Erase operation done
+  *          - ERROR:   Erase operation failed or the range is not valid
+  */
+ErrorStatus OPENBL_EXTNOR_Erase(uint8_t *p_Data, uint32_t DataLength)
+{
+  return SUCCESS;
+}
+
+/**
+  * @brief  Handle OCTOSPI interrupt request.
+  * @retval None.
+  */
+void OPENBL_EXTNOR_IRQHandler(void)
+{
+}
+
+/**
+  * @brief  Handle OCTOSPI DMA channel interrupt request.
+  * @retval None.
+  */
+void OPENBL_EXTNOR_DMA_IRQHandler(void)
+{
+}
@@ -126,6 +126,14 @@ void OPENBL_FDCAN_SendBytes(uint8_t *Buffer, uint32_t BufferSize)
 {
 }
 
+/**
+  * @brief  This function is used to answer the host polling during a flash operation.
+  * @retval None.
+  */
+OPENBL_HOT_PATH void OPENBL_FDCAN_SendBusyState(void)
+{
+}
+
 /**
  * @brief  This function is used to process and execute the special commands.
  *         The user must define the special commands routine here.
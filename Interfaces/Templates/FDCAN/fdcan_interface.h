@@ -26,6 +26,7 @@ extern "C" {
 
 /* Includes ------------------------------------------------------------------*/
 #include <stdint.h>
+#include "common_interface.h"
 #include "openbl_core.h"
 
 /* Exported types ------------------------------------------------------------*/
@@ -41,6 +42,7 @@ uint8_t OPENBL_FDCAN_ReadByte(void);
 void OPENBL_FDCAN_ReadBytes(uint8_t *Buffer, uint32_t BufferSize);
 void OPENBL_FDCAN_SendByte(uint8_t Byte);
 void OPENBL_FDCAN_SendBytes(uint8_t *Buffer, uint32_t BufferSize);
+OPENBL_HOT_PATH void OPENBL_FDCAN_SendBusyState(void);
 void OPENBL_FDCAN_SpecialCommandProcess(OPENBL_SpecialCmdTypeDef *Frame);
 
 #ifdef __cplusplus
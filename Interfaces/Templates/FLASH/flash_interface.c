@@ -30,6 +30,8 @@
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 uint32_t Flash_BusyState = FLASH_BUSY_STATE_DISABLED;
+OPENBL_FLASH_ProgressTypeDef FlashProgress = {0U, 0U, 0U};
+OPENBL_FLASH_TimingTypeDef FlashTiming = {FLASH_PAGE_ERASE_TIME, FLASH_BANK_ERASE_TIME, FLASH_QUADWORD_PROGRAM_TIME};
 FLASH_ProcessTypeDef FlashProcess = {.Lock = HAL_UNLOCKED, \
                                      .ErrorCode = HAL_FLASH_ERROR_NONE, \
                                      .ProcedureOnGoing = 0U, \
@@ -111,10 +113,15 @@ uint8_t OPENBL_FLASH_Read(uint32_t Address)
   * @param  Address The address where that data will be written.
   * @param  Data The data to be written.
   * @param  DataLength The length of the data to be written.
-  * @retval None.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: Write operation done
+  *          - ERROR:   Write operation failed
   */
-void OPENBL_FLASH_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength)
+ErrorStatus OPENBL_FLASH_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength)
 {
+  ErrorStatus status = SUCCESS;
+
+  return status;
 }
 
 /**
@@ -126,6 +133,33 @@ void OPENBL_FLASH_JumpToAddress(uint32_t Address)
 {
 }
 
+/**
+  * @brief  Verify the application image against the digest of its footer.
+  * @note   A full verification is skipped when the image digest cache, kept in the
+  *         backup registers, matches the footer and no flash modification happened
+  *         since the last full verification.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: The image is valid
+  *          - ERROR:   No image or the image is corrupted
+  */
+ErrorStatus OPENBL_FLASH_VerifyImage(void)
+{
+  ErrorStatus status = SUCCESS;
+
+  return status;
+}
+
+/**
+  * @brief  Compute the CRC32 of a word aligned area with the CRC peripheral.
+  * @param  Address The start address of the area.
+  * @param  Length The length of the area, multiple of 4.
+  * @retval Returns the CRC32 of the area.
+  */
+uint32_t OPENBL_FLASH_ComputeDigest(uint32_t Address, uint32_t Length)
+{
+  return 0U;
+}
+
 /**
   * @brief  Return the FLASH Read Protection level.
   * @retval The return value can be one of the following values:
@@ -140,6 +174,17 @@ uint32_t OPENBL_FLASH_GetReadOutProtectionLevel(void)
   return flash_ob.RDPLevel;
 }
 
+/**
+  * @brief  Check if a FLASH range overlaps a write protected area.
+  * @param  Address The start address of the range.
+  * @param  Length The length of the range.
+  * @retval Returns SET if a part of the range is write protected else returns RESET.
+  */
+FlagStatus OPENBL_FLASH_GetWriteProtectionStatus(uint32_t Address, uint32_t Length)
+{
+  return RESET;
+}
+
 /**
   * @brief  Return the FLASH Read Protection level.
   * @param  Level Can be one of these values:
@@ -200,6 +245,19 @@ ErrorStatus OPENBL_FLASH_Erase(uint8_t *p_Data, uint32_t DataLength)
   return status;
 }
 
+/**
+  * @brief  Erase the FLASH page reserved for the image metadata record.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: Erase operation done
+  *          - ERROR:   Erase operation failed
+  */
+ErrorStatus OPENBL_FLASH_EraseMetadata(void)
+{
+  ErrorStatus status = SUCCESS;
+
+  return status;
+}
+
 /**
  * @brief  This function is used to Set Flash busy state variable to activate busy state sending
  *         during flash operations
@@ -217,6 +275,14 @@ void OPENBL_Disable_BusyState_Flag(void)
 {
 }
 
+/**
+  * @brief  Handle the FLASH end of operation and operation error interrupts.
+  * @retval None.
+  */
+void OPENBL_FLASH_IRQHandler(void)
+{
+}
+
 /* Private functions ---------------------------------------------------------*/
 
 /**
@@ -28,26 +28,76 @@ extern "C" {
 #include "common_interface.h"
 
 /* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  uint16_t Done;                /*!< Number of flash operations completed for the current request */
+  uint16_t Total;               /*!< Number of flash operations of the current request */
+  uint16_t RemainingTime;       /*!< Estimated time in ms before the current request completes */
+} OPENBL_FLASH_ProgressTypeDef;
+
+typedef struct
+{
+  uint32_t PageEraseTime;       /*!< Running estimate in us of a page erase */
+  uint32_t BankEraseTime;       /*!< Running estimate in us of a bank erase */
+  uint32_t QuadWordProgramTime; /*!< Running estimate in us of a quad-word programming */
+} OPENBL_FLASH_TimingTypeDef;
+
+/* Footer of the application image, in the last quad-word of the image slot */
+typedef struct
+{
+  uint32_t Magic;               /*!< FLASH_IMAGE_FOOTER_MAGIC if the slot holds an image */
+  uint32_t Length;              /*!< Length in bytes of the image, multiple of 4 */
+  uint32_t Digest;              /*!< CRC32 of the image words, as computed by the CRC peripheral */
+  uint32_t Reserved;            /*!< Pads the footer to a quad-word */
+} OPENBL_FLASH_ImageFooterTypeDef;
+
+/* Image digest cache, in the TAMP backup registers starting at OPENBL_IMAGE_CACHE_BKP_INDEX */
+typedef struct
+{
+  uint32_t Generation;          /*!< Incremented by each flash modification */
+  uint32_t Magic;               /*!< FLASH_IMAGE_CACHE_MAGIC if the fields below come from a full verification */
+  uint32_t VerifiedGeneration;  /*!< Generation at the time of the full verification */
+  uint32_t Length;              /*!< Length of the verified image */
+  uint32_t Digest;              /*!< Digest of the verified image */
+} OPENBL_FLASH_ImageCacheTypeDef;
+
 /* Exported constants --------------------------------------------------------*/
 #define FLASH_BUSY_STATE_ENABLED       ((uint32_t)0xAAAA0000)
 #define FLASH_BUSY_STATE_DISABLED      ((uint32_t)0x0000DDDD)
 #define PROGRAM_TIMEOUT                ((uint32_t)0x00FFFFFF)
 
+/* Datasheet duration in us of the flash operations, initial value of the running estimates */
+#define FLASH_PAGE_ERASE_TIME          ((uint32_t)1500U)
+#define FLASH_BANK_ERASE_TIME          ((uint32_t)20000U)
+#define FLASH_QUADWORD_PROGRAM_TIME    ((uint32_t)120U)
+
+#define FLASH_IMAGE_FOOTER_MAGIC       ((uint32_t)0x494D4147U)  /* "IMAG" */
+#define FLASH_IMAGE_CACHE_MAGIC        ((uint32_t)0x56455249U)  /* "VERI" */
+
 /* Exported macro ------------------------------------------------------------*/
+/* Exported variables --------------------------------------------------------*/
+extern OPENBL_FLASH_ProgressTypeDef FlashProgress;
+extern OPENBL_FLASH_TimingTypeDef FlashTiming;
+
 /* Exported functions ------------------------------------------------------- */
 void OPENBL_FLASH_JumpToAddress(uint32_t Address);
+ErrorStatus OPENBL_FLASH_VerifyImage(void);
+uint32_t OPENBL_FLASH_ComputeDigest(uint32_t Address, uint32_t Length);
 void OPENBL_FLASH_Lock(void);
 void OPENBL_FLASH_OB_Unlock(void);
 uint8_t OPENBL_FLASH_Read(uint32_t Address);
 void OPENBL_FLASH_SetReadOutProtectionLevel(uint32_t Level);
-void OPENBL_FLASH_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength);
+ErrorStatus OPENBL_FLASH_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength);
 void OPENBL_FLASH_Unlock(void);
 ErrorStatus OPENBL_FLASH_MassErase(uint8_t *p_Data, uint32_t DataLength);
 ErrorStatus OPENBL_FLASH_Erase(uint8_t *p_Data, uint32_t DataLength);
+ErrorStatus OPENBL_FLASH_EraseMetadata(void);
 ErrorStatus OPENBL_FLASH_SetWriteProtection(FunctionalState State, uint8_t *ListOfPages, uint32_t Length);
 uint32_t OPENBL_FLASH_GetReadOutProtectionLevel(void);
+FlagStatus OPENBL_FLASH_GetWriteProtectionStatus(uint32_t Address, uint32_t Length);
 void OPENBL_Enable_BusyState_Flag(void);
 void OPENBL_Disable_BusyState_Flag(void);
+void OPENBL_FLASH_IRQHandler(void);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,141 @@
+/**
+  ******************************************************************************
+  * @file    flashsim_interface.c
+  * @author  MCD Application Team
+  * @brief   Contains simulated FLASH access functions backed by a flash image
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "platform.h"
+#include "openbl_mem.h"
+#include "openbl_kernels.h"
+#include "flashsim_interface.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Exported variables --------------------------------------------------------*/
+OPENBL_MemoryTypeDef FLASHSIM_Descriptor =
+{
+  FLASH_START_ADDRESS,
+  FLASH_END_ADDRESS,
+  FLASH_BL_SIZE,
+  FLASH_AREA,
+  OPENBL_FLASHSIM_Read,
+  OPENBL_FLASHSIM_Write,
+  NULL,
+  NULL,
+  NULL,
+  OPENBL_FLASHSIM_MassErase,
+  OPENBL_FLASHSIM_Erase
+};
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  This function is used to attach the simulated FLASH to its image.
+  * @param  pImage Pointer to the image, it must be FLASH_BL_SIZE bytes long.
+  * @param  pTiming Simulated operations durations, NULL to run at memory speed.
+  * @retval None.
+  */
+void OPENBL_FLASHSIM_Init(uint8_t *pImage, const OPENBL_FLASHSIM_TimingTypeDef *pTiming)
+{
+}
+
+/**
+  * @brief  This function is used to read data from a given address.
+  * @param  Address The address to be read.
+  * @retval Returns the read value.
+  */
+uint8_t OPENBL_FLASHSIM_Read(uint32_t Address)
+{
+  return 0U;
+}
+
+/**
+  * @brief  This function is used to write data in the simulated FLASH memory.
+  * @param  Address The address where that data will be written.
+  * @param  Data The data to be written.
+  * @param  DataLength The length of the data to be written.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: Write operation done
+  *          - ERROR:   Write operation failed
+  */
+ErrorStatus OPENBL_FLASHSIM_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength)
+{
+  ErrorStatus status = SUCCESS;
+
+  return status;
+}
+
+/**
+  * @brief  This function is used to start the simulated FLASH mass erase operation.
+  * @param  *p_Data Pointer to the buffer that contains mass erase operation options.
+  * @param  DataLength Size of the Data buffer.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: Mass erase operation done
+  *          - ERROR:   Mass erase operation failed or the value of one parameter is not OK
+  */
+ErrorStatus OPENBL_FLASHSIM_MassErase(uint8_t *p_Data, uint32_t DataLength)
+{
+  ErrorStatus status = SUCCESS;
+
+  return status;
+}
+
+/**
+  * @brief  This function is used to erase the specified simulated FLASH pages.
+  * @param  *p_Data Pointer to the buffer that contains erase operation options.
+  * @param  DataLength Size of the Data buffer.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: Erase operation done
+  *          - ERROR:   Erase operation failed or the value of one parameter is not OK
+  */
+ErrorStatus OPENBL_FLASHSIM_Erase(uint8_t *p_Data, uint32_t DataLength)
+{
+  ErrorStatus status = SUCCESS;
+
+  return status;
+}
+
+/**
+  * @brief  Compute the CRC32 of a word aligned area of the simulated FLASH.
+  * @param  Address The start address of the area.
+  * @param  Length The length of the area, multiple of 4.
+  * @retval Returns the CRC32 of the area.
+  */
+uint32_t OPENBL_FLASHSIM_ComputeDigest(uint32_t Address, uint32_t Length)
+{
+  return 0U;
+}
+
+/**
+  * @brief  This function is used to get the errors recorded since the initialization.
+  * @retval Returns a combination of FLASHSIM_ERROR_xxx flags.
+  */
+uint32_t OPENBL_FLASHSIM_GetErrors(void)
+{
+  return FLASHSIM_ERROR_NONE;
+}
+
+/**
+  * @brief  This function is used to get the simulated time spent in FLASH operations.
+  * @retval Returns the elapsed time in us since the initialization.
+  */
+uint32_t OPENBL_FLASHSIM_GetElapsedTime(void)
+{
+  return 0U;
+}
@@ -0,0 +1,66 @@
+/**
+  ******************************************************************************
+  * @file    flashsim_interface.h
+  * @author  MCD Application Team
+  * @brief   Header for flashsim_interface.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef FLASHSIM_INTERFACE_H
+#define FLASHSIM_INTERFACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "openbl_mem.h"
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t PageEraseTime;          /*!< Simulated duration in us of a page erase */
+  uint32_t BankEraseTime;          /*!< Simulated duration in us of a bank erase */
+  uint32_t QuadWordProgramTime;    /*!< Simulated duration in us of a quad-word programming */
+  void (*Delay)(uint32_t Time);    /*!< Called with the duration of each operation, NULL to run at memory speed */
+} OPENBL_FLASHSIM_TimingTypeDef;
+
+/* Exported constants --------------------------------------------------------*/
+#define FLASHSIM_PAGE_SIZE             0x2000U                     /* Size of a simulated flash page */
+#define FLASHSIM_BANK_SIZE             (FLASH_BL_SIZE / 2U)        /* Size of a simulated flash bank */
+#define FLASHSIM_QUADWORD_SIZE         16U                         /* Flash programming granularity */
+
+#define FLASHSIM_ERROR_NONE            0x00U  /* No error */
+#define FLASHSIM_ERROR_NOT_ERASED      0x01U  /* Programming of a quad-word that is not erased */
+#define FLASHSIM_ERROR_RANGE           0x02U  /* Access outside of the simulated flash */
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported variables --------------------------------------------------------*/
+extern OPENBL_MemoryTypeDef FLASHSIM_Descriptor;
+
+/* Exported functions ------------------------------------------------------- */
+void OPENBL_FLASHSIM_Init(uint8_t *pImage, const OPENBL_FLASHSIM_TimingTypeDef *pTiming);
+uint8_t OPENBL_FLASHSIM_Read(uint32_t Address);
+ErrorStatus OPENBL_FLASHSIM_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength);
+ErrorStatus OPENBL_FLASHSIM_MassErase(uint8_t *p_Data, uint32_t DataLength);
+ErrorStatus OPENBL_FLASHSIM_Erase(uint8_t *p_Data, uint32_t DataLength);
+uint32_t OPENBL_FLASHSIM_ComputeDigest(uint32_t Address, uint32_t Length);
+uint32_t OPENBL_FLASHSIM_GetErrors(void);
+uint32_t OPENBL_FLASHSIM_GetElapsedTime(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FLASHSIM_INTERFACE_H */
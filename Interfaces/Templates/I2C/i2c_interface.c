@@ -87,7 +87,7 @@ uint8_t OPENBL_I2C_GetCommandOpcode(void)
   * @brief  This function is used to read one byte from I2C pipe.
   * @retval Returns the read byte.
   */
-uint8_t OPENBL_I2C_ReadByte(void)
+OPENBL_HOT_PATH uint8_t OPENBL_I2C_ReadByte(void)
 {
   uint32_t timeout = 0U;
 
@@ -99,7 +99,7 @@ uint8_t OPENBL_I2C_ReadByte(void)
   * @param  Byte The byte to be sent.
   * @retval None.
   */
-void OPENBL_I2C_SendByte(uint8_t Byte)
+OPENBL_HOT_PATH void OPENBL_I2C_SendByte(uint8_t Byte)
 {
 }
 
@@ -166,19 +166,3 @@ void OPENBL_I2C_SpecialCommandProcess(OPENBL_SpecialCmdTypeDef *SpecialCmd)
 {
 }
 
-/**
- * @brief  This function is used to Set Flash busy state variable to activate busy state sending
- *         during flash operations
- * @retval None.
-*/
-void OPENBL_Enable_BusyState_Sending(void)
-{
-}
-
-/**
- * @brief  This function is used to disable the send of busy state in I2C non stretch mode.
- * @retval None.
-*/
-void OPENBL_Disable_BusyState_Sending(void)
-{
-}
@@ -77,8 +77,13 @@ void BL_FLASH_WriteOptKeys(void)
   * @param  Address The address where that data will be written.
   * @param  Data The data to be written.
   * @param  DataLength The length of the data to be written.
-  * @retval None.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: Write operation done
+  *          - ERROR:   Write operation failed
   */
-void OPENBL_OB_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength)
+ErrorStatus OPENBL_OB_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength)
 {
+  ErrorStatus status = SUCCESS;
+
+  return status;
 }
@@ -63,10 +63,15 @@ uint8_t OPENBL_OTP_Read(uint32_t Address)
   * @param  Address The address where that data will be written.
   * @param  Data The data to be written.
   * @param  DataLength The length of the data to be written.
-  * @retval None.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: Write operation done
+  *          - ERROR:   Write operation failed
   */
-void OPENBL_OTP_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength)
+ErrorStatus OPENBL_OTP_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength)
 {
+  ErrorStatus status = SUCCESS;
+
+  return status;
 }
 
 /* Private functions ---------------------------------------------------------*/
@@ -62,10 +62,15 @@ uint8_t OPENBL_RAM_Read(uint32_t Address)
   * @param  Address The address where that data will be written.
   * @param  pData The data to be written.
   * @param  DataLength The length of the data to be written.
-  * @retval None.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: Write operation done
+  *          - ERROR:   Write operation failed
   */
-void OPENBL_RAM_Write(uint32_t Address, uint8_t *pData, uint32_t DataLength)
+OPENBL_HOT_PATH ErrorStatus OPENBL_RAM_Write(uint32_t Address, uint8_t *pData, uint32_t DataLength)
 {
+  ErrorStatus status = SUCCESS;
+
+  return status;
 }
 
 /**
@@ -108,6 +108,20 @@ __attribute__((section(".ramfunc"))) uint8_t OPENBL_SPI_ReadByte(void)
   return data;
 }
 
+/**
+  * @brief  This function is used to read a block of bytes from SPI pipe.
+  * @param  Buffer The buffer where the received bytes are stored.
+  * @param  BufferSize The number of bytes to be received.
+  * @retval None.
+  */
+#if defined (__ICCARM__)
+__ramfunc void OPENBL_SPI_ReadBytes(uint8_t *Buffer, uint32_t BufferSize)
+#else
+__attribute__((section(".ramfunc"))) void OPENBL_SPI_ReadBytes(uint8_t *Buffer, uint32_t BufferSize)
+#endif /* (__ICCARM__) */
+{
+}
+
 /**
   * @brief  This function is used to send one busy byte each receive interrupt through SPI pipe.
   *         Read operation is synchronized on SPI Rx buffer not empty interrupt.
@@ -121,6 +135,18 @@ __attribute__((section(".ramfunc"))) void OPENBL_SPI_SendBusyByte(void)
 {
 }
 
+/**
+  * @brief  This function is used to answer the host polling during a flash operation.
+  * @retval None.
+  */
+#if defined (__ICCARM__)
+__ramfunc void OPENBL_SPI_SendBusyState(void)
+#else
+__attribute__((section(".ramfunc"))) void OPENBL_SPI_SendBusyState(void)
+#endif /* (__ICCARM__) */
+{
+}
+
 /**
   * @brief  This function is used to send one byte through SPI pipe.
   * @retval None.
@@ -141,6 +167,14 @@ void OPENBL_SPI_SendAcknowledgeByte(uint8_t Byte)
 {
 }
 
+/**
+  * @brief  This function is used to send the status byte of a command through SPI pipe.
+  * @retval None.
+  */
+void OPENBL_SPI_SendStatusByte(uint8_t Byte)
+{
+}
+
 /**
   * @brief  Handle SPI interrupt request.
   * @retval None.
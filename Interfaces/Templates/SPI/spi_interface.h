@@ -37,6 +37,7 @@ void OPENBL_SPI_DeInit(void);
 uint8_t OPENBL_SPI_ProtocolDetection(void);
 uint8_t OPENBL_SPI_GetCommandOpcode(void);
 void OPENBL_SPI_SendAcknowledgeByte(uint8_t Byte);
+void OPENBL_SPI_SendStatusByte(uint8_t Byte);
 void OPENBL_SPI_SpecialCommandProcess(OPENBL_SpecialCmdTypeDef *SpecialCmd);
 
 void OPENBL_SPI_EnableBusyState(void);
@@ -44,14 +45,18 @@ void OPENBL_SPI_DisableBusyState(void);
 
 #if defined (__ICCARM__)
 __ramfunc uint8_t OPENBL_SPI_ReadByte(void);
+__ramfunc void OPENBL_SPI_ReadBytes(uint8_t *Buffer, uint32_t BufferSize);
 __ramfunc void OPENBL_SPI_SendByte(uint8_t Byte);
 __ramfunc void OPENBL_SPI_IRQHandler(void);
 __ramfunc void OPENBL_SPI_SendBusyByte(void);
+__ramfunc void OPENBL_SPI_SendBusyState(void);
 #else
 __attribute__((section(".ramfunc"))) uint8_t OPENBL_SPI_ReadByte(void);
+__attribute__((section(".ramfunc"))) void OPENBL_SPI_ReadBytes(uint8_t *Buffer, uint32_t BufferSize);
 __attribute__((section(".ramfunc"))) void OPENBL_SPI_SendByte(uint8_t Byte);
 __attribute__((section(".ramfunc"))) void OPENBL_SPI_IRQHandler(void);
 __attribute__((section(".ramfunc"))) void OPENBL_SPI_SendBusyByte(void);
+__attribute__((section(".ramfunc"))) void OPENBL_SPI_SendBusyState(void);
 #endif /* (__ICCARM__) */
 
 #ifdef __cplusplus
@@ -86,17 +86,38 @@ uint8_t OPENBL_USART_GetCommandOpcode(void)
   * @brief  This function is used to read one byte from USART pipe.
   * @retval Returns the read byte.
   */
-uint8_t OPENBL_USART_ReadByte(void)
+OPENBL_HOT_PATH uint8_t OPENBL_USART_ReadByte(void)
 {
   return LL_USART_ReceiveData8(USARTx);
 }
 
+/**
+  * @brief  This function is used to receive a block of bytes through USART pipe.
+  * @param  Buffer The buffer where the received bytes are stored.
+  * @param  BufferSize The number of bytes to be received.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: The whole block is received
+  *          - ERROR:   The host stalled before the end of the block
+  */
+ErrorStatus OPENBL_USART_ReadBytes(uint8_t *Buffer, uint32_t BufferSize)
+{
+  return SUCCESS;
+}
+
 /**
   * @brief  This function is used to send one byte through USART pipe.
   * @param  Byte The byte to be sent.
   * @retval None.
   */
-void OPENBL_USART_SendByte(uint8_t Byte)
+OPENBL_HOT_PATH void OPENBL_USART_SendByte(uint8_t Byte)
+{
+}
+
+/**
+  * @brief  This function is used to answer the host polling during a flash operation.
+  * @retval None.
+  */
+OPENBL_HOT_PATH void OPENBL_USART_SendBusyState(void)
 {
 }
 
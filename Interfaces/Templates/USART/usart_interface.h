@@ -26,6 +26,7 @@ extern "C" {
 
 /* Includes ------------------------------------------------------------------*/
 #include <stdint.h>
+#include "common_interface.h"
 #include "openbl_core.h"
 
 /* Exported types ------------------------------------------------------------*/
@@ -37,8 +38,10 @@ void OPENBL_USART_DeInit(void);
 uint8_t OPENBL_USART_ProtocolDetection(void);
 
 uint8_t OPENBL_USART_GetCommandOpcode(void);
-uint8_t OPENBL_USART_ReadByte(void);
-void OPENBL_USART_SendByte(uint8_t Byte);
+OPENBL_HOT_PATH uint8_t OPENBL_USART_ReadByte(void);
+ErrorStatus OPENBL_USART_ReadBytes(uint8_t *Buffer, uint32_t BufferSize);
+OPENBL_HOT_PATH void OPENBL_USART_SendByte(uint8_t Byte);
+OPENBL_HOT_PATH void OPENBL_USART_SendBusyState(void);
 void OPENBL_USART_SpecialCommandProcess(OPENBL_SpecialCmdTypeDef *SpecialCmd);
 
 #ifdef __cplusplus
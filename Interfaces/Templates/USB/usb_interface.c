@@ -65,8 +65,8 @@ uint8_t OPENBL_USB_ProtocolDetection(void)
 
 /**
   * @brief  Gets the page of a given address.
-  * @param  Address Address of the FLASH Memory.
-  * @retval The page of a given address.
+  * @param  Address Address of the FLASH Memory or of the external NOR.
+  * @retval The page of a given address, the 4 KByte sector for the external NOR.
   */
 uint32_t OPENBL_USB_GetPage(uint32_t Address)
 {
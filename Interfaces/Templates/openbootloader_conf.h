@@ -59,10 +59,38 @@ extern "C" {
 #define EB_START_ADDRESS                  0x0BFA0500U  /* Engi bytes start address */
 #define EB_END_ADDRESS                    (EB_START_ADDRESS + EB_SIZE)  /* Engi bytes end address  */
 
+#define EXTNOR_BL_SIZE                    (16U * 1024U * 1024U)  /* Size of external NOR 16 MByte */
+#define EXTNOR_START_ADDRESS              OCTOSPI1_BASE  /* Memory-mapped start of external NOR */
+#define EXTNOR_END_ADDRESS                (EXTNOR_START_ADDRESS + EXTNOR_BL_SIZE)  /* Memory-mapped end of external NOR */
+
 #define OPENBL_RAM_SIZE                   0x11800U  /* RAM used by the Open Bootloader 71680 Bytes */
+#define OPENBL_STACK_SIZE                 0x1000U  /* Size of the main stack, as reserved by the linker file */
 
 #define OPENBL_DEFAULT_MEM                FLASH_START_ADDRESS  /* Default address used for erase and write/read protect commands */
 
+/* Number of FLASH pages buffered by the write cache, 0 to disable it. When enabled, a Write Memory
+   can be acknowledged before its page is programmed: the last pages are programmed and checked when
+   the next command is received, which is NACKed if their programming failed */
+#define OPENBL_MEM_CACHE_SLOTS            0U
+#define OPENBL_MEM_CACHE_PAGE_SIZE        0x2000U  /* Size of a write cache page, must be a power of 2 */
+#define OPENBL_ERASE_SLICE_PAGES          1U  /* Pages erased per suspendable erase request before suspending */
+#define OPENBL_ADAPTIVE_FRAME_SIZE        0U  /* 1: the session frame size follows the one recommended from the link errors */
+
+/* 1: the core sleeps during the FLASH operations until the end of operation interrupt. The FLASH
+   interrupt handler (FLASH_S_IRQHandler in the secure world) must then call OPENBL_FLASH_IRQHandler */
+#define OPENBL_FLASH_USE_IRQ              0U
+
+#define OPENBL_FAST_HANDOFF               0U  /* 1: Go resets the used peripherals at once instead of de-initializing each interface */
+#define OPENBL_HANDOFF_KEEP_CLOCKS        0U  /* 1: the fast hand-off leaves the PLL and the flash latency configured */
+#define OPENBL_HANDOFF_BKP_INDEX          24U  /* First TAMP backup register of the hand-off block, 7 registers are used */
+
+#define OPENBL_VERIFIED_BOOT              0U  /* 1: Go verifies the application image before jumping to it */
+#define OPENBL_IMAGE_START_ADDRESS        FLASH_START_ADDRESS  /* Start of the application image slot */
+#define OPENBL_IMAGE_SLOT_SIZE            (FLASH_BL_SIZE / 2U)  /* Size of the image slot, its footer is in its last quad-word */
+#define OPENBL_IMAGE_CACHE_BKP_INDEX      19U  /* First TAMP backup register of the image digest cache, 5 registers are used */
+#define OPENBL_METADATA_PAGE              255U  /* FLASH page reserved for the image metadata record */
+#define OPENBL_METADATA_ADDRESS           (FLASH_START_ADDRESS + (OPENBL_METADATA_PAGE * FLASH_PAGE_SIZE))  /* Image metadata record */
+
 #define RDP_LEVEL_0                       OB_RDP_LEVEL_0
 #define RDP_LEVEL_1                       OB_RDP_LEVEL_1
 #define RDP_LEVEL_2                       OB_RDP_LEVEL_2
@@ -74,6 +102,7 @@ extern "C" {
 #define OTP_AREA                          0x4U  /* OTP Address area */
 #define ICP_AREA                          0x5U  /* System memory area */
 #define EB_AREA                           0x6U  /* Engi bytes Address area */
+#define EXTNOR_AREA                       0x7U  /* External NOR Address area */
 
 #define FLASH_MASS_ERASE                  0xFFFF
 #define FLASH_BANK1_ERASE                 0xFFFE
@@ -81,6 +110,18 @@ extern "C" {
 
 #define INTERFACES_SUPPORTED              6U
 
+/* ---------------------------- Special commands ---------------------------- */
+/* The operation codes below must also be listed in the SpecialCmdList table */
+#define SPECIAL_CMD_GET_RAM_USAGE         0x0A01U  /* Get the stack and RAM buffers high-water marks */
+#define SPECIAL_CMD_SUSPENDABLE_ERASE     0x0A02U  /* Start or resume a bank erase that runs by slices of pages */
+#define SPECIAL_CMD_GET_NODE_STATUS       0x0A03U  /* Get the outcome of the broadcast commands */
+#define SPECIAL_CMD_GET_FLASH_TIMING      0x0A04U  /* Get the measured durations of the flash operations */
+#define SPECIAL_CMD_GET_LINK_STATUS       0x0A05U  /* Get the link error statistics and the recommended frame size */
+#define SPECIAL_CMD_SET_IMAGE_METADATA    0x0A06U  /* Store the metadata of the programmed image */
+#define SPECIAL_CMD_CHECK_IMAGE_METADATA  0x0A07U  /* Compare the stored image metadata with the host one */
+#define SPECIAL_CMD_START_EXTENTS         0x0A08U  /* Erase the pages of an extent table and open a sparse upload */
+#define SPECIAL_CMD_EXTENT_DATA           0x0A09U  /* Extended special command: next data of the sparse upload */
+
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
 
@@ -28,8 +28,9 @@
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
-#define OPENBL_CAN_COMMANDS_NB_MAX        12U  /* Number of supported commands */
+#define OPENBL_CAN_COMMANDS_NB_MAX        13U  /* Number of supported commands */
 #define OPENBL_CAN_SPEED_MAX              4U  /* Max speed is 4 (1 Mbps) */
+#define OPENBL_CAN_SPEED_OPTIONS          0x1EU  /* Speeds 1 to 4 accepted by the Speed command */
 
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
@@ -73,7 +74,8 @@ OPENBL_CommandsTypeDef *OPENBL_CAN_GetCommandsList(void)
     NULL,
     OPENBL_CAN_Speed,
     NULL,
-    NULL
+    NULL,
+    OPENBL_CAN_Handshake
   };
 
   OPENBL_CAN_SetCommandsList(&OPENBL_CAN_Commands);
@@ -157,6 +159,55 @@ void OPENBL_CAN_GetID(void)
   OPENBL_CAN_SendByte(ACK_BYTE);
 }
 
+/**
+  * @brief  This function is used to negotiate the session parameters with the host.
+  * @note   The host puts its frame size, integrity modes and window depth in the command
+  *         frame, the device answers with its capabilities, the selected parameters and
+  *         its commands.
+  * @retval None.
+  */
+void OPENBL_CAN_Handshake(void)
+{
+  uint32_t counter;
+  uint32_t length;
+  uint32_t data_length;
+
+  /* Send Acknowledge byte to notify the host that the command is recognized */
+  OPENBL_CAN_SendByte(ACK_BYTE);
+
+  /* The command frame is protected by the CAN CRC, no checksum is needed */
+  Common_SelectSession(tCanRxData);
+
+  /* The number of bytes to follow - 1, the header, the number of commands and their list */
+  length = 1U + Common_SetHandshakeHeader(&tCanTxData[1], OPENBL_CAN_VERSION, OPENBL_CAN_SPEED_OPTIONS);
+
+  tCanTxData[0]      = (uint8_t)(length + CanCommandsNumber - 1U);
+  tCanTxData[length] = CanCommandsNumber;
+  length++;
+
+  for (counter = 0U; counter < CanCommandsNumber; counter++)
+  {
+    tCanTxData[length] = a_OPENBL_CAN_CommandsList[counter];
+    length++;
+  }
+
+  /* Send the report by frames of 8 bytes */
+  for (counter = 0U; counter < length; counter += CAN_DLC_BYTES_8)
+  {
+    data_length = length - counter;
+
+    if (data_length > CAN_DLC_BYTES_8)
+    {
+      data_length = CAN_DLC_BYTES_8;
+    }
+
+    OPENBL_CAN_SendBytes(&tCanTxData[counter], data_length);
+  }
+
+  /* Send last Acknowledge synchronization byte */
+  OPENBL_CAN_SendByte(ACK_BYTE);
+}
+
 /**
   * @brief  This function is used to set a new baud-rate.
   * @retval None.
@@ -223,7 +274,9 @@ void OPENBL_CAN_ReadMemory(void)
   }
   else
   {
-    if (OPENBL_CAN_GetAddress(&address) == NACK_BYTE)
+    /* The command frame carries the address and the length, checked against the session frame size */
+    if ((OPENBL_CAN_GetAddress(&address) == NACK_BYTE)
+        || (Common_CheckFrameSize((uint32_t)tCanRxData[4] + 1U) == 0U))
     {
       OPENBL_CAN_SendByte(NACK_BYTE);
     }
@@ -284,6 +337,7 @@ void OPENBL_CAN_WriteMemory(void)
   uint32_t count;
   uint32_t single;
   uint8_t data_length;
+  ErrorStatus status;
 
   /* Check memory protection then send adequate response */
   if (Common_GetProtectionStatus() != RESET)
@@ -292,7 +346,11 @@ void OPENBL_CAN_WriteMemory(void)
   }
   else
   {
-    if (OPENBL_CAN_GetAddress(&address) == NACK_BYTE)
+    /* The command frame carries the address and the length: check the whole range and the session
+       frame size before the payload */
+    if ((OPENBL_CAN_GetAddress(&address) == NACK_BYTE)
+        || (OPENBL_MEM_CheckWriteRange(address, ((uint32_t)tCanRxData[4] + 1U)) == 0U)
+        || (Common_CheckFrameSize((uint32_t)tCanRxData[4] + 1U) == 0U))
     {
       OPENBL_CAN_SendByte(NACK_BYTE);
     }
@@ -308,6 +366,9 @@ void OPENBL_CAN_WriteMemory(void)
 
       data_length = 0;
 
+      /* Discard the bus errors that occurred before the payload */
+      (void)OPENBL_CAN_GetLinkErrorStatus();
+
       if (count != 0U)
       {
         while (data_length != count)
@@ -325,14 +386,36 @@ void OPENBL_CAN_WriteMemory(void)
         OPENBL_CAN_SendByte(ACK_BYTE);
       }
 
+      /* Record the payload integrity, it drives the recommended frame size */
+      if (OPENBL_CAN_GetLinkErrorStatus() == SET)
+      {
+        Common_RecordLinkFrame(NACK_BYTE);
+      }
+      else
+      {
+        Common_RecordLinkFrame(ACK_BYTE);
+      }
+
+      /* Answer the host polling with the busy state */
+      OPENBL_Enable_BusyState_Sending();
+
       /* Write data to memory */
-      OPENBL_MEM_Write(address, (uint8_t *)tCanRxData, code_size);
+      status = OPENBL_MEM_Write(address, (uint8_t *)tCanRxData, code_size);
 
-      /* Send last Acknowledge synchronization byte */
-      OPENBL_CAN_SendByte(ACK_BYTE);
+      OPENBL_Disable_BusyState_Sending();
 
-      /* Start post processing task if needed */
-      Common_StartPostProcessing();
+      if (status == SUCCESS)
+      {
+        /* Send last Acknowledge synchronization byte */
+        OPENBL_CAN_SendByte(ACK_BYTE);
+
+        /* Start post processing task if needed */
+        Common_StartPostProcessing();
+      }
+      else
+      {
+        OPENBL_CAN_SendByte(NACK_BYTE);
+      }
     }
   }
 }
@@ -453,8 +536,13 @@ void OPENBL_CAN_LegacyEraseMemory(void)
     /* All commands in range 0xFF are reserved for special erase features */
     if (((nsectors - 1U) == 0xFFU))
     {
+      /* Answer the host polling with the busy state */
+      OPENBL_Enable_BusyState_Sending();
+
       error_value = OPENBL_MEM_MassErase(OPENBL_DEFAULT_MEM, tCanRxData, CAN_RAM_BUFFER_SIZE);
 
+      OPENBL_Disable_BusyState_Sending();
+
       if (error_value == SUCCESS)
       {
         status = ACK_BYTE;
@@ -498,9 +586,14 @@ void OPENBL_CAN_LegacyEraseMemory(void)
         index                      += 2U;
       }
 
+      /* Answer the host polling with the busy state */
+      OPENBL_Enable_BusyState_Sending();
+
       /* Receive the list of pages to be erased (each page number is on one byte) */
       error_value = OPENBL_MEM_Erase(OPENBL_DEFAULT_MEM, a_erase_buffer, CAN_RAM_BUFFER_SIZE * 2U);
 
+      OPENBL_Disable_BusyState_Sending();
+
       /* Errors from memory erase are not managed, always return ACK */
       if (error_value == SUCCESS)
       {
@@ -626,6 +719,12 @@ static uint8_t OPENBL_CAN_ConstructCommandsTable(OPENBL_CommandsTypeDef *pCanCmd
     i++;
   }
 
+  if (pCanCmd->Handshake != NULL)
+  {
+    a_OPENBL_CAN_CommandsList[i] = CMD_HANDSHAKE;
+    i++;
+  }
+
   if (pCanCmd->Speed != NULL)
   {
     a_OPENBL_CAN_CommandsList[i] = CMD_SPEED;
@@ -39,6 +39,7 @@ void OPENBL_CAN_SetCommandsList(OPENBL_CommandsTypeDef *pCanCmd);
 void OPENBL_CAN_GetCommand(void);
 void OPENBL_CAN_GetVersion(void);
 void OPENBL_CAN_GetID(void);
+void OPENBL_CAN_Handshake(void);
 void OPENBL_CAN_Speed(void);
 void OPENBL_CAN_ReadMemory(void);
 void OPENBL_CAN_WriteMemory(void);
@@ -28,7 +28,8 @@
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
-#define OPENBL_FDCAN_COMMANDS_NB_MAX      13U       /* The maximum number of supported commands */
+#define OPENBL_FDCAN_COMMANDS_NB_MAX      14U       /* The maximum number of supported commands */
+#define OPENBL_FDCAN_HANDSHAKE_SIZE       32U       /* Size of the handshake frame, it holds the whole report */
 
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
@@ -71,7 +72,8 @@ OPENBL_CommandsTypeDef *OPENBL_FDCAN_GetCommandsList(void)
     NULL,
     NULL,
     OPENBL_FDCAN_SpecialCommand,
-    OPENBL_FDCAN_ExtendedSpecialCommand
+    OPENBL_FDCAN_ExtendedSpecialCommand,
+    OPENBL_FDCAN_Handshake
   };
 
   OPENBL_FDCAN_SetCommandsList(&OPENBL_FDCAN_Commands);
@@ -155,6 +157,50 @@ void OPENBL_FDCAN_GetID(void)
   OPENBL_FDCAN_SendByte(ACK_BYTE);
 }
 
+/**
+  * @brief  This function is used to negotiate the session parameters with the host.
+  * @note   The host puts its frame size, integrity modes and window depth in the command
+  *         frame, the device answers with its capabilities, the selected parameters and
+  *         its commands.
+  * @retval None.
+  */
+void OPENBL_FDCAN_Handshake(void)
+{
+  uint32_t counter;
+  uint32_t length;
+
+  /* Send Acknowledge byte to notify the host that the command is recognized */
+  OPENBL_FDCAN_SendByte(ACK_BYTE);
+
+  /* The command frame is protected by the FDCAN CRC, no checksum is needed */
+  Common_SelectSession(RxData);
+
+  /* Build a single frame: the number of bytes to follow - 1, the header, the number of commands and their list */
+  length = 1U + Common_SetHandshakeHeader(&TxData[1], OPENBL_FDCAN_VERSION, 0U);
+
+  TxData[0]      = (uint8_t)(length + FdcanCommandsNumber - 1U);
+  TxData[length] = FdcanCommandsNumber;
+  length++;
+
+  for (counter = 0U; counter < FdcanCommandsNumber; counter++)
+  {
+    TxData[length] = a_OPENBL_FDCAN_CommandsList[counter];
+    length++;
+  }
+
+  /* Pad the frame up to its data length code */
+  while (length < OPENBL_FDCAN_HANDSHAKE_SIZE)
+  {
+    TxData[length] = 0x00U;
+    length++;
+  }
+
+  OPENBL_FDCAN_SendBytes(TxData, FDCAN_DLC_BYTES_32);
+
+  /* Send last Acknowledge synchronization byte */
+  OPENBL_FDCAN_SendByte(ACK_BYTE);
+}
+
 /**
   * @brief  This function is used to read memory from the device.
   * @retval None.
@@ -176,7 +222,9 @@ void OPENBL_FDCAN_ReadMemory(void)
   }
   else
   {
-    if (OPENBL_FDCAN_GetAddress(&address) == NACK_BYTE)
+    /* The command frame carries the address and the length, checked against the session frame size */
+    if ((OPENBL_FDCAN_GetAddress(&address) == NACK_BYTE)
+        || (Common_CheckFrameSize((uint32_t)RxData[4] + 1U) == 0U))
     {
       OPENBL_FDCAN_SendByte(NACK_BYTE);
     }
@@ -249,6 +297,7 @@ void OPENBL_FDCAN_WriteMemory(void)
   uint32_t count;
   uint32_t single;
   uint8_t data_length;
+  ErrorStatus status;
 
   /* Check memory protection then send adequate response */
   if (Common_GetProtectionStatus() != RESET)
@@ -257,7 +306,11 @@ void OPENBL_FDCAN_WriteMemory(void)
   }
   else
   {
-    if (OPENBL_FDCAN_GetAddress(&address) == NACK_BYTE)
+    /* The command frame carries the address and the length: check the whole range and the session
+       frame size before the payload */
+    if ((OPENBL_FDCAN_GetAddress(&address) == NACK_BYTE)
+        || (OPENBL_MEM_CheckWriteRange(address, ((uint32_t)RxData[4] + 1U)) == 0U)
+        || (Common_CheckFrameSize((uint32_t)RxData[4] + 1U) == 0U))
     {
       OPENBL_FDCAN_SendByte(NACK_BYTE);
     }
@@ -288,14 +341,26 @@ void OPENBL_FDCAN_WriteMemory(void)
         OPENBL_FDCAN_ReadBytes(&RxData[(CodeSize - single)], 64U);
       }
 
+      /* Answer the host polling with the busy state */
+      OPENBL_Enable_BusyState_Sending();
+
       /* Write data to memory */
-      OPENBL_MEM_Write(address, (uint8_t *)RxData, CodeSize);
+      status = OPENBL_MEM_Write(address, (uint8_t *)RxData, CodeSize);
 
-      /* Send last Acknowledge synchronization byte */
-      OPENBL_FDCAN_SendByte(ACK_BYTE);
+      OPENBL_Disable_BusyState_Sending();
 
-      /* Start post processing task if needed */
-      Common_StartPostProcessing();
+      if (status == SUCCESS)
+      {
+        /* Send last Acknowledge synchronization byte */
+        OPENBL_FDCAN_SendByte(ACK_BYTE);
+
+        /* Start post processing task if needed */
+        Common_StartPostProcessing();
+      }
+      else
+      {
+        OPENBL_FDCAN_SendByte(NACK_BYTE);
+      }
     }
   }
 }
@@ -429,8 +494,13 @@ void OPENBL_FDCAN_EraseMemory(void)
     {
       if ((data == 0xFFFFU) || (data == 0xFFFEU) || (data == 0xFFFDU))
       {
+        /* Answer the host polling with the busy state */
+        OPENBL_Enable_BusyState_Sending();
+
         error_value = OPENBL_MEM_MassErase(OPENBL_DEFAULT_MEM, RxData, FDCAN_RAM_BUFFER_SIZE);
 
+        OPENBL_Disable_BusyState_Sending();
+
         if (error_value == SUCCESS)
         {
           status = ACK_BYTE;
@@ -467,8 +537,13 @@ void OPENBL_FDCAN_EraseMemory(void)
         i++;
       }
 
+      /* Answer the host polling with the busy state */
+      OPENBL_Enable_BusyState_Sending();
+
       error_value = OPENBL_MEM_Erase(OPENBL_DEFAULT_MEM, RxData, FDCAN_RAM_BUFFER_SIZE);
 
+      OPENBL_Disable_BusyState_Sending();
+
       /* Errors from memory erase are not managed, always return ACK */
       if (error_value == SUCCESS)
       {
@@ -805,6 +880,12 @@ static uint8_t OPENBL_FDCAN_ConstructCommandsTable(OPENBL_CommandsTypeDef *pFdca
     i++;
   }
 
+  if (pFdcanCmd->Handshake != NULL)
+  {
+    a_OPENBL_FDCAN_CommandsList[i] = CMD_HANDSHAKE;
+    i++;
+  }
+
   if (pFdcanCmd->ReadMemory != NULL)
   {
     a_OPENBL_FDCAN_CommandsList[i] = CMD_READ_MEMORY;
@@ -37,6 +37,7 @@ void OPENBL_FDCAN_SetCommandsList(OPENBL_CommandsTypeDef *pFdcanCmd);
 void OPENBL_FDCAN_GetCommand(void);
 void OPENBL_FDCAN_GetVersion(void);
 void OPENBL_FDCAN_GetID(void);
+void OPENBL_FDCAN_Handshake(void);
 void OPENBL_FDCAN_ReadMemory(void);
 void OPENBL_FDCAN_WriteMemory(void);
 void OPENBL_FDCAN_Go(void);
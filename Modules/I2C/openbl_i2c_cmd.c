@@ -27,7 +27,7 @@
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
-#define OPENBL_I2C_COMMANDS_NB_MAX        19U       /* Number of supported commands */
+#define OPENBL_I2C_COMMANDS_NB_MAX        20U       /* Number of supported commands */
 
 #define I2C_RAM_BUFFER_SIZE               1164U     /* Size of I2C buffer used to store received data from the host */
 
@@ -75,11 +75,15 @@ OPENBL_CommandsTypeDef *OPENBL_I2C_GetCommandsList(void)
     OPENBL_I2C_NonStretchReadoutUnprotect,
     NULL,
     OPENBL_I2C_SpecialCommand,
-    OPENBL_I2C_ExtendedSpecialCommand
+    OPENBL_I2C_ExtendedSpecialCommand,
+    OPENBL_I2C_Handshake
   };
 
   OPENBL_I2C_SetCommandsList(&OPENBL_I2C_Commands);
 
+  /* Paint the RAM buffer to measure its usage */
+  Common_PaintBuffer(I2C_RAM_Buf, I2C_RAM_BUFFER_SIZE);
+
   return (&OPENBL_I2C_Commands);
 }
 
@@ -181,6 +185,75 @@ void OPENBL_I2C_GetID(void)
   OPENBL_I2C_SendAcknowledgeByte(ACK_BYTE);
 }
 
+/**
+  * @brief  This function is used to negotiate the session parameters with the host.
+  * @note   The host sends its frame size, integrity modes and window depth, the device
+  *         answers with its capabilities, the selected parameters and its commands.
+  * @retval None.
+  */
+void OPENBL_I2C_Handshake(void)
+{
+  uint32_t counter;
+  uint32_t length;
+  uint8_t a_selection[COMMON_HANDSHAKE_SELECTION_SIZE];
+  uint8_t a_report[COMMON_HANDSHAKE_HEADER_SIZE];
+  uint8_t xor = 0U;
+
+  OPENBL_I2C_SendAcknowledgeByte(ACK_BYTE);
+
+  /* Wait for address to match */
+  OPENBL_I2C_WaitAddress();
+
+  /* Get the session parameters selected by the host */
+  for (counter = 0U; counter < COMMON_HANDSHAKE_SELECTION_SIZE; counter++)
+  {
+    a_selection[counter] = OPENBL_I2C_ReadByte();
+    xor ^= a_selection[counter];
+  }
+
+  /* Check data integrity */
+  if (OPENBL_I2C_ReadByte() != xor)
+  {
+    OPENBL_I2C_SendAcknowledgeByte(NACK_BYTE);
+  }
+  else
+  {
+    Common_SelectSession(a_selection);
+
+    OPENBL_I2C_SendAcknowledgeByte(ACK_BYTE);
+
+    /* Wait for address to match */
+    OPENBL_I2C_WaitAddress();
+
+    length = Common_SetHandshakeHeader(a_report, OPENBL_I2C_VERSION, 0U);
+
+    /* Send the number of bytes to follow - 1: the header, the number of commands and their list */
+    OPENBL_I2C_SendByte((uint8_t)(length + I2cCommandsNumber));
+
+    for (counter = 0U; counter < length; counter++)
+    {
+      OPENBL_I2C_SendByte(a_report[counter]);
+    }
+
+    /* Send the list of supported commands */
+    OPENBL_I2C_SendByte(I2cCommandsNumber);
+
+    for (counter = 0U; counter < I2cCommandsNumber; counter++)
+    {
+      OPENBL_I2C_SendByte(a_OPENBL_I2C_CommandsList[counter]);
+    }
+
+    /* Wait until NACK is detected */
+    OPENBL_I2C_WaitNack();
+
+    /* Wait until STOP is detected */
+    OPENBL_I2C_WaitStop();
+
+    /* Send last Acknowledge synchronization byte */
+    OPENBL_I2C_SendAcknowledgeByte(ACK_BYTE);
+  }
+}
+
 /**
  * @brief  This function is used to read memory from the device.
  * @retval None.
@@ -218,8 +291,8 @@ void OPENBL_I2C_ReadMemory(void)
       data = OPENBL_I2C_ReadByte();
       xor  = ~data;
 
-      /* Check data integrity */
-      if (OPENBL_I2C_ReadByte() != xor)
+      /* Check data integrity and the frame size selected for the session */
+      if ((OPENBL_I2C_ReadByte() != xor) || (Common_CheckFrameSize((uint32_t)data + 1U) == 0U))
       {
         OPENBL_I2C_SendAcknowledgeByte(NACK_BYTE);
       }
@@ -272,8 +345,8 @@ void OPENBL_I2C_WriteMemory(void)
   {
     OPENBL_I2C_SendAcknowledgeByte(ACK_BYTE);
 
-    /* Get the memory address */
-    if (OPENBL_I2C_GetAddress(&address) == NACK_BYTE)
+    /* Get the memory address, its first byte must be writable before the payload is accepted */
+    if ((OPENBL_I2C_GetAddress(&address) == NACK_BYTE) || (OPENBL_MEM_CheckWriteRange(address, 1U) == 0U))
     {
       OPENBL_I2C_SendAcknowledgeByte(NACK_BYTE);
     }
@@ -306,21 +379,40 @@ void OPENBL_I2C_WriteMemory(void)
         p_ramaddress++;
       }
 
-      /* Send NACk if Checksum is incorrect */
-      if (OPENBL_I2C_ReadByte() != xor)
+      /* Record the frame integrity, it drives the recommended frame size */
+      data = OPENBL_I2C_ReadByte();
+
+      if (data != xor)
+      {
+        Common_RecordLinkFrame(NACK_BYTE);
+      }
+      else
+      {
+        Common_RecordLinkFrame(ACK_BYTE);
+      }
+
+      /* Send NACk if Checksum is incorrect, if the frame exceeds the session frame size or if the whole range
+         cannot be written */
+      if ((data != xor) || (OPENBL_MEM_CheckWriteRange(address, codesize) == 0U)
+          || (Common_CheckFrameSize(codesize) == 0U))
       {
         OPENBL_I2C_SendAcknowledgeByte(NACK_BYTE);
       }
       else
       {
         /* Write data to memory */
-        OPENBL_MEM_Write(address, (uint8_t *)I2C_RAM_Buf, codesize);
-
-        /* Send last Acknowledge synchronization byte */
-        OPENBL_I2C_SendAcknowledgeByte(ACK_BYTE);
+        if (OPENBL_MEM_Write(address, (uint8_t *)I2C_RAM_Buf, codesize) == SUCCESS)
+        {
+          /* Send last Acknowledge synchronization byte */
+          OPENBL_I2C_SendAcknowledgeByte(ACK_BYTE);
 
-        /* Start post processing task if needed */
-        Common_StartPostProcessing();
+          /* Start post processing task if needed */
+          Common_StartPostProcessing();
+        }
+        else
+        {
+          OPENBL_I2C_SendAcknowledgeByte(NACK_BYTE);
+        }
       }
     }
   }
@@ -694,6 +786,7 @@ void OPENBL_I2C_NonStretchWriteMemory(void)
   uint32_t codesize;
   uint8_t *p_ramaddress;
   uint8_t data;
+  ErrorStatus status;
 
   /* Check memory protection then send adequate response */
   if (Common_GetProtectionStatus() != RESET)
@@ -704,8 +797,8 @@ void OPENBL_I2C_NonStretchWriteMemory(void)
   {
     OPENBL_I2C_SendAcknowledgeByte(ACK_BYTE);
 
-    /* Get the memory address */
-    if (OPENBL_I2C_GetAddress(&address) == NACK_BYTE)
+    /* Get the memory address, its first byte must be writable before the payload is accepted */
+    if ((OPENBL_I2C_GetAddress(&address) == NACK_BYTE) || (OPENBL_MEM_CheckWriteRange(address, 1U) == 0U))
     {
       OPENBL_I2C_SendAcknowledgeByte(NACK_BYTE);
     }
@@ -738,8 +831,22 @@ void OPENBL_I2C_NonStretchWriteMemory(void)
         p_ramaddress++;
       }
 
-      /* Send NACk if Checksum is incorrect */
-      if (OPENBL_I2C_ReadByte() != xor)
+      /* Record the frame integrity, it drives the recommended frame size */
+      data = OPENBL_I2C_ReadByte();
+
+      if (data != xor)
+      {
+        Common_RecordLinkFrame(NACK_BYTE);
+      }
+      else
+      {
+        Common_RecordLinkFrame(ACK_BYTE);
+      }
+
+      /* Send NACk if Checksum is incorrect, if the frame exceeds the session frame size or if the whole range
+         cannot be written */
+      if ((data != xor) || (OPENBL_MEM_CheckWriteRange(address, codesize) == 0U)
+          || (Common_CheckFrameSize(codesize) == 0U))
       {
         OPENBL_I2C_SendAcknowledgeByte(NACK_BYTE);
       }
@@ -749,16 +856,23 @@ void OPENBL_I2C_NonStretchWriteMemory(void)
         OPENBL_Enable_BusyState_Sending();
 
         /* Write data to memory */
-        OPENBL_MEM_Write(address, (uint8_t *)I2C_RAM_Buf, codesize);
+        status = OPENBL_MEM_Write(address, (uint8_t *)I2C_RAM_Buf, codesize);
 
         /* Send Busy Byte */
         OPENBL_Disable_BusyState_Sending();
 
-        /* Send last Acknowledge synchronization byte */
-        OPENBL_I2C_SendAcknowledgeByte(ACK_BYTE);
+        if (status == SUCCESS)
+        {
+          /* Send last Acknowledge synchronization byte */
+          OPENBL_I2C_SendAcknowledgeByte(ACK_BYTE);
 
-        /* Start post processing task if needed */
-        Common_StartPostProcessing();
+          /* Start post processing task if needed */
+          Common_StartPostProcessing();
+        }
+        else
+        {
+          OPENBL_I2C_SendAcknowledgeByte(NACK_BYTE);
+        }
       }
     }
   }
@@ -1404,6 +1518,22 @@ void OPENBL_I2C_ExtendedSpecialCommand(void)
   }
 }
 
+/**
+  * @brief  This function is used to get the usage of the stack and of the I2C RAM buffer.
+  * @param  pReport Pointer to the report to be filled, it must hold COMMON_RAM_USAGE_MAX_SIZE bytes.
+  * @retval Returns the size of the report.
+  */
+uint32_t OPENBL_I2C_GetRamUsage(uint8_t *pReport)
+{
+  uint32_t length;
+
+  length  = Common_SetRamUsageEntry(pReport, OPENBL_STACK_SIZE, Common_GetStackUsage());
+  length += Common_SetRamUsageEntry(&pReport[length], I2C_RAM_BUFFER_SIZE,
+                                    Common_GetBufferUsage(I2C_RAM_Buf, I2C_RAM_BUFFER_SIZE));
+
+  return length;
+}
+
 /* Private functions ---------------------------------------------------------*/
 
 /**
@@ -1432,6 +1562,12 @@ static uint8_t OPENBL_I2C_ConstructCommandsTable(OPENBL_CommandsTypeDef *pI2cCmd
     i++;
   }
 
+  if (pI2cCmd->Handshake != NULL)
+  {
+    a_OPENBL_I2C_CommandsList[i] = CMD_HANDSHAKE;
+    i++;
+  }
+
   if (pI2cCmd->ReadMemory != NULL)
   {
     a_OPENBL_I2C_CommandsList[i] = CMD_READ_MEMORY;
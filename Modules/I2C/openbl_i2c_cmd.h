@@ -35,6 +35,7 @@ void OPENBL_I2C_SetCommandsList(OPENBL_CommandsTypeDef *pI2cCmd);
 void OPENBL_I2C_GetCommand(void);
 void OPENBL_I2C_GetVersion(void);
 void OPENBL_I2C_GetID(void);
+void OPENBL_I2C_Handshake(void);
 void OPENBL_I2C_ReadMemory(void);
 void OPENBL_I2C_WriteMemory(void);
 void OPENBL_I2C_Go(void);
@@ -51,5 +52,6 @@ void OPENBL_I2C_NonStretchReadoutProtect(void);
 void OPENBL_I2C_NonStretchReadoutUnprotect(void);
 void OPENBL_I2C_SpecialCommand(void);
 void OPENBL_I2C_ExtendedSpecialCommand(void);
+uint32_t OPENBL_I2C_GetRamUsage(uint8_t *pReport);
 
 #endif /* OPENBL_I2C_CMD_H */
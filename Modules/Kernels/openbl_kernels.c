@@ -0,0 +1,263 @@
+/**
+  ******************************************************************************
+  * @file    openbl_kernels.c
+  * @author  MCD Application Team
+  * @brief   Provides word-wide checksum, compare and fill kernels
+  *          The kernels are plain C and build on the host as well as on the target,
+  *          where they are placed with the other hot paths.
+  *          The host builds define OPENBL_KERNELS_HOST.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "openbl_kernels.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define KERNEL_WORD_SIZE                  4U           /* Bytes processed per access in the kernels body */
+#define KERNEL_BYTE_LANES                 0x01010101U  /* Replicates a byte in the four lanes of a word */
+
+/* Private macro -------------------------------------------------------------*/
+#define KERNEL_IS_ALIGNED(p)              ((((uintptr_t)(p)) & (KERNEL_WORD_SIZE - 1U)) == 0U)
+
+/* Private variables ---------------------------------------------------------*/
+/* CRC32 of each nibble with the 0x04C11DB7 polynomial, MSB first */
+static const uint32_t a_Crc32Nibbles[16] =
+{
+  0x00000000U, 0x04C11DB7U, 0x09823B6EU, 0x0D4326D9U, 0x130476DCU, 0x17C56B6BU, 0x1A864DB2U, 0x1E475005U,
+  0x2608EDB8U, 0x22C9F00FU, 0x2F8AD6D6U, 0x2B4BCB61U, 0x350C9B64U, 0x31CD86D3U, 0x3C8EA00AU, 0x384FBDBDU
+};
+
+/* Private function prototypes -----------------------------------------------*/
+static inline uint32_t OPENBL_KERNEL_LoadWord(const uint8_t *pData);
+static inline void OPENBL_KERNEL_StoreWord(uint8_t *pData, uint32_t Word);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Read a word from a byte buffer.
+  * @note   The copy keeps the access valid for the aliasing rules, the compiler turns it
+  *         into a single load.
+  * @param  pData Pointer to the four bytes to be read.
+  * @retval Returns the word, in the byte order of the memory.
+  */
+static inline uint32_t OPENBL_KERNEL_LoadWord(const uint8_t *pData)
+{
+  uint32_t word;
+
+  (void)memcpy(&word, pData, KERNEL_WORD_SIZE);
+
+  return word;
+}
+
+/**
+  * @brief  Write a word to a byte buffer.
+  * @param  pData Pointer to the four bytes to be written.
+  * @param  Word The word to be written, in the byte order of the memory.
+  * @retval None.
+  */
+static inline void OPENBL_KERNEL_StoreWord(uint8_t *pData, uint32_t Word)
+{
+  (void)memcpy(pData, &Word, KERNEL_WORD_SIZE);
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Compute the XOR checksum of a buffer.
+  * @param  pData Pointer to the buffer.
+  * @param  Length Size of the buffer.
+  * @param  Seed Checksum of the bytes that precede the buffer, 0 if none.
+  * @retval Returns the XOR of the seed and of all the bytes of the buffer.
+  */
+OPENBL_HOT_PATH uint8_t OPENBL_KERNEL_Xor(const uint8_t *pData, uint32_t Length, uint8_t Seed)
+{
+  uint32_t xor = Seed;
+  uint32_t lanes = 0U;
+
+  while ((Length > 0U) && (!KERNEL_IS_ALIGNED(pData)))
+  {
+    xor ^= *pData;
+    pData++;
+    Length--;
+  }
+
+  /* Each byte lane accumulates its own checksum, they are folded at the end */
+  while (Length >= KERNEL_WORD_SIZE)
+  {
+    lanes  ^= OPENBL_KERNEL_LoadWord(pData);
+    pData  += KERNEL_WORD_SIZE;
+    Length -= KERNEL_WORD_SIZE;
+  }
+
+  while (Length > 0U)
+  {
+    xor ^= *pData;
+    pData++;
+    Length--;
+  }
+
+  lanes ^= lanes >> 16;
+  lanes ^= lanes >> 8;
+
+  return (uint8_t)((xor ^ lanes) & 0xFFU);
+}
+
+/**
+  * @brief  Compute the CRC32 of a buffer, as the CRC peripheral fed with 32-bit words.
+  * @note   Each word is read little-endian and processed MSB first, without reversal.
+  * @param  Crc CRC32 of the words that precede the buffer, OPENBL_KERNEL_CRC32_INIT if none.
+  * @param  pData Pointer to the buffer.
+  * @param  Length Size of the buffer, multiple of 4. The trailing bytes are ignored.
+  * @retval Returns the CRC32 of the buffer.
+  */
+OPENBL_HOT_PATH uint32_t OPENBL_KERNEL_Crc32(uint32_t Crc, const uint8_t *pData, uint32_t Length)
+{
+  uint32_t nibble;
+
+  while (Length >= KERNEL_WORD_SIZE)
+  {
+    Crc ^= (uint32_t)pData[0] | ((uint32_t)pData[1] << 8) | ((uint32_t)pData[2] << 16) | ((uint32_t)pData[3] << 24);
+
+    for (nibble = 0U; nibble < 8U; nibble++)
+    {
+      Crc = (Crc << 4) ^ a_Crc32Nibbles[Crc >> 28];
+    }
+
+    pData  += KERNEL_WORD_SIZE;
+    Length -= KERNEL_WORD_SIZE;
+  }
+
+  return Crc;
+}
+
+/**
+  * @brief  Find the first byte that differs between two buffers.
+  * @note   The buffers are compared word by word when they share the same alignment.
+  * @param  pData1 Pointer to the first buffer.
+  * @param  pData2 Pointer to the second buffer.
+  * @param  Length Size of the buffers.
+  * @retval Returns the offset of the first different byte, Length if the buffers are identical.
+  */
+OPENBL_HOT_PATH uint32_t OPENBL_KERNEL_FindDifference(const uint8_t *pData1, const uint8_t *pData2, uint32_t Length)
+{
+  uint32_t offset = 0U;
+
+  if ((((uintptr_t)pData1 ^ (uintptr_t)pData2) & (KERNEL_WORD_SIZE - 1U)) == 0U)
+  {
+    while ((offset < Length) && (!KERNEL_IS_ALIGNED(&pData1[offset])) && (pData1[offset] == pData2[offset]))
+    {
+      offset++;
+    }
+
+    if (KERNEL_IS_ALIGNED(&pData1[offset]))
+    {
+      while (((Length - offset) >= KERNEL_WORD_SIZE)
+             && (OPENBL_KERNEL_LoadWord(&pData1[offset]) == OPENBL_KERNEL_LoadWord(&pData2[offset])))
+      {
+        offset += KERNEL_WORD_SIZE;
+      }
+    }
+  }
+
+  /* Locate the byte within the first different word, or compare buffers of different alignments */
+  while ((offset < Length) && (pData1[offset] == pData2[offset]))
+  {
+    offset++;
+  }
+
+  return offset;
+}
+
+/**
+  * @brief  Compare two buffers.
+  * @note   Built on OPENBL_KERNEL_FindDifference, which also locates the first difference.
+  * @param  pData1 Pointer to the first buffer.
+  * @param  pData2 Pointer to the second buffer.
+  * @param  Length Size of the buffers.
+  * @retval Returns 0 if the buffers are identical else returns 1.
+  */
+OPENBL_HOT_PATH uint32_t OPENBL_KERNEL_Compare(const uint8_t *pData1, const uint8_t *pData2, uint32_t Length)
+{
+  return (OPENBL_KERNEL_FindDifference(pData1, pData2, Length) == Length) ? 0U : 1U;
+}
+
+/**
+  * @brief  Check that all the bytes of a buffer hold a given value, e.g. 0xFF for a blank check.
+  * @param  pData Pointer to the buffer.
+  * @param  Length Size of the buffer.
+  * @param  Value The expected value of the bytes.
+  * @retval Returns 1 if all the bytes hold the value else returns 0.
+  */
+OPENBL_HOT_PATH uint32_t OPENBL_KERNEL_IsFilled(const uint8_t *pData, uint32_t Length, uint8_t Value)
+{
+  uint32_t pattern = (uint32_t)Value * KERNEL_BYTE_LANES;
+  uint32_t difference = 0U;
+
+  while ((Length > 0U) && (!KERNEL_IS_ALIGNED(pData)))
+  {
+    difference |= (uint32_t)(*pData ^ Value);
+    pData++;
+    Length--;
+  }
+
+  while ((Length >= KERNEL_WORD_SIZE) && (difference == 0U))
+  {
+    difference |= OPENBL_KERNEL_LoadWord(pData) ^ pattern;
+    pData      += KERNEL_WORD_SIZE;
+    Length     -= KERNEL_WORD_SIZE;
+  }
+
+  while ((Length > 0U) && (difference == 0U))
+  {
+    difference |= (uint32_t)(*pData ^ Value);
+    pData++;
+    Length--;
+  }
+
+  return (difference == 0U) ? 1U : 0U;
+}
+
+/**
+  * @brief  Set all the bytes of a buffer to a given value.
+  * @param  pData Pointer to the buffer.
+  * @param  Length Size of the buffer.
+  * @param  Value The value to be written.
+  * @retval None.
+  */
+OPENBL_HOT_PATH void OPENBL_KERNEL_Fill(uint8_t *pData, uint32_t Length, uint8_t Value)
+{
+  uint32_t pattern = (uint32_t)Value * KERNEL_BYTE_LANES;
+
+  while ((Length > 0U) && (!KERNEL_IS_ALIGNED(pData)))
+  {
+    *pData = Value;
+    pData++;
+    Length--;
+  }
+
+  while (Length >= KERNEL_WORD_SIZE)
+  {
+    OPENBL_KERNEL_StoreWord(pData, pattern);
+    pData  += KERNEL_WORD_SIZE;
+    Length -= KERNEL_WORD_SIZE;
+  }
+
+  while (Length > 0U)
+  {
+    *pData = Value;
+    pData++;
+    Length--;
+  }
+}
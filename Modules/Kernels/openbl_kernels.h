@@ -0,0 +1,55 @@
+/**
+  ******************************************************************************
+  * @file    openbl_kernels.h
+  * @author  MCD Application Team
+  * @brief   Header for openbl_kernels.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef OPENBL_KERNELS_H
+#define OPENBL_KERNELS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#if !defined (OPENBL_KERNELS_HOST)
+#include "platform.h"
+#include "common_interface.h"
+#endif /* OPENBL_KERNELS_HOST */
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+#define OPENBL_KERNEL_CRC32_INIT          0xFFFFFFFFU  /* Initial value of the CRC32, as the CRC peripheral */
+
+/* Exported macro ------------------------------------------------------------*/
+#if defined (OPENBL_KERNELS_HOST)
+#define OPENBL_HOT_PATH                   /* The host builds keep the kernels in the default code section */
+#endif /* OPENBL_KERNELS_HOST */
+
+/* Exported functions ------------------------------------------------------- */
+OPENBL_HOT_PATH uint8_t OPENBL_KERNEL_Xor(const uint8_t *pData, uint32_t Length, uint8_t Seed);
+OPENBL_HOT_PATH uint32_t OPENBL_KERNEL_Crc32(uint32_t Crc, const uint8_t *pData, uint32_t Length);
+OPENBL_HOT_PATH uint32_t OPENBL_KERNEL_FindDifference(const uint8_t *pData1, const uint8_t *pData2, uint32_t Length);
+OPENBL_HOT_PATH uint32_t OPENBL_KERNEL_Compare(const uint8_t *pData1, const uint8_t *pData2, uint32_t Length);
+OPENBL_HOT_PATH uint32_t OPENBL_KERNEL_IsFilled(const uint8_t *pData, uint32_t Length, uint8_t Value);
+OPENBL_HOT_PATH void OPENBL_KERNEL_Fill(uint8_t *pData, uint32_t Length, uint8_t Value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OPENBL_KERNELS_H */
@@ -19,17 +19,57 @@
 /* Includes ------------------------------------------------------------------*/
 #include "openbl_mem.h"
 #include "openbl_core.h"
+#include "openbl_kernels.h"
+#include "common_interface.h"
 
 #include "interfaces_conf.h"
 
 /* Private typedef -----------------------------------------------------------*/
+#if (OPENBL_MEM_CACHE_SLOTS > 0U)
+typedef struct
+{
+  uint32_t PageAddress;                               /*!< Start address of the cached page */
+  uint32_t MemoryIndex;                               /*!< Index of the memory that contains the page */
+  uint32_t LastUse;                                   /*!< Age stamp used to evict the least recently used slot */
+  uint32_t WrittenLines;                              /*!< Number of lines that received data */
+  uint8_t Written[OPENBL_MEM_CACHE_PAGE_SIZE / 128U]; /*!< Bitmap of the 16-byte lines that received data */
+  uint8_t Data[OPENBL_MEM_CACHE_PAGE_SIZE];           /*!< Page content merged from the received frames */
+} OPENBL_MEM_CacheSlotTypeDef;
+#endif /* (OPENBL_MEM_CACHE_SLOTS > 0U) */
+
+typedef struct
+{
+  uint32_t MemoryIndex;               /*!< Index of the memory being erased */
+  uint32_t NextPage;                  /*!< Next page to be erased */
+  uint32_t RemainingPages;            /*!< Number of pages left to be erased, 0 if no erase is suspended */
+  ErrorStatus Status;                 /*!< Status of the pages erased so far */
+} OPENBL_MEM_EraseJobTypeDef;
+
 /* Private define ------------------------------------------------------------*/
+#define MEM_CACHE_LINE_SIZE               16U  /* Programming granularity: quad-word */
+#define MEM_CACHE_LINES_NB                (OPENBL_MEM_CACHE_PAGE_SIZE / MEM_CACHE_LINE_SIZE)
+#define MEM_CACHE_FREE_SLOT               0x00000000U  /* Page address of a free slot, never a FLASH address */
+
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 static uint32_t NumberOfMemories = 0;
 static OPENBL_MemoryTypeDef a_MemoriesTable[MEMORIES_SUPPORTED];
+static OPENBL_MEM_EraseJobTypeDef EraseJob = {0U, 0U, 0U, SUCCESS};
+
+#if (OPENBL_MEM_CACHE_SLOTS > 0U)
+static OPENBL_MEM_CacheSlotTypeDef a_CacheSlots[OPENBL_MEM_CACHE_SLOTS];
+static uint32_t CacheUsedSlots = 0U;
+static uint32_t CacheAge = 0U;
+static ErrorStatus CacheStatus = SUCCESS;
+#endif /* (OPENBL_MEM_CACHE_SLOTS > 0U) */
 
 /* Private function prototypes -----------------------------------------------*/
+#if (OPENBL_MEM_CACHE_SLOTS > 0U)
+static void OPENBL_MEM_CacheWrite(uint32_t MemoryIndex, uint32_t Address, uint8_t *Data, uint32_t DataLength);
+static OPENBL_MEM_CacheSlotTypeDef *OPENBL_MEM_CacheGetSlot(uint32_t MemoryIndex, uint32_t PageAddress);
+static void OPENBL_MEM_CacheProgramSlot(OPENBL_MEM_CacheSlotTypeDef *pSlot);
+#endif /* (OPENBL_MEM_CACHE_SLOTS > 0U) */
+
 /* Exported variables --------------------------------------------------------*/
 /* Exported functions --------------------------------------------------------*/
 
@@ -124,6 +164,20 @@ uint8_t OPENBL_MEM_Read(uint32_t Address, uint32_t MemoryIndex)
 {
   uint8_t value;
 
+  /* Other memories stay readable while an erase is suspended, the erased one is completed first */
+  if ((EraseJob.RemainingPages != 0U) && (EraseJob.MemoryIndex == MemoryIndex))
+  {
+    OPENBL_MEM_CompleteErase();
+  }
+
+#if (OPENBL_MEM_CACHE_SLOTS > 0U)
+  /* Make the pending pages visible before reading them back */
+  if (CacheUsedSlots != 0U)
+  {
+    OPENBL_MEM_Flush();
+  }
+#endif /* (OPENBL_MEM_CACHE_SLOTS > 0U) */
+
   if (MemoryIndex < NumberOfMemories)
   {
     if (a_MemoriesTable[MemoryIndex].Read != NULL)
@@ -145,14 +199,23 @@ uint8_t OPENBL_MEM_Read(uint32_t Address, uint32_t MemoryIndex)
 
 /**
   * @brief  This function is used to write data in to a given memory.
+  * @note   With the write cache, the FLASH data may only be programmed by a later call or by
+  *         OPENBL_MEM_Flush. The returned status covers the pages programmed by this call.
   * @param  Address The address where that data will be written.
   * @param  Data The data to be written.
   * @param  DataLength The length of the data to be written.
-  * @retval None.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: Write operation done
+  *          - ERROR:   No memory can be written at this address, the write failed or a programmed
+  *                     page is corrupted
   */
-void OPENBL_MEM_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength)
+ErrorStatus OPENBL_MEM_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength)
 {
   uint32_t index;
+  ErrorStatus status = ERROR;
+
+  /* Finish the suspended erase before writing */
+  OPENBL_MEM_CompleteErase();
 
   /* Get the memory index to know in which memory we will write */
   index = OPENBL_MEM_GetMemoryIndex(Address);
@@ -161,9 +224,58 @@ void OPENBL_MEM_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength)
   {
     if (a_MemoriesTable[index].Write != NULL)
     {
-      a_MemoriesTable[index].Write(Address, Data, DataLength);
+#if (OPENBL_MEM_CACHE_SLOTS > 0U)
+      /* FLASH frames are merged in the page cache and programmed once their page is complete */
+      if (a_MemoriesTable[index].Type == FLASH_AREA)
+      {
+        OPENBL_MEM_CacheWrite(index, Address, Data, DataLength);
+
+        status      = CacheStatus;
+        CacheStatus = SUCCESS;
+      }
+      else
+#endif /* (OPENBL_MEM_CACHE_SLOTS > 0U) */
+      {
+        status = a_MemoriesTable[index].Write(Address, Data, DataLength);
+
+        /* The FLASH is memory mapped, the programmed data are also compared in place */
+        if ((status == SUCCESS) && (a_MemoriesTable[index].Type == FLASH_AREA)
+            && (OPENBL_KERNEL_Compare((const uint8_t *)Address, Data, DataLength) != 0U))
+        {
+          status = ERROR;
+        }
+      }
+    }
+  }
+
+  return status;
+}
+
+/**
+  * @brief  This function is used to program all the pages pending in the write cache.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: All the pending pages are programmed, or none was pending
+  *          - ERROR:   A programmed page is corrupted
+  */
+ErrorStatus OPENBL_MEM_Flush(void)
+{
+  ErrorStatus status = SUCCESS;
+#if (OPENBL_MEM_CACHE_SLOTS > 0U)
+  uint32_t counter;
+
+  for (counter = 0U; counter < OPENBL_MEM_CACHE_SLOTS; counter++)
+  {
+    if (a_CacheSlots[counter].PageAddress != MEM_CACHE_FREE_SLOT)
+    {
+      OPENBL_MEM_CacheProgramSlot(&a_CacheSlots[counter]);
     }
   }
+
+  status      = CacheStatus;
+  CacheStatus = SUCCESS;
+#endif /* (OPENBL_MEM_CACHE_SLOTS > 0U) */
+
+  return status;
 }
 
 /**
@@ -176,6 +288,10 @@ void OPENBL_MEM_SetReadOutProtection(uint32_t Address, FunctionalState State)
 {
   uint32_t index;
 
+  /* Program the pending pages and finish the suspended erase before changing the memory state */
+  OPENBL_MEM_Flush();
+  OPENBL_MEM_CompleteErase();
+
   /* Get the memory index to know in which memory we will write */
   index = OPENBL_MEM_GetMemoryIndex(Address);
 
@@ -210,12 +326,20 @@ void OPENBL_MEM_SetReadOutProtection(uint32_t Address, FunctionalState State)
 ErrorStatus OPENBL_MEM_SetWriteProtection(FunctionalState State, uint32_t Address, uint8_t *Buffer, uint32_t Length)
 {
   uint32_t index;
-  ErrorStatus status = SUCCESS;
+  ErrorStatus status;
+
+  /* Program the pending pages and finish the suspended erase before changing the memory state */
+  status = OPENBL_MEM_Flush();
+  OPENBL_MEM_CompleteErase();
 
   /* Get the memory index to know in which memory we will write */
   index = OPENBL_MEM_GetMemoryIndex(Address);
 
-  if (index < NumberOfMemories)
+  if (status != SUCCESS)
+  {
+    /* Report the failure of the pending pages rather than changing the protection */
+  }
+  else if (index < NumberOfMemories)
   {
     if (a_MemoriesTable[index].SetWriteProtect != NULL)
     {
@@ -243,6 +367,10 @@ void OPENBL_MEM_JumpToAddress(uint32_t Address)
 {
   uint32_t memory_index;
 
+  /* Program the pending pages and finish the suspended erase before changing the memory state */
+  OPENBL_MEM_Flush();
+  OPENBL_MEM_CompleteErase();
+
   /* Get the memory index to know from which memory interface we will used */
   memory_index = OPENBL_MEM_GetMemoryIndex(Address);
 
@@ -269,10 +397,18 @@ ErrorStatus OPENBL_MEM_MassErase(uint32_t Address, uint8_t *p_Data, uint32_t Dat
   uint32_t memory_index;
   ErrorStatus status;
 
+  /* Program the pending pages and finish the suspended erase before changing the memory state */
+  status = OPENBL_MEM_Flush();
+  OPENBL_MEM_CompleteErase();
+
   /* Get the memory index to know from which memory interface we will used */
   memory_index = OPENBL_MEM_GetMemoryIndex(Address);
 
-  if (memory_index < NumberOfMemories)
+  if (status != SUCCESS)
+  {
+    /* Report the failure of the pending pages rather than erasing over them */
+  }
+  else if (memory_index < NumberOfMemories)
   {
     if (a_MemoriesTable[memory_index].MassErase != NULL)
     {
@@ -305,10 +441,18 @@ ErrorStatus OPENBL_MEM_Erase(uint32_t Address, uint8_t *p_Data, uint32_t DataLen
   uint32_t memory_index;
   ErrorStatus status;
 
+  /* Program the pending pages and finish the suspended erase before changing the memory state */
+  status = OPENBL_MEM_Flush();
+  OPENBL_MEM_CompleteErase();
+
   /* Get the memory index to know from which memory interface we will used */
   memory_index = OPENBL_MEM_GetMemoryIndex(Address);
 
-  if (memory_index < NumberOfMemories)
+  if (status != SUCCESS)
+  {
+    /* Report the failure of the pending pages rather than erasing over them */
+  }
+  else if (memory_index < NumberOfMemories)
   {
     if (a_MemoriesTable[memory_index].Erase != NULL)
     {
@@ -351,3 +495,304 @@ uint8_t OPENBL_MEM_CheckJumpAddress(uint32_t Address)
 
   return status;
 }
+
+/**
+  * @brief  Check if a given range is inside a single memory that can be written.
+  * @note   Used by the write commands to reject a misdirected frame before its payload is received.
+  *         The range must not overlap a write protected area either.
+  * @param  Address The start address of the range.
+  * @param  DataLength The length of the range.
+  * @retval Returns 1 if the range can be written else returns 0.
+  */
+uint8_t OPENBL_MEM_CheckWriteRange(uint32_t Address, uint32_t DataLength)
+{
+  uint32_t memory_index;
+  uint8_t status = 0U;
+
+  /* Get the memory index to know in which memory the range starts */
+  memory_index = OPENBL_MEM_GetMemoryIndex(Address);
+
+  if (memory_index < NumberOfMemories)
+  {
+    /* The range must not cross the end of the memory that contains its start address */
+    if ((a_MemoriesTable[memory_index].Write != NULL)
+        && (DataLength <= (a_MemoriesTable[memory_index].EndAddress - Address))
+        && (Common_GetWriteProtectionStatus(Address, DataLength) == RESET))
+    {
+      status = 1U;
+    }
+  }
+
+  return status;
+}
+
+/**
+  * @brief  This function is used to prepare an erase that runs by slices of pages.
+  * @note   Nothing is erased here, the pages are erased by OPENBL_MEM_ResumeErase(). Between two
+  *         slices the erase is suspended and the other memories can be read. Any other access
+  *         to the memories completes the erase first.
+  * @param  Address The address of the memory to be erased.
+  * @param  FirstPage The first page to be erased.
+  * @param  PagesNumber The number of pages to be erased.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: The erase is ready to be resumed
+  *          - ERROR:   The memory cannot be erased
+  */
+ErrorStatus OPENBL_MEM_StartSuspendableErase(uint32_t Address, uint32_t FirstPage, uint32_t PagesNumber)
+{
+  uint32_t memory_index;
+  ErrorStatus status;
+
+  /* Program the pending pages and finish the previous erase */
+  status = OPENBL_MEM_Flush();
+  OPENBL_MEM_CompleteErase();
+
+  memory_index = OPENBL_MEM_GetMemoryIndex(Address);
+
+  if (status != SUCCESS)
+  {
+    /* Report the failure of the pending pages rather than erasing over them */
+  }
+  else if ((memory_index < NumberOfMemories) && (a_MemoriesTable[memory_index].Erase != NULL))
+  {
+    EraseJob.MemoryIndex    = memory_index;
+    EraseJob.NextPage       = FirstPage;
+    EraseJob.RemainingPages = PagesNumber;
+    EraseJob.Status         = SUCCESS;
+
+    status = SUCCESS;
+  }
+  else
+  {
+    status = ERROR;
+  }
+
+  return status;
+}
+
+/**
+  * @brief  This function is used to resume the suspended erase for a slice of pages.
+  * @note   The FLASH page reserved for the image metadata is skipped.
+  * @param  PagesNumber The maximum number of pages to be erased before suspending again.
+  * @retval An ErrorStatus enumeration value:
+  *          - SUCCESS: All the pages erased so far are erased
+  *          - ERROR:   At least one page erase failed
+  */
+ErrorStatus OPENBL_MEM_ResumeErase(uint32_t PagesNumber)
+{
+  uint16_t a_erase_option[2];
+  uint32_t counter = PagesNumber;
+
+  while ((EraseJob.RemainingPages != 0U) && (counter != 0U))
+  {
+    /* Single page erase request, in the format of the erase command */
+    a_erase_option[0] = 1U;
+    a_erase_option[1] = (uint16_t)EraseJob.NextPage;
+
+    if ((a_MemoriesTable[EraseJob.MemoryIndex].StartAddress == OPENBL_DEFAULT_MEM)
+        && (EraseJob.NextPage == OPENBL_METADATA_PAGE))
+    {
+      /* The erase requests reject the metadata page, the caller erases it on its own */
+    }
+    else if (a_MemoriesTable[EraseJob.MemoryIndex].Erase((uint8_t *)a_erase_option, sizeof(a_erase_option)) != SUCCESS)
+    {
+      EraseJob.Status = ERROR;
+    }
+
+    EraseJob.NextPage++;
+    EraseJob.RemainingPages--;
+    counter--;
+  }
+
+  return EraseJob.Status;
+}
+
+/**
+  * @brief  This function is used to erase all the pages left by the suspended erase.
+  * @retval None.
+  */
+void OPENBL_MEM_CompleteErase(void)
+{
+  if (EraseJob.RemainingPages != 0U)
+  {
+    (void)OPENBL_MEM_ResumeErase(EraseJob.RemainingPages);
+  }
+}
+
+/**
+  * @brief  This function returns the number of pages left by the suspended erase.
+  * @retval Returns 0 if no erase is suspended.
+  */
+uint32_t OPENBL_MEM_GetSuspendedErasePages(void)
+{
+  return EraseJob.RemainingPages;
+}
+
+/* Private functions ---------------------------------------------------------*/
+#if (OPENBL_MEM_CACHE_SLOTS > 0U)
+/**
+  * @brief  This function is used to merge data in the write cache.
+  * @param  MemoryIndex The index of the memory where the data will be written.
+  * @param  Address The address where that data will be written.
+  * @param  Data The data to be written.
+  * @param  DataLength The length of the data to be written.
+  * @retval None.
+  */
+static void OPENBL_MEM_CacheWrite(uint32_t MemoryIndex, uint32_t Address, uint8_t *Data, uint32_t DataLength)
+{
+  uint32_t index;
+  uint32_t line;
+  uint32_t offset;
+  uint32_t length;
+  OPENBL_MEM_CacheSlotTypeDef *p_slot;
+
+  while (DataLength > 0U)
+  {
+    offset = Address & (OPENBL_MEM_CACHE_PAGE_SIZE - 1U);
+    length = OPENBL_MEM_CACHE_PAGE_SIZE - offset;
+
+    if (length > DataLength)
+    {
+      length = DataLength;
+    }
+
+    p_slot = OPENBL_MEM_CacheGetSlot(MemoryIndex, (Address - offset));
+
+    for (index = 0U; index < length; index++)
+    {
+      p_slot->Data[offset + index] = Data[index];
+    }
+
+    for (line = (offset / MEM_CACHE_LINE_SIZE); line <= ((offset + length - 1U) / MEM_CACHE_LINE_SIZE); line++)
+    {
+      if ((p_slot->Written[line / 8U] & (1U << (line % 8U))) == 0U)
+      {
+        p_slot->Written[line / 8U] |= (uint8_t)(1U << (line % 8U));
+        p_slot->WrittenLines++;
+      }
+    }
+
+    /* The page is complete: program it right away */
+    if (p_slot->WrittenLines == MEM_CACHE_LINES_NB)
+    {
+      OPENBL_MEM_CacheProgramSlot(p_slot);
+    }
+
+    Address    += length;
+    Data       += length;
+    DataLength -= length;
+  }
+}
+
+/**
+  * @brief  This function is used to get the cache slot of a page, allocating it if needed.
+  * @note   When no slot is free, the least recently used one is programmed and reused.
+  * @param  MemoryIndex The index of the memory that contains the page.
+  * @param  PageAddress The start address of the page.
+  * @retval Returns a pointer to the cache slot.
+  */
+static OPENBL_MEM_CacheSlotTypeDef *OPENBL_MEM_CacheGetSlot(uint32_t MemoryIndex, uint32_t PageAddress)
+{
+  uint32_t counter;
+  OPENBL_MEM_CacheSlotTypeDef *p_slot = NULL;
+  OPENBL_MEM_CacheSlotTypeDef *p_victim = &a_CacheSlots[0];
+
+  for (counter = 0U; counter < OPENBL_MEM_CACHE_SLOTS; counter++)
+  {
+    if (a_CacheSlots[counter].PageAddress == PageAddress)
+    {
+      p_slot = &a_CacheSlots[counter];
+      break;
+    }
+
+    if (p_victim->PageAddress != MEM_CACHE_FREE_SLOT)
+    {
+      if ((a_CacheSlots[counter].PageAddress == MEM_CACHE_FREE_SLOT)
+          || (a_CacheSlots[counter].LastUse < p_victim->LastUse))
+      {
+        p_victim = &a_CacheSlots[counter];
+      }
+    }
+  }
+
+  if (p_slot == NULL)
+  {
+    p_slot = p_victim;
+
+    if (p_slot->PageAddress != MEM_CACHE_FREE_SLOT)
+    {
+      OPENBL_MEM_CacheProgramSlot(p_slot);
+    }
+
+    p_slot->PageAddress  = PageAddress;
+    p_slot->MemoryIndex  = MemoryIndex;
+    p_slot->WrittenLines = 0U;
+
+    OPENBL_KERNEL_Fill(p_slot->Written, (MEM_CACHE_LINES_NB / 8U), 0U);
+
+    /* The bytes that are not received keep the erased value */
+    OPENBL_KERNEL_Fill(p_slot->Data, OPENBL_MEM_CACHE_PAGE_SIZE, 0xFFU);
+
+    CacheUsedSlots++;
+  }
+
+  CacheAge++;
+  p_slot->LastUse = CacheAge;
+
+  return p_slot;
+}
+
+/**
+  * @brief  This function is used to program the lines of a cache slot that received data, then free it.
+  * @note   Consecutive lines are programmed with a single memory write, then read back. A write
+  *         failure or a mismatch is kept in CacheStatus until reported by OPENBL_MEM_Write or
+  *         OPENBL_MEM_Flush.
+  * @param  pSlot Pointer to the cache slot.
+  * @retval None.
+  */
+static void OPENBL_MEM_CacheProgramSlot(OPENBL_MEM_CacheSlotTypeDef *pSlot)
+{
+  uint32_t line;
+  uint32_t first_line;
+  uint32_t address;
+  uint32_t length;
+
+  line = 0U;
+
+  /* The slot is programmed on eviction or flush, the host polling is answered meanwhile */
+  OPENBL_Enable_BusyState_Sending();
+
+  while (line < MEM_CACHE_LINES_NB)
+  {
+    if ((pSlot->Written[line / 8U] & (1U << (line % 8U))) == 0U)
+    {
+      line++;
+    }
+    else
+    {
+      first_line = line;
+
+      while ((line < MEM_CACHE_LINES_NB) && ((pSlot->Written[line / 8U] & (1U << (line % 8U))) != 0U))
+      {
+        line++;
+      }
+
+      address = pSlot->PageAddress + (first_line * MEM_CACHE_LINE_SIZE);
+      length  = (line - first_line) * MEM_CACHE_LINE_SIZE;
+
+      /* The FLASH is memory mapped, the programmed lines are also compared in place */
+      if ((a_MemoriesTable[pSlot->MemoryIndex].Write(address, &pSlot->Data[first_line * MEM_CACHE_LINE_SIZE], length)
+           != SUCCESS)
+          || (OPENBL_KERNEL_Compare((const uint8_t *)address, &pSlot->Data[first_line * MEM_CACHE_LINE_SIZE], length) != 0U))
+      {
+        CacheStatus = ERROR;
+      }
+    }
+  }
+
+  OPENBL_Disable_BusyState_Sending();
+
+  pSlot->PageAddress = MEM_CACHE_FREE_SLOT;
+  CacheUsedSlots--;
+}
+#endif /* (OPENBL_MEM_CACHE_SLOTS > 0U) */
@@ -31,7 +31,7 @@ typedef struct
   uint32_t Size;
   uint32_t Type;
   uint8_t (*Read)(uint32_t Address);
-  void (*Write)(uint32_t Address, uint8_t *Data, uint32_t DataLength);
+  ErrorStatus(*Write)(uint32_t Address, uint8_t *Data, uint32_t DataLength);
   void (*SetReadoutProtect)(uint32_t State);
   ErrorStatus(*SetWriteProtect)(FunctionalState State, uint8_t *Buffer, uint32_t Length);
   void (*JumpToAddress)(uint32_t Address);
@@ -44,16 +44,22 @@ typedef struct
 /* Exported functions ------------------------------------------------------- */
 void OPENBL_MEM_JumpToAddress(uint32_t Address);
 void OPENBL_MEM_SetReadOutProtection(uint32_t Address, FunctionalState State);
-void OPENBL_MEM_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength);
+void OPENBL_MEM_CompleteErase(void);
 
 uint8_t OPENBL_MEM_Read(uint32_t Address, uint32_t MemoryIndex);
 uint32_t OPENBL_MEM_GetAddressArea(uint32_t Address);
 uint32_t OPENBL_MEM_GetMemoryIndex(uint32_t Address);
 uint8_t OPENBL_MEM_CheckJumpAddress(uint32_t Address);
+uint8_t OPENBL_MEM_CheckWriteRange(uint32_t Address, uint32_t DataLength);
+uint32_t OPENBL_MEM_GetSuspendedErasePages(void);
 
+ErrorStatus OPENBL_MEM_Write(uint32_t Address, uint8_t *Data, uint32_t DataLength);
+ErrorStatus OPENBL_MEM_Flush(void);
 ErrorStatus OPENBL_MEM_Erase(uint32_t Address, uint8_t *p_Data, uint32_t DataLength);
 ErrorStatus OPENBL_MEM_MassErase(uint32_t Address, uint8_t *p_Data, uint32_t DataLength);
 ErrorStatus OPENBL_MEM_RegisterMemory(OPENBL_MemoryTypeDef *Memory);
 ErrorStatus OPENBL_MEM_SetWriteProtection(FunctionalState State, uint32_t Address, uint8_t *Buffer, uint32_t Length);
+ErrorStatus OPENBL_MEM_StartSuspendableErase(uint32_t Address, uint32_t FirstPage, uint32_t PagesNumber);
+ErrorStatus OPENBL_MEM_ResumeErase(uint32_t PagesNumber);
 
 #endif /* OPENBL_MEM_H */
@@ -24,10 +24,11 @@
 #include "app_openbootloader.h"
 #include "spi_interface.h"
 #include "common_interface.h"
+#include "openbl_kernels.h"
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
-#define OPENBL_SPI_COMMANDS_NB_MAX        13U  /* Number of supported commands */
+#define OPENBL_SPI_COMMANDS_NB_MAX        14U  /* Number of supported commands */
 #define SPI_RAM_BUFFER_SIZE               1164U  /* Size of SPI buffer used to store received data from the host */
 
 /* Private macro -------------------------------------------------------------*/
@@ -74,11 +75,15 @@ OPENBL_CommandsTypeDef *OPENBL_SPI_GetCommandsList(void)
     NULL,
     NULL,
     OPENBL_SPI_SpecialCommand,
-    OPENBL_SPI_ExtendedSpecialCommand
+    OPENBL_SPI_ExtendedSpecialCommand,
+    OPENBL_SPI_Handshake
   };
 
   OPENBL_SPI_SetCommandsList(&OPENBL_SPI_Commands);
 
+  /* Paint the RAM buffer to measure its usage */
+  Common_PaintBuffer(SPI_RAM_Buf, SPI_RAM_BUFFER_SIZE);
+
   return (&OPENBL_SPI_Commands);
 }
 
@@ -100,7 +105,7 @@ void OPENBL_SPI_GetCommand(void)
 {
   uint32_t counter;
 
-  OPENBL_SPI_SendAcknowledgeByte(ACK_BYTE);
+  OPENBL_SPI_SendStatusByte(ACK_BYTE);
 
   /* Send the number of commands supported by the SPI protocol */
   OPENBL_SPI_SendByte(SpiCommandsNumber);
@@ -125,7 +130,7 @@ void OPENBL_SPI_GetCommand(void)
 void OPENBL_SPI_GetVersion(void)
 {
   /* Send Acknowledge byte to notify the host that the command is recognized */
-  OPENBL_SPI_SendAcknowledgeByte(ACK_BYTE);
+  OPENBL_SPI_SendStatusByte(ACK_BYTE);
 
   /* Send SPI protocol version */
   OPENBL_SPI_SendByte(OPENBL_SPI_VERSION);
@@ -141,7 +146,7 @@ void OPENBL_SPI_GetVersion(void)
 void OPENBL_SPI_GetID(void)
 {
   /* Send Acknowledge byte to notify the host that the command is recognized */
-  OPENBL_SPI_SendAcknowledgeByte(ACK_BYTE);
+  OPENBL_SPI_SendStatusByte(ACK_BYTE);
 
   OPENBL_SPI_SendByte(0x01);
 
@@ -153,6 +158,63 @@ void OPENBL_SPI_GetID(void)
   OPENBL_SPI_SendAcknowledgeByte(ACK_BYTE);
 }
 
+/**
+  * @brief  This function is used to negotiate the session parameters with the host.
+  * @note   The host sends its frame size, integrity modes and window depth, the device
+  *         answers with its capabilities, the selected parameters and its commands.
+  * @retval None.
+  */
+void OPENBL_SPI_Handshake(void)
+{
+  uint32_t counter;
+  uint32_t length;
+  uint8_t a_selection[COMMON_HANDSHAKE_SELECTION_SIZE];
+  uint8_t a_report[COMMON_HANDSHAKE_HEADER_SIZE];
+  uint8_t xor = 0U;
+
+  OPENBL_SPI_SendAcknowledgeByte(ACK_BYTE);
+
+  /* Get the session parameters selected by the host */
+  for (counter = 0U; counter < COMMON_HANDSHAKE_SELECTION_SIZE; counter++)
+  {
+    a_selection[counter] = OPENBL_SPI_ReadByte();
+    xor ^= a_selection[counter];
+  }
+
+  /* Check data integrity */
+  if (OPENBL_SPI_ReadByte() != xor)
+  {
+    OPENBL_SPI_SendAcknowledgeByte(NACK_BYTE);
+  }
+  else
+  {
+    Common_SelectSession(a_selection);
+
+    OPENBL_SPI_SendStatusByte(ACK_BYTE);
+
+    length = Common_SetHandshakeHeader(a_report, OPENBL_SPI_VERSION, 0U);
+
+    /* Send the number of bytes to follow - 1: the header, the number of commands and their list */
+    OPENBL_SPI_SendByte((uint8_t)(length + SpiCommandsNumber));
+
+    for (counter = 0U; counter < length; counter++)
+    {
+      OPENBL_SPI_SendByte(a_report[counter]);
+    }
+
+    /* Send the list of supported commands */
+    OPENBL_SPI_SendByte(SpiCommandsNumber);
+
+    for (counter = 0U; counter < SpiCommandsNumber; counter++)
+    {
+      OPENBL_SPI_SendByte(a_OPENBL_SPI_CommandsList[counter]);
+    }
+
+    /* Send last Acknowledge synchronization byte */
+    OPENBL_SPI_SendAcknowledgeByte(ACK_BYTE);
+  }
+}
+
 /**
  * @brief  This function is used to read memory from the device.
  * @retval None.
@@ -187,14 +249,14 @@ void OPENBL_SPI_ReadMemory(void)
       data = OPENBL_SPI_ReadByte();
       xor  = ~data;
 
-      /* Check data integrity */
-      if (OPENBL_SPI_ReadByte() != xor)
+      /* Check data integrity and the frame size selected for the session */
+      if ((OPENBL_SPI_ReadByte() != xor) || (Common_CheckFrameSize((uint32_t)data + 1U) == 0U))
       {
         OPENBL_SPI_SendAcknowledgeByte(NACK_BYTE);
       }
       else
       {
-        OPENBL_SPI_SendAcknowledgeByte(ACK_BYTE);
+        OPENBL_SPI_SendStatusByte(ACK_BYTE);
 
         /* Get the memory index to know from which memory we will read */
         memory_index = OPENBL_MEM_GetMemoryIndex(address);
@@ -218,7 +280,6 @@ void OPENBL_SPI_WriteMemory(void)
 {
   uint32_t address;
   uint32_t xor;
-  uint32_t counter;
   uint32_t codesize;
   uint8_t *ramaddress;
   uint8_t data;
@@ -232,8 +293,8 @@ void OPENBL_SPI_WriteMemory(void)
   {
     OPENBL_SPI_SendAcknowledgeByte(ACK_BYTE);
 
-    /* Get the memory address */
-    if (OPENBL_SPI_GetAddress(&address) == NACK_BYTE)
+    /* Get the memory address, its first byte must be writable before the payload is accepted */
+    if ((OPENBL_SPI_GetAddress(&address) == NACK_BYTE) || (OPENBL_MEM_CheckWriteRange(address, 1U) == 0U))
     {
       OPENBL_SPI_SendAcknowledgeByte(NACK_BYTE);
     }
@@ -250,35 +311,46 @@ void OPENBL_SPI_WriteMemory(void)
       /* Number of data to be written = data + 1 */
       codesize = (uint32_t)data + 1U;
 
-      /* Checksum Initialization */
-      xor = data;
+      /* SPI receive data in RAM Buffer, four bytes per RXDR access */
+      OPENBL_SPI_ReadBytes(ramaddress, codesize);
 
-      /* SPI receive data and send to RAM Buffer */
-      for (counter = codesize; counter != 0U ; counter--)
-      {
-        data  = OPENBL_SPI_ReadByte();
-        xor  ^= data;
+      /* Checksum of the size byte then of the data */
+      xor = OPENBL_KERNEL_Xor(ramaddress, codesize, (uint8_t)data);
 
-        *(__IO uint8_t *)(ramaddress) = data;
+      /* Record the frame integrity, it drives the recommended frame size */
+      data = OPENBL_SPI_ReadByte();
 
-        ramaddress++;
+      if (data != xor)
+      {
+        Common_RecordLinkFrame(NACK_BYTE);
+      }
+      else
+      {
+        Common_RecordLinkFrame(ACK_BYTE);
       }
 
-      /* Send NACk if Checksum is incorrect */
-      if (OPENBL_SPI_ReadByte() != xor)
+      /* Send NACk if Checksum is incorrect, if the frame exceeds the session frame size or if the whole range
+         cannot be written */
+      if ((data != xor) || (OPENBL_MEM_CheckWriteRange(address, codesize) == 0U)
+          || (Common_CheckFrameSize(codesize) == 0U))
       {
         OPENBL_SPI_SendAcknowledgeByte(NACK_BYTE);
       }
       else
       {
         /* Write data to memory */
-        OPENBL_MEM_Write(address, (uint8_t *)SPI_RAM_Buf, codesize);
-
-        /* Send last Acknowledge synchronization byte */
-        OPENBL_SPI_SendAcknowledgeByte(ACK_BYTE);
+        if (OPENBL_MEM_Write(address, (uint8_t *)SPI_RAM_Buf, codesize) == SUCCESS)
+        {
+          /* Send last Acknowledge synchronization byte */
+          OPENBL_SPI_SendStatusByte(ACK_BYTE);
 
-        /* Launch Option Bytes reload */
-        Common_StartPostProcessing();
+          /* Launch Option Bytes reload */
+          Common_StartPostProcessing();
+        }
+        else
+        {
+          OPENBL_SPI_SendStatusByte(NACK_BYTE);
+        }
       }
     }
   }
@@ -319,7 +391,7 @@ void OPENBL_SPI_Go(void)
       else
       {
         /* If the jump address is valid then send ACK */
-        OPENBL_SPI_SendAcknowledgeByte(ACK_BYTE);
+        OPENBL_SPI_SendStatusByte(ACK_BYTE);
 
         OPENBL_MEM_JumpToAddress(address);
       }
@@ -345,7 +417,7 @@ void OPENBL_SPI_ReadoutProtect(void)
     /* Enable the read protection */
     OPENBL_MEM_SetReadOutProtection(OPENBL_DEFAULT_MEM, ENABLE);
 
-    OPENBL_SPI_SendAcknowledgeByte(ACK_BYTE);
+    OPENBL_SPI_SendStatusByte(ACK_BYTE);
 
     /* Launch Option Bytes reload */
     Common_StartPostProcessing();
@@ -363,7 +435,7 @@ void OPENBL_SPI_ReadoutUnprotect(void)
 {
   OPENBL_SPI_SendAcknowledgeByte(ACK_BYTE);
 
-  OPENBL_SPI_SendAcknowledgeByte(ACK_BYTE);
+  OPENBL_SPI_SendStatusByte(ACK_BYTE);
 
   /* Disable the read protection */
   OPENBL_MEM_SetReadOutProtection(OPENBL_DEFAULT_MEM, DISABLE);
@@ -516,7 +588,7 @@ void OPENBL_SPI_EraseMemory(void)
       }
     }
 
-    OPENBL_SPI_SendAcknowledgeByte(status);
+    OPENBL_SPI_SendStatusByte(status);
   }
 }
 
@@ -584,7 +656,7 @@ void OPENBL_SPI_WriteProtect(void)
         /* Enable the write protection */
         error_value = OPENBL_MEM_SetWriteProtection(ENABLE, OPENBL_DEFAULT_MEM, ramaddress, length);
 
-        OPENBL_SPI_SendAcknowledgeByte(ACK_BYTE);
+        OPENBL_SPI_SendStatusByte(ACK_BYTE);
 
         if (error_value == SUCCESS)
         {
@@ -615,7 +687,7 @@ void OPENBL_SPI_WriteUnprotect(void)
     /* Disable write protection */
     error_value = OPENBL_MEM_SetWriteProtection(DISABLE, OPENBL_DEFAULT_MEM, NULL, 0);
 
-    OPENBL_SPI_SendAcknowledgeByte(ACK_BYTE);
+    OPENBL_SPI_SendStatusByte(ACK_BYTE);
 
     if (error_value == SUCCESS)
     {
@@ -736,7 +808,7 @@ void OPENBL_SPI_SpecialCommand(void)
       else
       {
         /* Send received size acknowledgment */
-        OPENBL_SPI_SendAcknowledgeByte(ACK_BYTE);
+        OPENBL_SPI_SendStatusByte(ACK_BYTE);
 
         /* Process the special command */
         OPENBL_SPI_SpecialCommandProcess(special_cmd);
@@ -859,7 +931,7 @@ void OPENBL_SPI_ExtendedSpecialCommand(void)
           else
           {
             /* Send receive write size acknowledgment */
-            OPENBL_SPI_SendAcknowledgeByte(ACK_BYTE);
+            OPENBL_SPI_SendStatusByte(ACK_BYTE);
 
             /* Process the special command */
             OPENBL_SPI_SpecialCommandProcess(special_cmd);
@@ -873,6 +945,22 @@ void OPENBL_SPI_ExtendedSpecialCommand(void)
   }
 }
 
+/**
+  * @brief  This function is used to get the usage of the stack and of the SPI RAM buffer.
+  * @param  pReport Pointer to the report to be filled, it must hold COMMON_RAM_USAGE_MAX_SIZE bytes.
+  * @retval Returns the size of the report.
+  */
+uint32_t OPENBL_SPI_GetRamUsage(uint8_t *pReport)
+{
+  uint32_t length;
+
+  length  = Common_SetRamUsageEntry(pReport, OPENBL_STACK_SIZE, Common_GetStackUsage());
+  length += Common_SetRamUsageEntry(&pReport[length], SPI_RAM_BUFFER_SIZE,
+                                    Common_GetBufferUsage(SPI_RAM_Buf, SPI_RAM_BUFFER_SIZE));
+
+  return length;
+}
+
 /* Private functions ---------------------------------------------------------*/
 
 /**
@@ -901,6 +989,12 @@ static uint8_t OPENBL_SPI_ConstructCommandsTable(OPENBL_CommandsTypeDef *pSpiCmd
     i++;
   }
 
+  if (pSpiCmd->Handshake != NULL)
+  {
+    a_OPENBL_SPI_CommandsList[i] = CMD_HANDSHAKE;
+    i++;
+  }
+
   if (pSpiCmd->ReadMemory != NULL)
   {
     a_OPENBL_SPI_CommandsList[i] = CMD_READ_MEMORY;
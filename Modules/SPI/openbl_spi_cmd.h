@@ -35,6 +35,7 @@ void OPENBL_SPI_SetCommandsList(OPENBL_CommandsTypeDef *pSpiCmd);
 void OPENBL_SPI_GetCommand(void);
 void OPENBL_SPI_GetVersion(void);
 void OPENBL_SPI_GetID(void);
+void OPENBL_SPI_Handshake(void);
 void OPENBL_SPI_ReadMemory(void);
 void OPENBL_SPI_WriteMemory(void);
 void OPENBL_SPI_Go(void);
@@ -45,5 +46,6 @@ void OPENBL_SPI_WriteProtect(void);
 void OPENBL_SPI_WriteUnprotect(void);
 void OPENBL_SPI_SpecialCommand(void);
 void OPENBL_SPI_ExtendedSpecialCommand(void);
+uint32_t OPENBL_SPI_GetRamUsage(uint8_t *pReport);
 
 #endif /* OPENBL_SPI_CMD_H */
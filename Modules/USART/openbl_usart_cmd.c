@@ -24,10 +24,11 @@
 #include "app_openbootloader.h"
 #include "usart_interface.h"
 #include "common_interface.h"
+#include "openbl_kernels.h"
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
-#define OPENBL_USART_COMMANDS_NB_MAX      13U       /* The maximum number of supported commands */
+#define OPENBL_USART_COMMANDS_NB_MAX      14U       /* The maximum number of supported commands */
 
 #define USART_RAM_BUFFER_SIZE             1164U     /* Size of USART buffer used to store received data from the host */
 
@@ -74,11 +75,15 @@ OPENBL_CommandsTypeDef *OPENBL_USART_GetCommandsList(void)
     NULL,
     NULL,
     OPENBL_USART_SpecialCommand,
-    OPENBL_USART_ExtendedSpecialCommand
+    OPENBL_USART_ExtendedSpecialCommand,
+    OPENBL_USART_Handshake
   };
 
   OPENBL_USART_SetCommandsList(&OPENBL_USART_Commands);
 
+  /* Paint the RAM buffer to measure its usage */
+  Common_PaintBuffer(USART_RAM_Buf, USART_RAM_BUFFER_SIZE);
+
   return (&OPENBL_USART_Commands);
 }
 
@@ -156,6 +161,64 @@ void OPENBL_USART_GetID(void)
   OPENBL_USART_SendByte(ACK_BYTE);
 }
 
+/**
+  * @brief  This function is used to negotiate the session parameters with the host.
+  * @note   The host sends its frame size, integrity modes and window depth, the device
+  *         answers with its capabilities, the selected parameters and its commands.
+  * @retval None.
+  */
+void OPENBL_USART_Handshake(void)
+{
+  uint32_t counter;
+  uint32_t length;
+  uint8_t a_selection[COMMON_HANDSHAKE_SELECTION_SIZE];
+  uint8_t a_report[COMMON_HANDSHAKE_HEADER_SIZE];
+  uint8_t xor = 0U;
+
+  /* Send Acknowledge byte to notify the host that the command is recognized */
+  OPENBL_USART_SendByte(ACK_BYTE);
+
+  /* Get the session parameters selected by the host */
+  for (counter = 0U; counter < COMMON_HANDSHAKE_SELECTION_SIZE; counter++)
+  {
+    a_selection[counter] = OPENBL_USART_ReadByte();
+    xor ^= a_selection[counter];
+  }
+
+  /* Check data integrity */
+  if (OPENBL_USART_ReadByte() != xor)
+  {
+    OPENBL_USART_SendByte(NACK_BYTE);
+  }
+  else
+  {
+    Common_SelectSession(a_selection);
+
+    OPENBL_USART_SendByte(ACK_BYTE);
+
+    length = Common_SetHandshakeHeader(a_report, OPENBL_USART_VERSION, 0U);
+
+    /* Send the number of bytes to follow - 1: the header, the number of commands and their list */
+    OPENBL_USART_SendByte((uint8_t)(length + UsartCommandsNumber));
+
+    for (counter = 0U; counter < length; counter++)
+    {
+      OPENBL_USART_SendByte(a_report[counter]);
+    }
+
+    /* Send the list of supported commands */
+    OPENBL_USART_SendByte(UsartCommandsNumber);
+
+    for (counter = 0U; counter < UsartCommandsNumber; counter++)
+    {
+      OPENBL_USART_SendByte(a_OPENBL_USART_CommandsList[counter]);
+    }
+
+    /* Send last Acknowledge synchronization byte */
+    OPENBL_USART_SendByte(ACK_BYTE);
+  }
+}
+
 /**
  * @brief  This function is used to read memory from the device.
  * @retval None.
@@ -190,8 +253,8 @@ void OPENBL_USART_ReadMemory(void)
       data = OPENBL_USART_ReadByte();
       xor  = ~data;
 
-      /* Check data integrity */
-      if (OPENBL_USART_ReadByte() != xor)
+      /* Check data integrity and the frame size selected for the session */
+      if ((OPENBL_USART_ReadByte() != xor) || (Common_CheckFrameSize((uint32_t)data + 1U) == 0U))
       {
         OPENBL_USART_SendByte(NACK_BYTE);
       }
@@ -221,10 +284,11 @@ void OPENBL_USART_WriteMemory(void)
 {
   uint32_t address;
   uint32_t tmpXOR;
-  uint32_t counter;
   uint32_t codesize;
   uint8_t *ramaddress;
   uint8_t data;
+  ErrorStatus rx_status;
+  ErrorStatus status;
 
   /* Check memory protection then send adequate response */
   if (Common_GetProtectionStatus() != RESET)
@@ -235,8 +299,8 @@ void OPENBL_USART_WriteMemory(void)
   {
     OPENBL_USART_SendByte(ACK_BYTE);
 
-    /* Get the memory address */
-    if (OPENBL_USART_GetAddress(&address) == NACK_BYTE)
+    /* Get the memory address, its first byte must be writable before the payload is accepted */
+    if ((OPENBL_USART_GetAddress(&address) == NACK_BYTE) || (OPENBL_MEM_CheckWriteRange(address, 1U) == 0U))
     {
       OPENBL_USART_SendByte(NACK_BYTE);
     }
@@ -253,35 +317,52 @@ void OPENBL_USART_WriteMemory(void)
       /* Number of data to be written = data + 1 */
       codesize = (uint32_t)data + 1U;
 
-      /* Checksum Initialization */
-      tmpXOR = data;
+      /* Receive the data and their checksum in one block, a stalled host is NACKed at once */
+      rx_status = OPENBL_USART_ReadBytes(ramaddress, codesize + 1U);
 
-      /* UART receive data and send to RAM Buffer */
-      for (counter = codesize; counter != 0U ; counter--)
-      {
-        data    = OPENBL_USART_ReadByte();
-        tmpXOR ^= data;
+      /* The checksum covers the number of bytes then the data */
+      tmpXOR = OPENBL_KERNEL_Xor(ramaddress, codesize, data);
 
-        *(__IO uint8_t *)(ramaddress) = data;
-
-        ramaddress++;
+      /* Record the frame integrity, it drives the recommended frame size */
+      if ((rx_status == ERROR) || (ramaddress[codesize] != (uint8_t)tmpXOR))
+      {
+        Common_RecordLinkFrame(NACK_BYTE);
+      }
+      else
+      {
+        Common_RecordLinkFrame(ACK_BYTE);
       }
 
-      /* Send NACk if Checksum is incorrect */
-      if (OPENBL_USART_ReadByte() != tmpXOR)
+      /* Send NACk if the block is incomplete, if Checksum is incorrect, if the frame exceeds the session frame
+         size or if the whole range cannot be written */
+      if ((rx_status == ERROR) || (ramaddress[codesize] != (uint8_t)tmpXOR)
+          || (OPENBL_MEM_CheckWriteRange(address, codesize) == 0U)
+          || (Common_CheckFrameSize(codesize) == 0U))
       {
         OPENBL_USART_SendByte(NACK_BYTE);
       }
       else
       {
+        /* Answer the host polling with the busy state */
+        OPENBL_Enable_BusyState_Sending();
+
         /* Write data to memory */
-        OPENBL_MEM_Write(address, (uint8_t *)USART_RAM_Buf, codesize);
+        status = OPENBL_MEM_Write(address, (uint8_t *)USART_RAM_Buf, codesize);
 
-        /* Send last Acknowledge synchronization byte */
-        OPENBL_USART_SendByte(ACK_BYTE);
+        OPENBL_Disable_BusyState_Sending();
 
-        /* Start post processing task if needed */
-        Common_StartPostProcessing();
+        if (status == SUCCESS)
+        {
+          /* Send last Acknowledge synchronization byte */
+          OPENBL_USART_SendByte(ACK_BYTE);
+
+          /* Start post processing task if needed */
+          Common_StartPostProcessing();
+        }
+        else
+        {
+          OPENBL_USART_SendByte(NACK_BYTE);
+        }
       }
     }
   }
@@ -423,8 +504,13 @@ void OPENBL_USART_EraseMemory(void)
           ramaddress[0] = (uint8_t)(data & 0x00FFU);
           ramaddress[1] = (uint8_t)((data & 0xFF00U) >> 8);
 
+          /* Answer the host polling with the busy state */
+          OPENBL_Enable_BusyState_Sending();
+
           error_value = OPENBL_MEM_MassErase(OPENBL_DEFAULT_MEM, (uint8_t *) USART_RAM_Buf, USART_RAM_BUFFER_SIZE);
 
+          OPENBL_Disable_BusyState_Sending();
+
           if (error_value == SUCCESS)
           {
             status = ACK_BYTE;
@@ -488,8 +574,13 @@ void OPENBL_USART_EraseMemory(void)
       }
       else
       {
+        /* Answer the host polling with the busy state */
+        OPENBL_Enable_BusyState_Sending();
+
         error_value = OPENBL_MEM_Erase(OPENBL_DEFAULT_MEM, (uint8_t *) USART_RAM_Buf, USART_RAM_BUFFER_SIZE);
 
+        OPENBL_Disable_BusyState_Sending();
+
         /* Errors from memory erase are not managed, always return ACK */
         if (error_value == SUCCESS)
         {
@@ -842,6 +933,22 @@ void OPENBL_USART_ExtendedSpecialCommand(void)
   }
 }
 
+/**
+  * @brief  This function is used to get the usage of the stack and of the USART RAM buffer.
+  * @param  pReport Pointer to the report to be filled, it must hold COMMON_RAM_USAGE_MAX_SIZE bytes.
+  * @retval Returns the size of the report.
+  */
+uint32_t OPENBL_USART_GetRamUsage(uint8_t *pReport)
+{
+  uint32_t length;
+
+  length  = Common_SetRamUsageEntry(pReport, OPENBL_STACK_SIZE, Common_GetStackUsage());
+  length += Common_SetRamUsageEntry(&pReport[length], USART_RAM_BUFFER_SIZE,
+                                    Common_GetBufferUsage(USART_RAM_Buf, USART_RAM_BUFFER_SIZE));
+
+  return length;
+}
+
 /* Private functions ---------------------------------------------------------*/
 
 /**
@@ -870,6 +977,12 @@ static uint8_t OPENBL_USART_ConstructCommandsTable(OPENBL_CommandsTypeDef *pUsar
     i++;
   }
 
+  if (pUsartCmd->Handshake != NULL)
+  {
+    a_OPENBL_USART_CommandsList[i] = CMD_HANDSHAKE;
+    i++;
+  }
+
   if (pUsartCmd->ReadMemory != NULL)
   {
     a_OPENBL_USART_CommandsList[i] = CMD_READ_MEMORY;
@@ -35,6 +35,7 @@ void OPENBL_USART_SetCommandsList(OPENBL_CommandsTypeDef *pUsartCmd);
 void OPENBL_USART_GetCommand(void);
 void OPENBL_USART_GetVersion(void);
 void OPENBL_USART_GetID(void);
+void OPENBL_USART_Handshake(void);
 void OPENBL_USART_ReadMemory(void);
 void OPENBL_USART_WriteMemory(void);
 void OPENBL_USART_Go(void);
@@ -45,5 +46,6 @@ void OPENBL_USART_WriteProtect(void);
 void OPENBL_USART_WriteUnprotect(void);
 void OPENBL_USART_SpecialCommand(void);
 void OPENBL_USART_ExtendedSpecialCommand(void);
+uint32_t OPENBL_USART_GetRamUsage(uint8_t *pReport);
 
 #endif /* OPENBL_USART_CMD_H */
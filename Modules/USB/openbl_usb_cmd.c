@@ -65,7 +65,8 @@ uint16_t OPENBL_USB_EraseMemory(uint32_t Address)
   *ramaddress = (uint8_t)((page & 0xFF00U) >> 8);
   ramaddress++;
 
-  error_value = OPENBL_MEM_Erase(OPENBL_DEFAULT_MEM, (uint8_t *) usb_ram_buffer, USB_RAM_BUFFER_SIZE);
+  /* The erase is routed to the memory that holds the sector, FLASH or external NOR */
+  error_value = OPENBL_MEM_Erase(Address, (uint8_t *) usb_ram_buffer, USB_RAM_BUFFER_SIZE);
 
   if (error_value != SUCCESS)
   {
@@ -84,19 +85,29 @@ uint16_t OPENBL_USB_EraseMemory(uint32_t Address)
   * @param  pSrc: Pointer to the source buffer. Address to be written to.
   * @param  pDest: Pointer to the destination buffer.
   * @param  Length: Number of data to be written (in bytes).
-  * @retval USBD_OK if operation is successful, MAL_FAIL else.
+  * @retval Returns 0 if the write operation is successful else returns 1.
   */
-void OPENBL_USB_WriteMemory(uint8_t *pSrc, uint8_t *pDest, uint32_t Length)
+uint8_t OPENBL_USB_WriteMemory(uint8_t *pSrc, uint8_t *pDest, uint32_t Length)
 {
   uint32_t address;
+  uint8_t status;
 
   address = (uint32_t)pDest[0] | ((uint32_t)pDest[1] << 8) |
             ((uint32_t)pDest[2] << 16) | ((uint32_t)pDest[3] << 24);
 
-  OPENBL_MEM_Write(address, pSrc, Length);
+  if (OPENBL_MEM_Write(address, pSrc, Length) != SUCCESS)
+  {
+    status = 1U;
+  }
+  else
+  {
+    status = 0U;
+
+    /* Start post processing task if needed */
+    Common_StartPostProcessing();
+  }
 
-  /* Start post processing task if needed */
-  Common_StartPostProcessing();
+  return status;
 }
 
 /**
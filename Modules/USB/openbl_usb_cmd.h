@@ -27,7 +27,7 @@ extern "C" {
 #include "openbl_core.h"
 
 uint16_t OPENBL_USB_EraseMemory(uint32_t Add);
-void OPENBL_USB_WriteMemory(uint8_t *pSrc, uint8_t *pDest, uint32_t Length);
+uint8_t OPENBL_USB_WriteMemory(uint8_t *pSrc, uint8_t *pDest, uint32_t Length);
 uint8_t *OPENBL_USB_ReadMemory(uint8_t *pSrc, uint8_t *pDest, uint32_t Length);
 void OPENBL_USB_Jump(uint32_t Address);
 void OPENBL_USB_WriteProtect(uint8_t *pBuffer, uint32_t Length);
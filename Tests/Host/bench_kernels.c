@@ -0,0 +1,247 @@
+/**
+  ******************************************************************************
+  * @file    bench_kernels.c
+  * @author  MCD Application Team
+  * @brief   Host microbenchmarks of the checksum, compare and fill kernels against
+  *          the byte loops they replace, on aligned and unaligned buffers
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include <time.h>
+#include "host_test.h"
+#include "platform.h"
+#include "openbl_kernels.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* A benchmark runs a kernel or its byte loop once on the buffers and returns its result */
+typedef uint32_t (*BENCH_FunctionTypeDef)(const uint8_t *pData1, uint8_t *pData2, uint32_t Length);
+
+typedef struct
+{
+  const char *pName;
+  BENCH_FunctionTypeDef Kernel;
+  BENCH_FunctionTypeDef Reference;
+} BENCH_KernelTypeDef;
+
+/* Private define ------------------------------------------------------------*/
+#define BENCH_BUFFER_SIZE                 8192U  /* A FLASH page of the write cache */
+#define BENCH_ROUNDS                      200U   /* Runs of each variant, the time is their average */
+#define BENCH_OFFSETS_NB                  2U     /* Word aligned, then one byte off */
+#define BENCH_CRC_POLYNOMIAL              0x04C11DB7U
+#define BENCH_FILL_BYTE                   0xFFU
+
+/* Private variables ---------------------------------------------------------*/
+static uint32_t a_Buffer1[(BENCH_BUFFER_SIZE / 4U) + 1U];
+static uint32_t a_Buffer2[(BENCH_BUFFER_SIZE / 4U) + 1U];
+
+/* The results are accumulated here, so that no run is optimized away */
+static volatile uint32_t BenchSink;
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint32_t BENCH_Xor(const uint8_t *pData1, uint8_t *pData2, uint32_t Length)
+{
+  (void)pData2;
+
+  return OPENBL_KERNEL_Xor(pData1, Length, 0U);
+}
+
+static uint32_t BENCH_XorBytes(const uint8_t *pData1, uint8_t *pData2, uint32_t Length)
+{
+  uint32_t index;
+  uint8_t xor = 0U;
+
+  (void)pData2;
+
+  for (index = 0U; index < Length; index++)
+  {
+    xor ^= pData1[index];
+  }
+
+  return xor;
+}
+
+static uint32_t BENCH_Crc32(const uint8_t *pData1, uint8_t *pData2, uint32_t Length)
+{
+  (void)pData2;
+
+  return OPENBL_KERNEL_Crc32(OPENBL_KERNEL_CRC32_INIT, pData1, Length);
+}
+
+/* The bit loop of a CRC computed without table, as the CRC peripheral */
+static uint32_t BENCH_Crc32Bits(const uint8_t *pData1, uint8_t *pData2, uint32_t Length)
+{
+  uint32_t crc = OPENBL_KERNEL_CRC32_INIT;
+  uint32_t word;
+  uint32_t index;
+  uint32_t bit;
+
+  (void)pData2;
+
+  for (index = 0U; (index + 4U) <= Length; index += 4U)
+  {
+    word = (uint32_t)pData1[index] | ((uint32_t)pData1[index + 1U] << 8) | ((uint32_t)pData1[index + 2U] << 16)
+           | ((uint32_t)pData1[index + 3U] << 24);
+
+    for (bit = 0U; bit < 32U; bit++)
+    {
+      crc = (((crc ^ (word << bit)) & 0x80000000U) != 0U) ? ((crc << 1) ^ BENCH_CRC_POLYNOMIAL) : (crc << 1);
+    }
+  }
+
+  return crc;
+}
+
+static uint32_t BENCH_FindDifference(const uint8_t *pData1, uint8_t *pData2, uint32_t Length)
+{
+  return OPENBL_KERNEL_FindDifference(pData1, pData2, Length);
+}
+
+static uint32_t BENCH_FindDifferenceBytes(const uint8_t *pData1, uint8_t *pData2, uint32_t Length)
+{
+  uint32_t offset = 0U;
+
+  while ((offset < Length) && (pData1[offset] == pData2[offset]))
+  {
+    offset++;
+  }
+
+  return offset;
+}
+
+static uint32_t BENCH_IsFilled(const uint8_t *pData1, uint8_t *pData2, uint32_t Length)
+{
+  (void)pData2;
+
+  return OPENBL_KERNEL_IsFilled(pData1, Length, BENCH_FILL_BYTE);
+}
+
+static uint32_t BENCH_IsFilledBytes(const uint8_t *pData1, uint8_t *pData2, uint32_t Length)
+{
+  uint32_t index;
+  uint32_t filled = 1U;
+
+  (void)pData2;
+
+  for (index = 0U; (index < Length) && (filled == 1U); index++)
+  {
+    filled = (pData1[index] == BENCH_FILL_BYTE) ? 1U : 0U;
+  }
+
+  return filled;
+}
+
+static uint32_t BENCH_Fill(const uint8_t *pData1, uint8_t *pData2, uint32_t Length)
+{
+  (void)pData1;
+
+  OPENBL_KERNEL_Fill(pData2, Length, BENCH_FILL_BYTE);
+
+  return pData2[Length - 1U];
+}
+
+static uint32_t BENCH_FillBytes(const uint8_t *pData1, uint8_t *pData2, uint32_t Length)
+{
+  uint32_t index;
+
+  (void)pData1;
+
+  for (index = 0U; index < Length; index++)
+  {
+    pData2[index] = BENCH_FILL_BYTE;
+  }
+
+  return pData2[Length - 1U];
+}
+
+/**
+  * @brief  Measure the average time of a benchmark.
+  * @param  Function The benchmark to be run.
+  * @param  pData1 Pointer to the first buffer.
+  * @param  pData2 Pointer to the second buffer.
+  * @param  pResult Pointer to the result of the last run.
+  * @retval Returns the time of one run in ns.
+  */
+static uint32_t BENCH_Measure(BENCH_FunctionTypeDef Function, const uint8_t *pData1, uint8_t *pData2,
+                              uint32_t *pResult)
+{
+  struct timespec start;
+  struct timespec end;
+  uint32_t round;
+  uint64_t elapsed;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &start);
+
+  for (round = 0U; round < BENCH_ROUNDS; round++)
+  {
+    *pResult   = Function(pData1, pData2, BENCH_BUFFER_SIZE);
+    BenchSink += *pResult;
+  }
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &end);
+
+  elapsed = ((uint64_t)(end.tv_sec - start.tv_sec) * 1000000000U) + (uint64_t)end.tv_nsec - (uint64_t)start.tv_nsec;
+
+  return (uint32_t)(elapsed / BENCH_ROUNDS);
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+int main(void)
+{
+  static const BENCH_KernelTypeDef a_kernels[] =
+  {
+    {"Xor",            BENCH_Xor,            BENCH_XorBytes},
+    {"Crc32",          BENCH_Crc32,          BENCH_Crc32Bits},
+    {"FindDifference", BENCH_FindDifference, BENCH_FindDifferenceBytes},
+    {"IsFilled",       BENCH_IsFilled,       BENCH_IsFilledBytes},
+    {"Fill",           BENCH_Fill,           BENCH_FillBytes}
+  };
+  uint8_t *p_data1;
+  uint8_t *p_data2;
+  uint32_t index;
+  uint32_t offset;
+  uint32_t kernel_time;
+  uint32_t reference_time;
+  uint32_t kernel_result;
+  uint32_t reference_result;
+
+  printf("bench_kernels: %u bytes, ns per run, kernel against byte loop\n", BENCH_BUFFER_SIZE);
+
+  for (index = 0U; index < (sizeof(a_kernels) / sizeof(a_kernels[0])); index++)
+  {
+    for (offset = 0U; offset < BENCH_OFFSETS_NB; offset++)
+    {
+      p_data1 = (uint8_t *)a_Buffer1 + offset;
+      p_data2 = (uint8_t *)a_Buffer2 + offset;
+
+      /* Blank buffers run the compare and the blank check to their end */
+      memset(a_Buffer1, BENCH_FILL_BYTE, sizeof(a_Buffer1));
+      memset(a_Buffer2, BENCH_FILL_BYTE, sizeof(a_Buffer2));
+
+      kernel_time    = BENCH_Measure(a_kernels[index].Kernel, p_data1, p_data2, &kernel_result);
+      reference_time = BENCH_Measure(a_kernels[index].Reference, p_data1, p_data2, &reference_result);
+
+      HOST_TEST_CHECK(kernel_result == reference_result);
+
+      printf("bench_kernels:   %-14s %-9s %8u %8u (x%u.%02u)\n", a_kernels[index].pName,
+             (offset == 0U) ? "aligned" : "unaligned", kernel_time, reference_time,
+             reference_time / ((kernel_time != 0U) ? kernel_time : 1U),
+             ((reference_time * 100U) / ((kernel_time != 0U) ? kernel_time : 1U)) % 100U);
+    }
+  }
+
+  return HOST_TEST_RESULT("bench_kernels");
+}
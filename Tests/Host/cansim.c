@@ -0,0 +1,643 @@
+/**
+  ******************************************************************************
+  * @file    cansim.c
+  * @author  MCD Application Team
+  * @brief   Simulated FDCAN controller in classic CAN mode, attached to a simulated
+  *          bus on which the test plays the host
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "platform.h"
+#include "interfaces_conf.h"
+#include "cansim.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  CANSIM_FrameTypeDef a_Frames[CANSIM_RX_FIFO_SIZE];  /*!< Received frames */
+  uint32_t GetIndex;                                  /*!< Oldest frame */
+  uint32_t Count;                                     /*!< Number of frames */
+  uint32_t Flag;                                      /*!< New message flag of the FIFO */
+} CANSIM_RxFifoTypeDef;
+
+typedef struct
+{
+  CANSIM_FrameTypeDef a_Frames[1024];                 /*!< Queued frames */
+  uint32_t GetIndex;                                  /*!< Oldest frame */
+  uint32_t Count;                                     /*!< Number of frames */
+} CANSIM_QueueTypeDef;
+
+typedef enum
+{
+  CANSIM_BUS_IDLE   = 0x00U,
+  CANSIM_BUS_DEVICE = 0x01U,  /* The device sends the frame of a Tx buffer */
+  CANSIM_BUS_HOST   = 0x02U   /* The host sends a frame */
+} CANSIM_BusStateTypeDef;
+
+/* Private define ------------------------------------------------------------*/
+#define CANSIM_ELEMENT_WORDS              18U  /* Words of a Tx buffer element: header and 64 bytes */
+#define CANSIM_FRAME_OVERHEAD             47U  /* Bits of a standard data frame without data, stuff bits not counted */
+#define CANSIM_FILTERS_MAX                2U   /* Standard filters supported */
+#define CANSIM_QUEUE_SIZE                 1024U
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static uint32_t a_TxRam[CANSIM_TX_BUFFERS_MAX * CANSIM_ELEMENT_WORDS];
+static uint32_t TxBuffersNumber = CANSIM_TX_BUFFERS_MAX;
+static uint32_t TxGetIndex = 0U;
+static uint32_t TxCount = 0U;
+static CANSIM_RxFifoTypeDef a_RxFifos[2];
+static FDCAN_FilterTypeDef a_Filters[CANSIM_FILTERS_MAX];
+static CANSIM_QueueTypeDef HostTxQueue;
+static CANSIM_QueueTypeDef HostRxQueue;
+static CANSIM_BusStateTypeDef BusState = CANSIM_BUS_IDLE;
+static CANSIM_FrameTypeDef BusFrame;
+static uint32_t BitRate = 0U;
+static uint32_t Now = 0U;
+static uint32_t Started = 0U;
+static uint32_t LastErrorCode = FDCAN_PROTOCOL_ERROR_NO_CHANGE;
+static uint32_t LostFrames = 0U;
+static uint32_t NvicEnabled = 0U;
+static uint32_t InIrq = 0U;
+static void (*IrqHandlerCallback)(void) = NULL;
+
+/* Exported variables --------------------------------------------------------*/
+FDCAN_GlobalTypeDef CANSIM_Instance;
+GPIO_TypeDef CANSIM_GpioPort;
+
+/* Private function prototypes -----------------------------------------------*/
+static void CANSIM_UpdateTxStatus(void);
+static void CANSIM_ProcessAddRequests(void);
+static void CANSIM_StartFrame(void);
+static void CANSIM_CompleteFrame(void);
+static void CANSIM_CheckIrq(void);
+static CANSIM_RxFifoTypeDef *CANSIM_GetRxFifo(uint32_t RxFifo);
+static void CANSIM_Push(CANSIM_QueueTypeDef *pQueue, const CANSIM_FrameTypeDef *pFrame);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Update the Tx FIFO status register from the Tx buffers state.
+  * @retval None.
+  */
+static void CANSIM_UpdateTxStatus(void)
+{
+  uint32_t put_index;
+
+  put_index = (TxGetIndex + TxCount) % TxBuffersNumber;
+
+  CANSIM_Instance.TXFQS = (TxBuffersNumber - TxCount) | (put_index << FDCAN_TXFQS_TFQPI_Pos);
+
+  if (TxCount == TxBuffersNumber)
+  {
+    CANSIM_Instance.TXFQS |= FDCAN_TXFQS_TFQF;
+  }
+}
+
+/**
+  * @brief  Take into account the Tx buffers added by a TXBAR write since the last call.
+  * @retval None.
+  */
+static void CANSIM_ProcessAddRequests(void)
+{
+  uint32_t put_index;
+
+  put_index = (TxGetIndex + TxCount) % TxBuffersNumber;
+
+  if (((CANSIM_Instance.TXBAR & (1UL << put_index)) != 0U) && (TxCount < TxBuffersNumber))
+  {
+    CANSIM_Instance.TXBRP |= (1UL << put_index);
+    TxCount++;
+  }
+
+  CANSIM_Instance.TXBAR = 0U;
+
+  CANSIM_UpdateTxStatus();
+}
+
+/**
+  * @brief  Start the next frame on the idle bus: the lowest identifier wins the arbitration,
+  *         the device wins against the host on the same identifier.
+  * @retval None.
+  */
+static void CANSIM_StartFrame(void)
+{
+  uint32_t index;
+  uint32_t *p_element;
+  CANSIM_FrameTypeDef device_frame;
+
+  if ((Started != 0U) && (TxCount != 0U))
+  {
+    p_element = &a_TxRam[TxGetIndex * CANSIM_ELEMENT_WORDS];
+
+    device_frame.Identifier = (p_element[0] >> 18) & 0x7FFU;
+    device_frame.Length     = (p_element[1] >> 16) & 0xFU;
+
+    if (device_frame.Length > 8U)
+    {
+      device_frame.Length = 8U;
+    }
+
+    for (index = 0U; index < 8U; index++)
+    {
+      device_frame.Data[index] = (uint8_t)(p_element[2U + (index / 4U)] >> (8U * (index % 4U)));
+    }
+
+    BusState = CANSIM_BUS_DEVICE;
+    BusFrame = device_frame;
+  }
+
+  if ((HostTxQueue.Count != 0U)
+      && ((BusState == CANSIM_BUS_IDLE) || (HostTxQueue.a_Frames[HostTxQueue.GetIndex].Identifier < BusFrame.Identifier)))
+  {
+    BusState = CANSIM_BUS_HOST;
+    BusFrame = HostTxQueue.a_Frames[HostTxQueue.GetIndex];
+  }
+
+  if (BusState != CANSIM_BUS_IDLE)
+  {
+    BusFrame.EndTime = Now + CANSIM_GetFrameTime(BusFrame.Length);
+  }
+}
+
+/**
+  * @brief  Complete the frame on the bus: a device frame frees its Tx buffer and is received
+  *         by the host, a host frame is stored in the Rx FIFO selected by the filters.
+  * @retval None.
+  */
+static void CANSIM_CompleteFrame(void)
+{
+  uint32_t index;
+  CANSIM_RxFifoTypeDef *p_fifo = NULL;
+
+  if (BusState == CANSIM_BUS_DEVICE)
+  {
+    CANSIM_Instance.TXBRP &= ~(1UL << TxGetIndex);
+    TxGetIndex = (TxGetIndex + 1U) % TxBuffersNumber;
+    TxCount--;
+
+    CANSIM_UpdateTxStatus();
+    CANSIM_Push(&HostRxQueue, &BusFrame);
+  }
+  else
+  {
+    HostTxQueue.GetIndex = (HostTxQueue.GetIndex + 1U) % CANSIM_QUEUE_SIZE;
+    HostTxQueue.Count--;
+
+    for (index = 0U; (index < CANSIM_FILTERS_MAX) && (p_fifo == NULL) && (Started != 0U); index++)
+    {
+      if ((BusFrame.Identifier & a_Filters[index].FilterID2) == (a_Filters[index].FilterID1 & a_Filters[index].FilterID2))
+      {
+        p_fifo = &a_RxFifos[(a_Filters[index].FilterConfig == FDCAN_FILTER_TO_RXFIFO0) ? 0U : 1U];
+      }
+    }
+
+    /* A frame without room is lost, as in the FIFO blocking mode */
+    if ((p_fifo == NULL) || (p_fifo->Count == CANSIM_RX_FIFO_SIZE))
+    {
+      LostFrames++;
+    }
+    else
+    {
+      p_fifo->a_Frames[(p_fifo->GetIndex + p_fifo->Count) % CANSIM_RX_FIFO_SIZE] = BusFrame;
+      p_fifo->Count++;
+
+      CANSIM_Instance.IR |= p_fifo->Flag;
+    }
+  }
+
+  BusState      = CANSIM_BUS_IDLE;
+  LastErrorCode = FDCAN_PROTOCOL_ERROR_NONE;
+}
+
+/**
+  * @brief  Call the interrupt handler while an enabled new message flag is set.
+  * @retval None.
+  */
+static void CANSIM_CheckIrq(void)
+{
+  while ((NvicEnabled != 0U) && (InIrq == 0U) && (IrqHandlerCallback != NULL)
+         && ((CANSIM_Instance.IR & CANSIM_Instance.IE) != 0U))
+  {
+    InIrq = 1U;
+    IrqHandlerCallback();
+    InIrq = 0U;
+  }
+}
+
+/**
+  * @brief  Get a Rx FIFO from its HAL identifier.
+  * @param  RxFifo FDCAN_RX_FIFO0 or FDCAN_RX_FIFO1.
+  * @retval Returns the Rx FIFO.
+  */
+static CANSIM_RxFifoTypeDef *CANSIM_GetRxFifo(uint32_t RxFifo)
+{
+  return &a_RxFifos[(RxFifo == FDCAN_RX_FIFO0) ? 0U : 1U];
+}
+
+/**
+  * @brief  Push a frame in a queue, the frame is lost if the queue is full.
+  * @param  pQueue The queue.
+  * @param  pFrame The frame.
+  * @retval None.
+  */
+static void CANSIM_Push(CANSIM_QueueTypeDef *pQueue, const CANSIM_FrameTypeDef *pFrame)
+{
+  if (pQueue->Count < CANSIM_QUEUE_SIZE)
+  {
+    pQueue->a_Frames[(pQueue->GetIndex + pQueue->Count) % CANSIM_QUEUE_SIZE] = *pFrame;
+    pQueue->Count++;
+  }
+  else
+  {
+    LostFrames++;
+  }
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Reset the simulated controller and bus.
+  * @param  TxBuffers Number of Tx buffers, from 1 to CANSIM_TX_BUFFERS_MAX.
+  * @param  IrqHandler Handler called on the CANSIM_IRQn interrupt.
+  * @retval None.
+  */
+void CANSIM_Init(uint32_t TxBuffers, void (*IrqHandler)(void))
+{
+  memset(&CANSIM_Instance, 0, sizeof(CANSIM_Instance));
+  memset(a_RxFifos, 0, sizeof(a_RxFifos));
+  memset(a_Filters, 0, sizeof(a_Filters));
+  memset(&HostTxQueue, 0, sizeof(HostTxQueue));
+  memset(&HostRxQueue, 0, sizeof(HostRxQueue));
+
+  a_RxFifos[0].Flag = FDCAN_FLAG_RX_FIFO0_NEW_MESSAGE;
+  a_RxFifos[1].Flag = FDCAN_FLAG_RX_FIFO1_NEW_MESSAGE;
+
+  TxBuffersNumber    = TxBuffers;
+  TxGetIndex         = 0U;
+  TxCount            = 0U;
+  BusState           = CANSIM_BUS_IDLE;
+  BitRate            = 0U;
+  Now                = 0U;
+  Started            = 0U;
+  LastErrorCode      = FDCAN_PROTOCOL_ERROR_NO_CHANGE;
+  LostFrames         = 0U;
+  NvicEnabled        = 0U;
+  InIrq              = 0U;
+  IrqHandlerCallback = IrqHandler;
+
+  CANSIM_UpdateTxStatus();
+}
+
+/**
+  * @brief  Let the simulated time run: the frames are sent on the bus and the interrupt
+  *         handler is called when a frame is received.
+  * @param  Time Duration in us.
+  * @retval None.
+  */
+void CANSIM_Elapse(uint32_t Time)
+{
+  uint32_t target = Now + Time;
+
+  CANSIM_ProcessAddRequests();
+
+  while (1)
+  {
+    if (BusState == CANSIM_BUS_IDLE)
+    {
+      CANSIM_StartFrame();
+    }
+
+    if ((BusState == CANSIM_BUS_IDLE) || (BusFrame.EndTime > target))
+    {
+      break;
+    }
+
+    Now = BusFrame.EndTime;
+
+    CANSIM_CompleteFrame();
+    CANSIM_CheckIrq();
+    CANSIM_ProcessAddRequests();
+  }
+
+  Now = target;
+}
+
+/**
+  * @brief  Let the simulated time run until the bus is idle and no frame is pending.
+  * @retval None.
+  */
+void CANSIM_RunUntilIdle(void)
+{
+  CANSIM_ProcessAddRequests();
+
+  while ((BusState != CANSIM_BUS_IDLE) || (HostTxQueue.Count != 0U) || ((TxCount != 0U) && (Started != 0U)))
+  {
+    CANSIM_Elapse(1U);
+  }
+}
+
+/**
+  * @brief  Queue a frame sent by the host, it is sent on the bus as soon as it is idle.
+  * @param  Identifier Standard identifier of the frame.
+  * @param  pData Data bytes of the frame.
+  * @param  Length Number of data bytes, up to 8.
+  * @retval None.
+  */
+void CANSIM_HostSend(uint32_t Identifier, const uint8_t *pData, uint32_t Length)
+{
+  CANSIM_FrameTypeDef frame;
+
+  memset(&frame, 0, sizeof(frame));
+
+  frame.Identifier = Identifier;
+  frame.Length     = Length;
+  memcpy(frame.Data, pData, Length);
+
+  CANSIM_Push(&HostTxQueue, &frame);
+}
+
+/**
+  * @brief  Get the oldest frame sent by the device and not read yet by the host.
+  * @param  pFrame Pointer to the frame to be filled.
+  * @retval Returns 1 if a frame was read else 0.
+  */
+uint32_t CANSIM_HostReceive(CANSIM_FrameTypeDef *pFrame)
+{
+  uint32_t status = 0U;
+
+  if (HostRxQueue.Count != 0U)
+  {
+    *pFrame = HostRxQueue.a_Frames[HostRxQueue.GetIndex];
+
+    HostRxQueue.GetIndex = (HostRxQueue.GetIndex + 1U) % CANSIM_QUEUE_SIZE;
+    HostRxQueue.Count--;
+
+    status = 1U;
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Record a form error, as if a frame was corrupted and then retransmitted.
+  * @retval None.
+  */
+void CANSIM_InjectBusError(void)
+{
+  LastErrorCode = FDCAN_PROTOCOL_ERROR_FORM;
+}
+
+/**
+  * @brief  Get the simulated time.
+  * @retval Returns the time in us since CANSIM_Init().
+  */
+uint32_t CANSIM_GetTime(void)
+{
+  return Now;
+}
+
+/**
+  * @brief  Get the nominal bit rate programmed by the last HAL_FDCAN_Init().
+  * @retval Returns the bit rate in bit/s.
+  */
+uint32_t CANSIM_GetBitRate(void)
+{
+  return BitRate;
+}
+
+/**
+  * @brief  Get the duration of a standard data frame at the programmed bit rate.
+  * @param  Length Number of data bytes.
+  * @retval Returns the duration in us, interframe space included.
+  */
+uint32_t CANSIM_GetFrameTime(uint32_t Length)
+{
+  return ((CANSIM_FRAME_OVERHEAD + (8U * Length)) * 1000000U) / BitRate;
+}
+
+/**
+  * @brief  Get the number of frames lost: received without room in a Rx FIFO or in a queue.
+  * @retval Returns the number of lost frames.
+  */
+uint32_t CANSIM_GetLostFrames(void)
+{
+  return LostFrames;
+}
+
+/**
+  * @brief  Clear interrupt flags, as a write of ones to the IR register.
+  * @param  hfdcan FDCAN handle.
+  * @param  Flags Flags to be cleared.
+  * @retval None.
+  */
+void CANSIM_ClearFlag(FDCAN_HandleTypeDef *hfdcan, uint32_t Flags)
+{
+  hfdcan->Instance->IR &= ~Flags;
+}
+
+/* Simulated HAL ---------------------------------------------------------------*/
+
+HAL_StatusTypeDef HAL_FDCAN_Init(FDCAN_HandleTypeDef *hfdcan)
+{
+  hfdcan->msgRam.TxFIFOQSA = (uintptr_t)a_TxRam;
+  hfdcan->State            = HAL_FDCAN_STATE_READY;
+
+  BitRate = CANx_CLOCK_FREQ / (hfdcan->Init.NominalPrescaler
+                               * (1U + hfdcan->Init.NominalTimeSeg1 + hfdcan->Init.NominalTimeSeg2));
+
+  /* The initialization mode cancels the pending transmissions and the received frames */
+  memset(a_Filters, 0, sizeof(a_Filters));
+  a_RxFifos[0].Count    = 0U;
+  a_RxFifos[1].Count    = 0U;
+  TxGetIndex            = 0U;
+  TxCount               = 0U;
+  Started               = 0U;
+  CANSIM_Instance.TXBRP = 0U;
+  CANSIM_Instance.TXBAR = 0U;
+  CANSIM_Instance.IR    = 0U;
+  CANSIM_Instance.IE    = 0U;
+
+  CANSIM_UpdateTxStatus();
+
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FDCAN_ConfigFilter(FDCAN_HandleTypeDef *hfdcan, FDCAN_FilterTypeDef *sFilterConfig)
+{
+  HAL_StatusTypeDef status = HAL_ERROR;
+
+  if ((sFilterConfig->FilterIndex < CANSIM_FILTERS_MAX) && (sFilterConfig->FilterIndex < hfdcan->Init.StdFiltersNbr)
+      && (sFilterConfig->FilterType == FDCAN_FILTER_MASK))
+  {
+    a_Filters[sFilterConfig->FilterIndex] = *sFilterConfig;
+
+    status = HAL_OK;
+  }
+
+  return status;
+}
+
+HAL_StatusTypeDef HAL_FDCAN_Start(FDCAN_HandleTypeDef *hfdcan)
+{
+  hfdcan->State = HAL_FDCAN_STATE_BUSY;
+  Started       = 1U;
+
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FDCAN_ActivateNotification(FDCAN_HandleTypeDef *hfdcan, uint32_t ActiveITs,
+                                                 uint32_t BufferIndexes)
+{
+  (void)BufferIndexes;
+
+  hfdcan->Instance->IE |= ActiveITs;
+
+  CANSIM_CheckIrq();
+
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FDCAN_DeactivateNotification(FDCAN_HandleTypeDef *hfdcan, uint32_t InactiveITs)
+{
+  hfdcan->Instance->IE &= ~InactiveITs;
+
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FDCAN_AddMessageToTxFifoQ(FDCAN_HandleTypeDef *hfdcan, FDCAN_TxHeaderTypeDef *pTxHeader,
+                                                uint8_t *pTxData)
+{
+  uint32_t index;
+  uint32_t put_index;
+  uint32_t *p_element;
+  HAL_StatusTypeDef status = HAL_ERROR;
+
+  (void)hfdcan;
+
+  CANSIM_ProcessAddRequests();
+
+  if (TxCount < TxBuffersNumber)
+  {
+    put_index = (TxGetIndex + TxCount) % TxBuffersNumber;
+    p_element = &a_TxRam[put_index * CANSIM_ELEMENT_WORDS];
+
+    p_element[0] = pTxHeader->Identifier << 18;
+    p_element[1] = pTxHeader->DataLength << 16;
+    p_element[2] = 0U;
+    p_element[3] = 0U;
+
+    for (index = 0U; (index < pTxHeader->DataLength) && (index < 8U); index++)
+    {
+      p_element[2U + (index / 4U)] |= (uint32_t)pTxData[index] << (8U * (index % 4U));
+    }
+
+    CANSIM_Instance.TXBRP |= (1UL << put_index);
+    TxCount++;
+
+    CANSIM_UpdateTxStatus();
+
+    status = HAL_OK;
+  }
+
+  return status;
+}
+
+uint32_t HAL_FDCAN_GetTxFifoFreeLevel(FDCAN_HandleTypeDef *hfdcan)
+{
+  (void)hfdcan;
+
+  CANSIM_ProcessAddRequests();
+
+  return CANSIM_Instance.TXFQS & FDCAN_TXFQS_TFFL;
+}
+
+uint32_t HAL_FDCAN_GetRxFifoFillLevel(FDCAN_HandleTypeDef *hfdcan, uint32_t RxFifo)
+{
+  (void)hfdcan;
+
+  return CANSIM_GetRxFifo(RxFifo)->Count;
+}
+
+HAL_StatusTypeDef HAL_FDCAN_GetRxMessage(FDCAN_HandleTypeDef *hfdcan, uint32_t RxLocation,
+                                         FDCAN_RxHeaderTypeDef *pRxHeader, uint8_t *pRxData)
+{
+  CANSIM_RxFifoTypeDef *p_fifo;
+  CANSIM_FrameTypeDef *p_frame;
+  HAL_StatusTypeDef status = HAL_ERROR;
+
+  (void)hfdcan;
+
+  p_fifo = CANSIM_GetRxFifo(RxLocation);
+
+  if (p_fifo->Count != 0U)
+  {
+    p_frame = &p_fifo->a_Frames[p_fifo->GetIndex];
+
+    pRxHeader->Identifier = p_frame->Identifier;
+    pRxHeader->IdType     = FDCAN_STANDARD_ID;
+    pRxHeader->DataLength = p_frame->Length;
+    memcpy(pRxData, p_frame->Data, p_frame->Length);
+
+    p_fifo->GetIndex = (p_fifo->GetIndex + 1U) % CANSIM_RX_FIFO_SIZE;
+    p_fifo->Count--;
+
+    status = HAL_OK;
+  }
+
+  return status;
+}
+
+HAL_StatusTypeDef HAL_FDCAN_GetProtocolStatus(FDCAN_HandleTypeDef *hfdcan, FDCAN_ProtocolStatusTypeDef *ProtocolStatus)
+{
+  (void)hfdcan;
+
+  /* Reading the protocol status register sets the last error code to "no change" */
+  ProtocolStatus->LastErrorCode = LastErrorCode;
+  LastErrorCode                 = FDCAN_PROTOCOL_ERROR_NO_CHANGE;
+
+  return HAL_OK;
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+  (void)IRQn;
+  (void)PreemptPriority;
+  (void)SubPriority;
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+  if (IRQn == CANSIM_IRQn)
+  {
+    NvicEnabled = 1U;
+
+    CANSIM_CheckIrq();
+  }
+}
+
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+  if (IRQn == CANSIM_IRQn)
+  {
+    NvicEnabled = 0U;
+  }
+}
+
+void HAL_GPIO_DeInit(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin)
+{
+  (void)GPIOx;
+  (void)GPIO_Pin;
+}
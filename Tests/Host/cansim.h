@@ -0,0 +1,202 @@
+/**
+  ******************************************************************************
+  * @file    cansim.h
+  * @author  MCD Application Team
+  * @brief   Simulated FDCAN controller in classic CAN mode: the subset of the HAL
+  *          used by the CAN interface and the control of the simulated bus
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CANSIM_H
+#define CANSIM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "halsim.h"
+
+/* Exported types ------------------------------------------------------------*/
+/* Same names as the device HAL, only the members used by the CAN interface */
+typedef enum
+{
+  HAL_FDCAN_STATE_RESET = 0x00U,
+  HAL_FDCAN_STATE_READY = 0x01U,
+  HAL_FDCAN_STATE_BUSY  = 0x02U
+} HAL_FDCAN_StateTypeDef;
+
+typedef struct
+{
+  volatile uint32_t TXFQS;        /*!< Tx FIFO status: free level, put index and full flag */
+  volatile uint32_t TXBRP;        /*!< Tx buffers with a pending transmission request */
+  volatile uint32_t TXBAR;        /*!< Tx buffers add request */
+  volatile uint32_t IE;           /*!< Enabled interrupts */
+  volatile uint32_t IR;           /*!< Interrupt flags */
+} FDCAN_GlobalTypeDef;
+
+typedef struct
+{
+  uint32_t ClockDivider;
+  uint32_t FrameFormat;
+  uint32_t Mode;
+  FunctionalState AutoRetransmission;
+  FunctionalState TransmitPause;
+  FunctionalState ProtocolException;
+  uint32_t NominalPrescaler;
+  uint32_t NominalSyncJumpWidth;
+  uint32_t NominalTimeSeg1;
+  uint32_t NominalTimeSeg2;
+  uint32_t DataPrescaler;
+  uint32_t DataSyncJumpWidth;
+  uint32_t DataTimeSeg1;
+  uint32_t DataTimeSeg2;
+  uint32_t StdFiltersNbr;
+  uint32_t ExtFiltersNbr;
+  uint32_t TxFifoQueueMode;
+} FDCAN_InitTypeDef;
+
+typedef struct
+{
+  uintptr_t TxFIFOQSA;            /*!< Tx buffers start address, a host pointer */
+} FDCAN_MsgRamAddressTypeDef;
+
+typedef struct
+{
+  FDCAN_GlobalTypeDef *Instance;
+  FDCAN_InitTypeDef Init;
+  FDCAN_MsgRamAddressTypeDef msgRam;
+  volatile HAL_FDCAN_StateTypeDef State;
+} FDCAN_HandleTypeDef;
+
+typedef struct
+{
+  uint32_t IdType;
+  uint32_t FilterIndex;
+  uint32_t FilterType;
+  uint32_t FilterConfig;
+  uint32_t FilterID1;
+  uint32_t FilterID2;
+} FDCAN_FilterTypeDef;
+
+typedef struct
+{
+  uint32_t Identifier;
+  uint32_t IdType;
+  uint32_t TxFrameType;
+  uint32_t DataLength;
+  uint32_t ErrorStateIndicator;
+  uint32_t BitRateSwitch;
+  uint32_t FDFormat;
+  uint32_t TxEventFifoControl;
+  uint32_t MessageMarker;
+} FDCAN_TxHeaderTypeDef;
+
+typedef struct
+{
+  uint32_t Identifier;
+  uint32_t IdType;
+  uint32_t DataLength;
+} FDCAN_RxHeaderTypeDef;
+
+typedef struct
+{
+  uint32_t LastErrorCode;
+} FDCAN_ProtocolStatusTypeDef;
+
+/* Frame seen on the simulated bus */
+typedef struct
+{
+  uint32_t Identifier;            /*!< Standard identifier */
+  uint32_t Length;                /*!< Number of data bytes, up to 8 */
+  uint8_t Data[8];                /*!< Data bytes */
+  uint32_t EndTime;               /*!< Simulated time in us at the end of the frame */
+} CANSIM_FrameTypeDef;
+
+/* Exported constants --------------------------------------------------------*/
+#define FDCAN_CLOCK_DIV1                  0x00000000U
+#define FDCAN_FRAME_CLASSIC               0x00000000U
+#define FDCAN_MODE_NORMAL                 0x00000000U
+#define FDCAN_TX_FIFO_OPERATION           0x00000000U
+#define FDCAN_STANDARD_ID                 0x00000000U
+#define FDCAN_DATA_FRAME                  0x00000000U
+#define FDCAN_ESI_ACTIVE                  0x00000000U
+#define FDCAN_BRS_OFF                     0x00000000U
+#define FDCAN_CLASSIC_CAN                 0x00000000U
+#define FDCAN_NO_TX_EVENTS                0x00000000U
+#define FDCAN_FILTER_MASK                 0x00000002U
+#define FDCAN_FILTER_TO_RXFIFO0           0x00000001U
+#define FDCAN_FILTER_TO_RXFIFO1           0x00000002U
+#define FDCAN_RX_FIFO0                    0x00000040U
+#define FDCAN_RX_FIFO1                    0x00000041U
+
+#define FDCAN_IT_RX_FIFO0_NEW_MESSAGE     0x00000001U
+#define FDCAN_IT_RX_FIFO1_NEW_MESSAGE     0x00000008U
+#define FDCAN_FLAG_RX_FIFO0_NEW_MESSAGE   FDCAN_IT_RX_FIFO0_NEW_MESSAGE
+#define FDCAN_FLAG_RX_FIFO1_NEW_MESSAGE   FDCAN_IT_RX_FIFO1_NEW_MESSAGE
+
+#define FDCAN_PROTOCOL_ERROR_NONE         0x00000000U
+#define FDCAN_PROTOCOL_ERROR_FORM         0x00000002U
+#define FDCAN_PROTOCOL_ERROR_NO_CHANGE    0x00000007U
+
+#define FDCAN_TXFQS_TFFL                  0x00000007U
+#define FDCAN_TXFQS_TFQPI_Pos             16U
+#define FDCAN_TXFQS_TFQPI                 (0x3UL << FDCAN_TXFQS_TFQPI_Pos)
+#define FDCAN_TXFQS_TFQF                  0x00200000U
+
+#define CANSIM_TX_BUFFERS_MAX             3U   /* Tx buffers of the FDCAN */
+#define CANSIM_RX_FIFO_SIZE               3U   /* Elements of each Rx FIFO of the FDCAN */
+#define CANSIM_IRQn                       ((IRQn_Type)21)
+
+/* Exported macro ------------------------------------------------------------*/
+/* Write one to clear, modelled by a call */
+#define __HAL_FDCAN_CLEAR_FLAG(__HANDLE__, __FLAG__)  CANSIM_ClearFlag((__HANDLE__), (__FLAG__))
+
+/* Exported variables --------------------------------------------------------*/
+extern FDCAN_GlobalTypeDef CANSIM_Instance;
+extern GPIO_TypeDef CANSIM_GpioPort;
+
+/* Exported functions ------------------------------------------------------- */
+HAL_StatusTypeDef HAL_FDCAN_Init(FDCAN_HandleTypeDef *hfdcan);
+HAL_StatusTypeDef HAL_FDCAN_ConfigFilter(FDCAN_HandleTypeDef *hfdcan, FDCAN_FilterTypeDef *sFilterConfig);
+HAL_StatusTypeDef HAL_FDCAN_Start(FDCAN_HandleTypeDef *hfdcan);
+HAL_StatusTypeDef HAL_FDCAN_ActivateNotification(FDCAN_HandleTypeDef *hfdcan, uint32_t ActiveITs,
+                                                 uint32_t BufferIndexes);
+HAL_StatusTypeDef HAL_FDCAN_DeactivateNotification(FDCAN_HandleTypeDef *hfdcan, uint32_t InactiveITs);
+HAL_StatusTypeDef HAL_FDCAN_AddMessageToTxFifoQ(FDCAN_HandleTypeDef *hfdcan, FDCAN_TxHeaderTypeDef *pTxHeader,
+                                                uint8_t *pTxData);
+uint32_t HAL_FDCAN_GetTxFifoFreeLevel(FDCAN_HandleTypeDef *hfdcan);
+uint32_t HAL_FDCAN_GetRxFifoFillLevel(FDCAN_HandleTypeDef *hfdcan, uint32_t RxFifo);
+HAL_StatusTypeDef HAL_FDCAN_GetRxMessage(FDCAN_HandleTypeDef *hfdcan, uint32_t RxLocation,
+                                         FDCAN_RxHeaderTypeDef *pRxHeader, uint8_t *pRxData);
+HAL_StatusTypeDef HAL_FDCAN_GetProtocolStatus(FDCAN_HandleTypeDef *hfdcan, FDCAN_ProtocolStatusTypeDef *ProtocolStatus);
+void CANSIM_ClearFlag(FDCAN_HandleTypeDef *hfdcan, uint32_t Flags);
+
+void CANSIM_Init(uint32_t TxBuffers, void (*IrqHandler)(void));
+void CANSIM_Elapse(uint32_t Time);
+void CANSIM_RunUntilIdle(void);
+void CANSIM_HostSend(uint32_t Identifier, const uint8_t *pData, uint32_t Length);
+uint32_t CANSIM_HostReceive(CANSIM_FrameTypeDef *pFrame);
+void CANSIM_InjectBusError(void);
+uint32_t CANSIM_GetTime(void);
+uint32_t CANSIM_GetBitRate(void);
+uint32_t CANSIM_GetFrameTime(uint32_t Length);
+uint32_t CANSIM_GetLostFrames(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CANSIM_H */
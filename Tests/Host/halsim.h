@@ -0,0 +1,79 @@
+/**
+  ******************************************************************************
+  * @file    halsim.h
+  * @author  MCD Application Team
+  * @brief   Device HAL definitions shared by the simulated peripherals of the
+  *          host tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef HALSIM_H
+#define HALSIM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "platform.h"
+
+/* Exported types ------------------------------------------------------------*/
+/* Same names as the device HAL, only the members used by the interfaces */
+typedef enum
+{
+  HAL_OK      = 0x00U,
+  HAL_ERROR   = 0x01U,
+  HAL_BUSY    = 0x02U,
+  HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+typedef int32_t IRQn_Type;
+
+typedef struct
+{
+  uint32_t Dummy;
+} GPIO_TypeDef;
+
+typedef struct
+{
+  uint32_t Pin;
+  uint32_t Mode;
+  uint32_t Pull;
+  uint32_t Speed;
+  uint32_t Alternate;
+} GPIO_InitTypeDef;
+
+/* Exported constants --------------------------------------------------------*/
+#define GPIO_MODE_AF_PP                   0x00000002U
+#define GPIO_NOPULL                       0x00000000U
+#define GPIO_SPEED_FREQ_VERY_HIGH         0x00000003U
+
+/* Exported macro ------------------------------------------------------------*/
+#define __IO                              volatile
+
+/* Exported functions ------------------------------------------------------- */
+/* Defined by the simulated peripheral that models them, else by the test */
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn);
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+void HAL_GPIO_DeInit(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin);
+uint32_t HAL_GetTick(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HALSIM_H */
@@ -0,0 +1,46 @@
+/**
+  ******************************************************************************
+  * @file    host_test.h
+  * @author  MCD Application Team
+  * @brief   Minimal checks shared by the host tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+
+/* Exported variables --------------------------------------------------------*/
+static unsigned int HostTestFailures = 0U;
+
+/* Exported macro ------------------------------------------------------------*/
+/* Report a failed condition and carry on with the next checks */
+#define HOST_TEST_CHECK(cond)                                                   \
+  do                                                                            \
+  {                                                                             \
+    if (!(cond))                                                                \
+    {                                                                           \
+      printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);           \
+      HostTestFailures++;                                                       \
+    }                                                                           \
+  } while (0)
+
+/* Exit status of the test program */
+#define HOST_TEST_RESULT(name)                                                  \
+  ((HostTestFailures == 0U) ? (printf("%s: passed\n", (name)), 0)               \
+                            : (printf("%s: %u failed checks\n", (name), HostTestFailures), 1))
+
+#endif /* HOST_TEST_H */
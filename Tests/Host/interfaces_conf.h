@@ -0,0 +1,83 @@
+/**
+  ******************************************************************************
+  * @file    interfaces_conf.h
+  * @author  MCD Application Team
+  * @brief   Host replacement of the interfaces configuration: the CAN and external
+  *          NOR interfaces run on the simulated peripherals
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef INTERFACES_CONF_H
+#define INTERFACES_CONF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "cansim.h"
+#include "norsim.h"
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+
+/* -------------------------- Definitions for CAN --------------------------- */
+#define CANx                              (&CANSIM_Instance)
+#define CANx_CLK_DISABLE()
+#define CANx_GPIO_CLK_ENABLE()
+#define CANx_CLOCK_FREQ                   20000000U  /* Same kernel clock as the device */
+
+#define CANx_TX_PIN                       0x0100U
+#define CANx_TX_GPIO_PORT                 (&CANSIM_GpioPort)
+#define CANx_RX_PIN                       0x0200U
+#define CANx_RX_GPIO_PORT                 (&CANSIM_GpioPort)
+
+#define CANx_IRQn                         CANSIM_IRQn
+
+#define CANx_FORCE_RESET()
+#define CANx_RELEASE_RESET()
+
+/* ----------------------- Definitions for external NOR --------------------- */
+#define OSPIx                             (&NORSIM_Instance)
+#define OSPIx_CLK_ENABLE()
+#define OSPIx_GPIO_CLK_ENABLE()
+#define OSPIx_IRQn                        ((IRQn_Type)76)
+#define OSPIx_ALTERNATE                   0x0AU
+
+#define OSPIx_DMA_CLK_ENABLE()
+#define OSPIx_DMA_CHANNEL                 (&NORSIM_DmaChannel)
+#define OSPIx_DMA_REQUEST                 0x00000028U
+#define OSPIx_DMA_IRQn                    ((IRQn_Type)101)
+
+#define OSPIx_CLK_PIN                     0x0400U
+#define OSPIx_CLK_GPIO_PORT               (&NORSIM_GpioPort)
+#define OSPIx_NCS_PIN                     0x0800U
+#define OSPIx_NCS_GPIO_PORT               (&NORSIM_GpioPort)
+#define OSPIx_IO0_PIN                     0x1000U
+#define OSPIx_IO0_GPIO_PORT               (&NORSIM_GpioPort)
+#define OSPIx_IO1_PIN                     0x2000U
+#define OSPIx_IO1_GPIO_PORT               (&NORSIM_GpioPort)
+#define OSPIx_IO2_PIN                     0x4000U
+#define OSPIx_IO2_GPIO_PORT               (&NORSIM_GpioPort)
+#define OSPIx_IO3_PIN                     0x8000U
+#define OSPIx_IO3_GPIO_PORT               (&NORSIM_GpioPort)
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INTERFACES_CONF_H */
@@ -0,0 +1,388 @@
+/**
+  ******************************************************************************
+  * @file    norsim.c
+  * @author  MCD Application Team
+  * @brief   Simulated OCTOSPI with its DMA channel and an attached serial NOR
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "platform.h"
+#include "norsim.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define NORSIM_DMA_TIME                   30U       /* Page transfer in us */
+#define NORSIM_PROGRAM_TIME               400U      /* Page program in us */
+#define NORSIM_SECTOR_ERASE_TIME          50000U    /* Sector erase in us */
+#define NORSIM_BLOCK_ERASE_TIME           400000U   /* Block erase in us */
+#define NORSIM_CHIP_ERASE_TIME            2000000U  /* Chip erase in us */
+#define NORSIM_ERASED_BYTE                0xFFU
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static uint8_t NorSimImage[NORSIM_SIZE];
+static uint8_t a_PageBuffer[NORSIM_PAGE_SIZE];
+static uint32_t a_CommandCounts[256];
+static OSPI_RegularCmdTypeDef PendingCommand;
+static OSPI_HandleTypeDef *p_Handle = NULL;
+static uint32_t Now = 0U;
+static uint32_t TransferEnd = 0U;
+static uint32_t BusyEnd = 0U;
+static uint8_t WriteEnabled = 0U;
+static uint8_t ReadConfigured = 0U;
+static uint8_t WriteConfigured = 0U;
+static uint8_t DmaStalled = 0U;
+static uint8_t BusyStuck = 0U;
+static uint8_t CommandFailure = 0U;
+
+/* Exported variables --------------------------------------------------------*/
+OCTOSPI_TypeDef NORSIM_Instance;
+DMA_Channel_TypeDef NORSIM_DmaChannel;
+GPIO_TypeDef NORSIM_GpioPort;
+
+/* Private function prototypes -----------------------------------------------*/
+static void NORSIM_Erase(uint32_t Address, uint32_t Size, uint32_t Time);
+static void NORSIM_Program(void);
+static uint8_t NORSIM_IsBusy(void);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Erase an aligned area of the NOR, if the write enable latch is set.
+  * @param  Address Address in the NOR, aligned down on the area size.
+  * @param  Size Size of the area.
+  * @param  Time Duration of the erase in us.
+  * @retval None.
+  */
+static void NORSIM_Erase(uint32_t Address, uint32_t Size, uint32_t Time)
+{
+  Address &= ~(Size - 1U);
+
+  if ((WriteEnabled != 0U) && (Address < NORSIM_SIZE))
+  {
+    memset(&NorSimImage[Address], NORSIM_ERASED_BYTE, Size);
+
+    BusyEnd      = Now + Time;
+    WriteEnabled = 0U;
+  }
+}
+
+/**
+  * @brief  Program the transferred page, if the write enable latch is set. As a real NOR,
+  *         the address wraps inside the page and the programming only clears bits.
+  * @retval None.
+  */
+static void NORSIM_Program(void)
+{
+  uint32_t index;
+  uint32_t page;
+
+  page = PendingCommand.Address & ~(NORSIM_PAGE_SIZE - 1U);
+
+  if ((WriteEnabled != 0U) && (page < NORSIM_SIZE))
+  {
+    for (index = 0U; index < PendingCommand.NbData; index++)
+    {
+      NorSimImage[page + ((PendingCommand.Address + index) & (NORSIM_PAGE_SIZE - 1U))] &= a_PageBuffer[index];
+    }
+
+    BusyEnd      = Now + NORSIM_PROGRAM_TIME;
+    WriteEnabled = 0U;
+  }
+}
+
+/**
+  * @brief  Get the write in progress bit of the NOR status register.
+  * @retval Returns 1 while a program or erase runs else 0.
+  */
+static uint8_t NORSIM_IsBusy(void)
+{
+  return ((BusyStuck != 0U) || (Now < BusyEnd)) ? 1U : 0U;
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Reset the simulated OCTOSPI and NOR: the NOR is erased.
+  * @retval None.
+  */
+void NORSIM_Init(void)
+{
+  memset(NorSimImage, NORSIM_ERASED_BYTE, sizeof(NorSimImage));
+  memset(a_CommandCounts, 0, sizeof(a_CommandCounts));
+
+  p_Handle        = NULL;
+  Now             = 0U;
+  TransferEnd     = 0U;
+  BusyEnd         = 0U;
+  WriteEnabled    = 0U;
+  ReadConfigured  = 0U;
+  WriteConfigured = 0U;
+  DmaStalled      = 0U;
+  BusyStuck       = 0U;
+  CommandFailure  = 0U;
+}
+
+/**
+  * @brief  Let the simulated time run.
+  * @param  Time Duration in us.
+  * @retval None.
+  */
+void NORSIM_Elapse(uint32_t Time)
+{
+  Now += Time;
+}
+
+/**
+  * @brief  Get the content of the NOR.
+  * @retval Returns a pointer to the NORSIM_SIZE bytes of the NOR.
+  */
+uint8_t *NORSIM_GetImage(void)
+{
+  return NorSimImage;
+}
+
+/**
+  * @brief  Get the number of commands sent with an instruction since NORSIM_Init().
+  * @param  Instruction The instruction opcode.
+  * @retval Returns the number of commands.
+  */
+uint32_t NORSIM_GetCommandCount(uint32_t Instruction)
+{
+  return a_CommandCounts[Instruction & 0xFFU];
+}
+
+/**
+  * @brief  Check if the OCTOSPI is in memory-mapped mode.
+  * @retval Returns 1 if the NOR is memory mapped else 0.
+  */
+uint8_t NORSIM_IsMemoryMapped(void)
+{
+  return ((p_Handle != NULL) && (p_Handle->State == HAL_OSPI_STATE_BUSY_MEM_MAPPED)) ? 1U : 0U;
+}
+
+/**
+  * @brief  Stall the DMA channel: the started transfers never complete.
+  * @param  State ENABLE to stall the DMA, DISABLE to let it run.
+  * @retval None.
+  */
+void NORSIM_StallDma(FunctionalState State)
+{
+  DmaStalled = (State == ENABLE) ? 1U : 0U;
+}
+
+/**
+  * @brief  Keep the write in progress bit of the NOR set.
+  * @param  State ENABLE to keep the NOR busy, DISABLE to let it complete its operations.
+  * @retval None.
+  */
+void NORSIM_StickBusy(FunctionalState State)
+{
+  BusyStuck = (State == ENABLE) ? 1U : 0U;
+}
+
+/**
+  * @brief  Make the next command fail, as on a transfer error.
+  * @retval None.
+  */
+void NORSIM_FailNextCommand(void)
+{
+  CommandFailure = 1U;
+}
+
+/* Simulated HAL ---------------------------------------------------------------*/
+
+HAL_StatusTypeDef HAL_OSPI_Init(OSPI_HandleTypeDef *hospi)
+{
+  p_Handle        = hospi;
+  hospi->State    = HAL_OSPI_STATE_READY;
+  ReadConfigured  = 0U;
+  WriteConfigured = 0U;
+
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_OSPIM_Config(OSPI_HandleTypeDef *hospi, OSPIM_CfgTypeDef *cfg, uint32_t Timeout)
+{
+  (void)hospi;
+  (void)cfg;
+  (void)Timeout;
+
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_OSPI_Command(OSPI_HandleTypeDef *hospi, OSPI_RegularCmdTypeDef *cmd, uint32_t Timeout)
+{
+  HAL_StatusTypeDef status = HAL_OK;
+
+  (void)Timeout;
+
+  if (hospi->State != HAL_OSPI_STATE_READY)
+  {
+    status = HAL_BUSY;
+  }
+  else if (CommandFailure != 0U)
+  {
+    CommandFailure = 0U;
+    status         = HAL_ERROR;
+  }
+  else if (cmd->OperationType == HAL_OSPI_OPTYPE_READ_CFG)
+  {
+    ReadConfigured = 1U;
+  }
+  else if (cmd->OperationType == HAL_OSPI_OPTYPE_WRITE_CFG)
+  {
+    WriteConfigured = 1U;
+  }
+  else
+  {
+    a_CommandCounts[cmd->Instruction & 0xFFU]++;
+
+    if (cmd->DataMode != HAL_OSPI_DATA_NONE)
+    {
+      /* The data phase is run by the next transfer or auto-polling call */
+      PendingCommand = *cmd;
+      hospi->State   = HAL_OSPI_STATE_CMD_CFG;
+    }
+    else if (NORSIM_IsBusy() != 0U)
+    {
+      /* A busy NOR ignores the commands */
+    }
+    else if (cmd->Instruction == NORSIM_CMD_WRITE_ENABLE)
+    {
+      WriteEnabled = 1U;
+    }
+    else if (cmd->Instruction == NORSIM_CMD_SECTOR_ERASE)
+    {
+      NORSIM_Erase(cmd->Address, NORSIM_SECTOR_SIZE, NORSIM_SECTOR_ERASE_TIME);
+    }
+    else if (cmd->Instruction == NORSIM_CMD_BLOCK_ERASE)
+    {
+      NORSIM_Erase(cmd->Address, NORSIM_BLOCK_SIZE, NORSIM_BLOCK_ERASE_TIME);
+    }
+    else if (cmd->Instruction == NORSIM_CMD_CHIP_ERASE)
+    {
+      NORSIM_Erase(0U, NORSIM_SIZE, NORSIM_CHIP_ERASE_TIME);
+    }
+    else
+    {
+      status = HAL_ERROR;
+    }
+  }
+
+  return status;
+}
+
+HAL_StatusTypeDef HAL_OSPI_Transmit_DMA(OSPI_HandleTypeDef *hospi, uint8_t *pData)
+{
+  HAL_StatusTypeDef status = HAL_ERROR;
+
+  if ((hospi->State == HAL_OSPI_STATE_CMD_CFG) && (PendingCommand.Instruction == NORSIM_CMD_QUAD_PAGE_PROGRAM)
+      && (PendingCommand.NbData <= NORSIM_PAGE_SIZE))
+  {
+    memcpy(a_PageBuffer, pData, PendingCommand.NbData);
+
+    TransferEnd  = Now + NORSIM_DMA_TIME;
+    hospi->State = HAL_OSPI_STATE_BUSY_TX;
+    status       = HAL_OK;
+  }
+
+  return status;
+}
+
+HAL_StatusTypeDef HAL_OSPI_AutoPolling_IT(OSPI_HandleTypeDef *hospi, OSPI_AutoPollingTypeDef *cfg)
+{
+  HAL_StatusTypeDef status = HAL_ERROR;
+
+  (void)cfg;
+
+  if ((hospi->State == HAL_OSPI_STATE_CMD_CFG) && (PendingCommand.Instruction == NORSIM_CMD_READ_STATUS))
+  {
+    hospi->State = HAL_OSPI_STATE_BUSY_AUTO_POLLING;
+    status       = HAL_OK;
+  }
+
+  return status;
+}
+
+HAL_StatusTypeDef HAL_OSPI_MemoryMapped(OSPI_HandleTypeDef *hospi, OSPI_MemoryMappedTypeDef *cfg)
+{
+  HAL_StatusTypeDef status = HAL_ERROR;
+
+  (void)cfg;
+
+  if ((hospi->State == HAL_OSPI_STATE_READY) && (ReadConfigured != 0U) && (WriteConfigured != 0U))
+  {
+    hospi->State = HAL_OSPI_STATE_BUSY_MEM_MAPPED;
+    status       = HAL_OK;
+  }
+
+  ReadConfigured  = 0U;
+  WriteConfigured = 0U;
+
+  return status;
+}
+
+HAL_StatusTypeDef HAL_OSPI_Abort(OSPI_HandleTypeDef *hospi)
+{
+  /* An aborted transfer programs nothing */
+  hospi->State = HAL_OSPI_STATE_READY;
+
+  return HAL_OK;
+}
+
+HAL_OSPI_StateTypeDef HAL_OSPI_GetState(OSPI_HandleTypeDef *hospi)
+{
+  if ((hospi->State == HAL_OSPI_STATE_BUSY_TX) && (DmaStalled == 0U) && (Now >= TransferEnd))
+  {
+    NORSIM_Program();
+
+    hospi->State = HAL_OSPI_STATE_READY;
+  }
+  else if ((hospi->State == HAL_OSPI_STATE_BUSY_AUTO_POLLING) && (NORSIM_IsBusy() == 0U))
+  {
+    hospi->State = HAL_OSPI_STATE_READY;
+  }
+
+  return hospi->State;
+}
+
+void HAL_OSPI_IRQHandler(OSPI_HandleTypeDef *hospi)
+{
+  (void)hospi;
+}
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma)
+{
+  (void)hdma;
+
+  return HAL_OK;
+}
+
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma)
+{
+  (void)hdma;
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+  (void)GPIOx;
+  (void)GPIO_Init;
+}
+
+uint32_t HAL_GetTick(void)
+{
+  return Now / 1000U;
+}
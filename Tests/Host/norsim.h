@@ -0,0 +1,247 @@
+/**
+  ******************************************************************************
+  * @file    norsim.h
+  * @author  MCD Application Team
+  * @brief   Simulated OCTOSPI with its DMA channel and an attached serial NOR:
+  *          the subset of the HAL used by the external NOR interface and the
+  *          control of the simulated device
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef NORSIM_H
+#define NORSIM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "halsim.h"
+
+/* Exported types ------------------------------------------------------------*/
+/* Same names as the device HAL, only the members used by the external NOR interface */
+typedef enum
+{
+  HAL_OSPI_STATE_RESET             = 0x00U,
+  HAL_OSPI_STATE_READY             = 0x02U,
+  HAL_OSPI_STATE_CMD_CFG           = 0x14U,  /* Command sent, waiting for its data phase */
+  HAL_OSPI_STATE_BUSY_TX           = 0x18U,
+  HAL_OSPI_STATE_BUSY_AUTO_POLLING = 0x48U,
+  HAL_OSPI_STATE_BUSY_MEM_MAPPED   = 0x88U
+} HAL_OSPI_StateTypeDef;
+
+typedef struct
+{
+  uint32_t Dummy;
+} OCTOSPI_TypeDef;
+
+typedef struct
+{
+  uint32_t Dummy;
+} DMA_Channel_TypeDef;
+
+typedef struct
+{
+  uint32_t Request;
+  uint32_t BlkHWRequest;
+  uint32_t Direction;
+  uint32_t SrcInc;
+  uint32_t DestInc;
+  uint32_t SrcDataWidth;
+  uint32_t DestDataWidth;
+  uint32_t Priority;
+  uint32_t SrcBurstLength;
+  uint32_t DestBurstLength;
+  uint32_t TransferAllocatedPort;
+  uint32_t TransferEventMode;
+  uint32_t Mode;
+} DMA_InitTypeDef;
+
+typedef struct
+{
+  DMA_Channel_TypeDef *Instance;
+  DMA_InitTypeDef Init;
+} DMA_HandleTypeDef;
+
+typedef struct
+{
+  uint32_t FifoThreshold;
+  uint32_t DualQuad;
+  uint32_t MemoryType;
+  uint32_t DeviceSize;
+  uint32_t ChipSelectHighTime;
+  uint32_t FreeRunningClock;
+  uint32_t ClockMode;
+  uint32_t WrapSize;
+  uint32_t ClockPrescaler;
+  uint32_t SampleShifting;
+  uint32_t DelayHoldQuarterCycle;
+  uint32_t ChipSelectBoundary;
+  uint32_t DelayBlockBypass;
+  uint32_t MaxTran;
+  uint32_t Refresh;
+} OSPI_InitTypeDef;
+
+typedef struct
+{
+  OCTOSPI_TypeDef *Instance;
+  OSPI_InitTypeDef Init;
+  DMA_HandleTypeDef *hdma;
+  volatile HAL_OSPI_StateTypeDef State;
+} OSPI_HandleTypeDef;
+
+typedef struct
+{
+  uint32_t ClkPort;
+  uint32_t NCSPort;
+  uint32_t IOLowPort;
+  uint32_t IOHighPort;
+  uint32_t Req2AckTime;
+} OSPIM_CfgTypeDef;
+
+typedef struct
+{
+  uint32_t OperationType;
+  uint32_t FlashId;
+  uint32_t Instruction;
+  uint32_t InstructionMode;
+  uint32_t InstructionSize;
+  uint32_t InstructionDtrMode;
+  uint32_t Address;
+  uint32_t AddressMode;
+  uint32_t AddressSize;
+  uint32_t AddressDtrMode;
+  uint32_t AlternateBytesMode;
+  uint32_t DataMode;
+  uint32_t NbData;
+  uint32_t DataDtrMode;
+  uint32_t DummyCycles;
+  uint32_t DQSMode;
+  uint32_t SIOOMode;
+} OSPI_RegularCmdTypeDef;
+
+typedef struct
+{
+  uint32_t Match;
+  uint32_t Mask;
+  uint32_t MatchMode;
+  uint32_t AutomaticStop;
+  uint32_t Interval;
+} OSPI_AutoPollingTypeDef;
+
+typedef struct
+{
+  uint32_t TimeOutActivation;
+  uint32_t TimeOutPeriod;
+} OSPI_MemoryMappedTypeDef;
+
+/* Exported constants --------------------------------------------------------*/
+#define HAL_OSPI_TIMEOUT_DEFAULT_VALUE    5000U  /* 5 s */
+
+#define HAL_OSPI_OPTYPE_COMMON_CFG        0x00000000U
+#define HAL_OSPI_OPTYPE_READ_CFG          0x00000001U
+#define HAL_OSPI_OPTYPE_WRITE_CFG         0x00000002U
+#define HAL_OSPI_FLASH_ID_1               0x00000000U
+#define HAL_OSPI_INSTRUCTION_1_LINE       0x00000001U
+#define HAL_OSPI_INSTRUCTION_8_BITS       0x00000000U
+#define HAL_OSPI_INSTRUCTION_DTR_DISABLE  0x00000000U
+#define HAL_OSPI_ADDRESS_NONE             0x00000000U
+#define HAL_OSPI_ADDRESS_1_LINE           0x00000100U
+#define HAL_OSPI_ADDRESS_4_LINES          0x00000300U
+#define HAL_OSPI_ADDRESS_32_BITS          0x00003000U
+#define HAL_OSPI_ADDRESS_DTR_DISABLE      0x00000000U
+#define HAL_OSPI_ALTERNATE_BYTES_NONE     0x00000000U
+#define HAL_OSPI_DATA_NONE                0x00000000U
+#define HAL_OSPI_DATA_1_LINE              0x01000000U
+#define HAL_OSPI_DATA_4_LINES             0x03000000U
+#define HAL_OSPI_DATA_DTR_DISABLE         0x00000000U
+#define HAL_OSPI_DQS_DISABLE              0x00000000U
+#define HAL_OSPI_SIOO_INST_EVERY_CMD      0x00000000U
+#define HAL_OSPI_MATCH_MODE_AND           0x00000000U
+#define HAL_OSPI_AUTOMATIC_STOP_ENABLE    0x00400000U
+#define HAL_OSPI_TIMEOUT_COUNTER_DISABLE  0x00000000U
+
+#define HAL_OSPI_DUALQUAD_DISABLE         0x00000000U
+#define HAL_OSPI_MEMTYPE_MICRON           0x00000000U
+#define HAL_OSPI_FREERUNCLK_DISABLE       0x00000000U
+#define HAL_OSPI_CLOCK_MODE_0             0x00000000U
+#define HAL_OSPI_WRAP_NOT_SUPPORTED       0x00000000U
+#define HAL_OSPI_SAMPLE_SHIFTING_HALFCYCLE 0x40000000U
+#define HAL_OSPI_DHQC_DISABLE             0x00000000U
+#define HAL_OSPI_DELAY_BLOCK_BYPASSED     0x00000008U
+#define HAL_OSPIM_IOPORT_NONE             0x00000000U
+#define HAL_OSPIM_IOPORT_1_LOW            0x00000001U
+
+#define DMA_BREQ_SINGLE_BURST             0x00000000U
+#define DMA_MEMORY_TO_PERIPH              0x00000001U
+#define DMA_SINC_INCREMENTED              0x00000008U
+#define DMA_DINC_FIXED                    0x00000000U
+#define DMA_SRC_DATAWIDTH_BYTE            0x00000000U
+#define DMA_DEST_DATAWIDTH_BYTE           0x00000000U
+#define DMA_LOW_PRIORITY_HIGH_WEIGHT      0x00000002U
+#define DMA_SRC_ALLOCATED_PORT0           0x00000000U
+#define DMA_DEST_ALLOCATED_PORT0          0x00000000U
+#define DMA_TCEM_BLOCK_TRANSFER           0x00000000U
+#define DMA_NORMAL                        0x00000000U
+
+/* Commands of the simulated serial NOR, 4-byte address variants */
+#define NORSIM_CMD_WRITE_ENABLE           0x06U
+#define NORSIM_CMD_READ_STATUS            0x05U
+#define NORSIM_CMD_QUAD_PAGE_PROGRAM      0x34U
+#define NORSIM_CMD_SECTOR_ERASE           0x21U
+#define NORSIM_CMD_BLOCK_ERASE            0xDCU
+#define NORSIM_CMD_CHIP_ERASE             0xC7U
+
+#define NORSIM_PAGE_SIZE                  256U
+#define NORSIM_SECTOR_SIZE                0x1000U
+#define NORSIM_BLOCK_SIZE                 0x10000U
+#define NORSIM_SIZE                       (1U * 1024U * 1024U)  /* 1 MByte */
+
+/* Exported macro ------------------------------------------------------------*/
+#define __HAL_LINKDMA(__HANDLE__, __PPP_DMA_FIELD__, __DMA_HANDLE__)  ((__HANDLE__)->__PPP_DMA_FIELD__ = &(__DMA_HANDLE__))
+#define POSITION_VAL(VAL)                 ((uint32_t)__builtin_ctz(VAL))
+
+/* Exported variables --------------------------------------------------------*/
+extern OCTOSPI_TypeDef NORSIM_Instance;
+extern DMA_Channel_TypeDef NORSIM_DmaChannel;
+extern GPIO_TypeDef NORSIM_GpioPort;
+
+/* Exported functions ------------------------------------------------------- */
+HAL_StatusTypeDef HAL_OSPI_Init(OSPI_HandleTypeDef *hospi);
+HAL_StatusTypeDef HAL_OSPIM_Config(OSPI_HandleTypeDef *hospi, OSPIM_CfgTypeDef *cfg, uint32_t Timeout);
+HAL_StatusTypeDef HAL_OSPI_Command(OSPI_HandleTypeDef *hospi, OSPI_RegularCmdTypeDef *cmd, uint32_t Timeout);
+HAL_StatusTypeDef HAL_OSPI_Transmit_DMA(OSPI_HandleTypeDef *hospi, uint8_t *pData);
+HAL_StatusTypeDef HAL_OSPI_AutoPolling_IT(OSPI_HandleTypeDef *hospi, OSPI_AutoPollingTypeDef *cfg);
+HAL_StatusTypeDef HAL_OSPI_MemoryMapped(OSPI_HandleTypeDef *hospi, OSPI_MemoryMappedTypeDef *cfg);
+HAL_StatusTypeDef HAL_OSPI_Abort(OSPI_HandleTypeDef *hospi);
+HAL_OSPI_StateTypeDef HAL_OSPI_GetState(OSPI_HandleTypeDef *hospi);
+void HAL_OSPI_IRQHandler(OSPI_HandleTypeDef *hospi);
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma);
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma);
+
+void NORSIM_Init(void);
+void NORSIM_Elapse(uint32_t Time);
+uint8_t *NORSIM_GetImage(void);
+uint32_t NORSIM_GetCommandCount(uint32_t Instruction);
+uint8_t NORSIM_IsMemoryMapped(void);
+void NORSIM_StallDma(FunctionalState State);
+void NORSIM_StickBusy(FunctionalState State);
+void NORSIM_FailNextCommand(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NORSIM_H */
@@ -0,0 +1,56 @@
+/**
+  ******************************************************************************
+  * @file    openbootloader_conf.h
+  * @author  MCD Application Team
+  * @brief   Open Bootloader configuration of the host tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef OPENBOOTLOADER_CONF_H
+#define OPENBOOTLOADER_CONF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "platform.h"
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+
+/* -------------------------- Definitions for Memories ---------------------- */
+#define FLASH_BL_SIZE                     (64U * 1024U)  /* Size of the simulated FLASH: two banks of four pages */
+#define FLASH_START_ADDRESS               FLASH_BASE  /* start of Flash  */
+#define FLASH_END_ADDRESS                 (FLASH_BASE + FLASH_BL_SIZE)  /* end of Flash  */
+
+#define EXTNOR_BL_SIZE                    (1U * 1024U * 1024U)  /* Size of the simulated external NOR */
+#define EXTNOR_START_ADDRESS              0x90000000U  /* Memory-mapped start of external NOR */
+#define EXTNOR_END_ADDRESS                (EXTNOR_START_ADDRESS + EXTNOR_BL_SIZE)  /* Memory-mapped end of external NOR */
+
+#define FLASH_AREA                        0x1U  /* Flash Address Area */
+#define EXTNOR_AREA                       0x7U  /* External NOR Address area */
+
+#define FLASH_MASS_ERASE                  0xFFFF
+#define FLASH_BANK1_ERASE                 0xFFFE
+#define FLASH_BANK2_ERASE                 0xFFFD
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OPENBOOTLOADER_CONF_H */
@@ -0,0 +1,61 @@
+/**
+  ******************************************************************************
+  * @file    platform.h
+  * @author  MCD Application Team
+  * @brief   Host replacement of the device platform header for the host tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+/* Same definitions as the device headers */
+typedef enum
+{
+  RESET = 0U,
+  SET = !RESET
+} FlagStatus;
+
+typedef enum
+{
+  DISABLE = 0U,
+  ENABLE = !DISABLE
+} FunctionalState;
+
+typedef enum
+{
+  SUCCESS = 0U,
+  ERROR = !SUCCESS
+} ErrorStatus;
+
+/* Exported constants --------------------------------------------------------*/
+#define FLASH_BASE                        0x08000000UL  /* Only used to place the simulated FLASH */
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PLATFORM_H */
@@ -0,0 +1,384 @@
+/**
+  ******************************************************************************
+  * @file    test_can.c
+  * @author  MCD Application Team
+  * @brief   Host test of the CAN interface on the simulated FDCAN controller: speed
+  *          table, Tx pipelining, Rx ring and busy state answers
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "host_test.h"
+#include "platform.h"
+#include "interfaces_conf.h"
+#include "cansim.h"
+#include "can_interface.h"
+#include "iwdg_interface.h"
+#include "common_interface.h"
+
+/* Private define ------------------------------------------------------------*/
+#define TEST_RX_RING_SIZE                 16U    /* Frames of the reception ring of the CAN interface */
+#define TEST_DEVICE_ID                    0x79U  /* Identifier of the device frames before any command */
+#define TEST_COMMAND_ID                   0x31U  /* Identifier of the command used by the tests */
+#define TEST_OTHER_ID                     0x22U  /* Identifier of a frame which is not a poll */
+#define TEST_BUSY_PATTERN                 0xB0U  /* First byte of the busy frame returned by the stub */
+#define TEST_SPEED_1MBPS                  4U     /* Index of 1 Mbps in the CAN speed table */
+#define TEST_FRAMES_NB                    64U    /* Frames sent by the throughput test */
+#define TEST_CPU_TIME                     20U    /* Time in us to prepare one frame */
+#define TEST_CPU_STALL_TIME               250U   /* Time in us to prepare every fourth frame, e.g. a FLASH read */
+
+/* Private variables ---------------------------------------------------------*/
+static const uint32_t a_TestBitRates[5] = {125000U, 125000U, 250000U, 500000U, 1000000U};
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Reset the simulated controller and configure the CAN interface at a given speed.
+  * @param  TxBuffers Number of Tx buffers of the simulated controller.
+  * @param  Speed Index in the CAN speed table.
+  * @retval None.
+  */
+static void TEST_Setup(uint32_t TxBuffers, uint32_t Speed)
+{
+  CANSIM_Init(TxBuffers, OPENBL_CAN_IRQHandler);
+
+  OPENBL_CAN_ChangePrescaler(Speed);
+  OPENBL_CAN_Configuration();
+}
+
+/**
+  * @brief  Check the bit rate of every entry of the speed table and the speed change flow:
+  *         the response sent before the change leaves at the previous speed.
+  * @retval None.
+  */
+static void TEST_SpeedTable(void)
+{
+  uint32_t speed;
+  uint8_t ack = 0x79U;
+  CANSIM_FrameTypeDef frame;
+
+  for (speed = 0U; speed < 5U; speed++)
+  {
+    TEST_Setup(CANSIM_TX_BUFFERS_MAX, speed);
+
+    HOST_TEST_CHECK(CANSIM_GetBitRate() == a_TestBitRates[speed]);
+  }
+
+  /* An index beyond the table keeps the current speed */
+  OPENBL_CAN_ChangePrescaler(5U);
+  OPENBL_CAN_Configuration();
+
+  HOST_TEST_CHECK(CANSIM_GetBitRate() == a_TestBitRates[4]);
+
+  /* The ACK of the speed command is flushed by the de-initialization */
+  TEST_Setup(CANSIM_TX_BUFFERS_MAX, 1U);
+
+  OPENBL_CAN_SendByte(ack);
+  OPENBL_CAN_ChangePrescaler(3U);
+  OPENBL_CAN_DeInit();
+
+  HOST_TEST_CHECK(CANSIM_HostReceive(&frame) == 1U);
+  HOST_TEST_CHECK((frame.Length == 1U) && (frame.Data[0] == ack));
+  HOST_TEST_CHECK(frame.EndTime == CANSIM_GetFrameTime(1U));
+
+  OPENBL_CAN_Configuration();
+
+  HOST_TEST_CHECK(CANSIM_GetBitRate() == a_TestBitRates[3]);
+}
+
+/**
+  * @brief  Check that the frames queued faster than the bus are sent in order and unchanged.
+  * @retval None.
+  */
+static void TEST_Transmit(void)
+{
+  uint32_t index;
+  uint8_t a_data[8];
+  CANSIM_FrameTypeDef frame;
+
+  TEST_Setup(CANSIM_TX_BUFFERS_MAX, TEST_SPEED_1MBPS);
+
+  for (index = 0U; index < 10U; index++)
+  {
+    memset(a_data, (int)index, sizeof(a_data));
+    OPENBL_CAN_SendBytes(a_data, (index % 8U) + 1U);
+  }
+
+  CANSIM_RunUntilIdle();
+
+  for (index = 0U; index < 10U; index++)
+  {
+    memset(a_data, (int)index, sizeof(a_data));
+
+    HOST_TEST_CHECK(CANSIM_HostReceive(&frame) == 1U);
+    HOST_TEST_CHECK(frame.Identifier == TEST_DEVICE_ID);
+    HOST_TEST_CHECK(frame.Length == ((index % 8U) + 1U));
+    HOST_TEST_CHECK(memcmp(frame.Data, a_data, frame.Length) == 0);
+  }
+
+  HOST_TEST_CHECK(CANSIM_HostReceive(&frame) == 0U);
+}
+
+/**
+  * @brief  Check the reception ring: a stalled consumer loses no frame until the ring and the
+  *         Rx FIFO are full, and the reception resumes without new traffic.
+  * @retval None.
+  */
+static void TEST_ReceiveRing(void)
+{
+  uint32_t index;
+  uint32_t stored = TEST_RX_RING_SIZE + CANSIM_RX_FIFO_SIZE;
+  uint8_t data;
+
+  TEST_Setup(CANSIM_TX_BUFFERS_MAX, TEST_SPEED_1MBPS);
+
+  HOST_TEST_CHECK(OPENBL_CAN_ProtocolDetection() == 0U);
+
+  for (index = 0U; index < stored; index++)
+  {
+    data = (uint8_t)index;
+    CANSIM_HostSend(TEST_COMMAND_ID, &data, 1U);
+  }
+
+  CANSIM_RunUntilIdle();
+
+  HOST_TEST_CHECK(CANSIM_GetLostFrames() == 0U);
+  HOST_TEST_CHECK(OPENBL_CAN_ProtocolDetection() == 1U);
+
+  for (index = 0U; index < stored; index++)
+  {
+    HOST_TEST_CHECK(OPENBL_CAN_ReadByte() == (uint8_t)index);
+  }
+
+  HOST_TEST_CHECK(OPENBL_CAN_ProtocolDetection() == 0U);
+
+  /* One more frame than the ring and the Rx FIFO hold is lost */
+  for (index = 0U; index <= stored; index++)
+  {
+    data = (uint8_t)index;
+    CANSIM_HostSend(TEST_COMMAND_ID, &data, 1U);
+  }
+
+  CANSIM_RunUntilIdle();
+
+  HOST_TEST_CHECK(CANSIM_GetLostFrames() == 1U);
+
+  for (index = 0U; index < stored; index++)
+  {
+    HOST_TEST_CHECK(OPENBL_CAN_ReadByte() == (uint8_t)index);
+  }
+
+  HOST_TEST_CHECK(OPENBL_CAN_ProtocolDetection() == 0U);
+}
+
+/**
+  * @brief  Check that even and odd identifiers, received through the two Rx FIFOs, are all
+  *         received in order by a consumer keeping up with the bus.
+  * @retval None.
+  */
+static void TEST_ReceiveBothFifos(void)
+{
+  uint32_t index;
+  uint8_t a_data[8];
+  uint8_t a_read[8];
+
+  TEST_Setup(CANSIM_TX_BUFFERS_MAX, TEST_SPEED_1MBPS);
+
+  for (index = 0U; index < 40U; index++)
+  {
+    memset(a_data, (int)index, sizeof(a_data));
+    CANSIM_HostSend(TEST_COMMAND_ID + (index % 2U), a_data, sizeof(a_data));
+  }
+
+  for (index = 0U; index < 40U; index++)
+  {
+    OPENBL_CAN_ReadBytes(a_read, sizeof(a_read));
+
+    memset(a_data, (int)index, sizeof(a_data));
+    HOST_TEST_CHECK(memcmp(a_read, a_data, sizeof(a_data)) == 0);
+  }
+
+  HOST_TEST_CHECK(CANSIM_GetLostFrames() == 0U);
+}
+
+/**
+  * @brief  Send frames with a preparation time per frame, as a read memory response does.
+  * @param  TxBuffers Number of Tx buffers of the simulated controller.
+  * @param  Serialized 1 to wait for the end of each frame before preparing the next one.
+  * @retval Returns the time in us until the last frame is received by the host.
+  */
+static uint32_t TEST_SendFrames(uint32_t TxBuffers, uint32_t Serialized)
+{
+  uint32_t index;
+  uint32_t received = 0U;
+  uint8_t a_data[8];
+  CANSIM_FrameTypeDef frame;
+
+  TEST_Setup(TxBuffers, TEST_SPEED_1MBPS);
+
+  for (index = 0U; index < TEST_FRAMES_NB; index++)
+  {
+    CANSIM_Elapse(((index % 4U) == 3U) ? TEST_CPU_STALL_TIME : TEST_CPU_TIME);
+
+    memset(a_data, (int)index, sizeof(a_data));
+    OPENBL_CAN_SendBytes(a_data, sizeof(a_data));
+
+    while ((Serialized != 0U) && (CANSIM_Instance.TXBRP != 0U))
+    {
+      CANSIM_Elapse(1U);
+    }
+  }
+
+  CANSIM_RunUntilIdle();
+
+  while (CANSIM_HostReceive(&frame) == 1U)
+  {
+    HOST_TEST_CHECK(frame.Data[0] == (uint8_t)received);
+    received++;
+  }
+
+  HOST_TEST_CHECK(received == TEST_FRAMES_NB);
+
+  return frame.EndTime;
+}
+
+/**
+  * @brief  Compare the time to send a response with three Tx buffers, with one Tx buffer and
+  *         with a wait for the end of each frame, and report the time saved.
+  * @retval None.
+  */
+static void TEST_Throughput(void)
+{
+  uint32_t serialized_time;
+  uint32_t single_time;
+  uint32_t pipelined_time;
+  uint32_t bus_time;
+
+  serialized_time = TEST_SendFrames(CANSIM_TX_BUFFERS_MAX, 1U);
+  single_time     = TEST_SendFrames(1U, 0U);
+  pipelined_time  = TEST_SendFrames(CANSIM_TX_BUFFERS_MAX, 0U);
+  bus_time        = TEST_FRAMES_NB * CANSIM_GetFrameTime(8U);
+
+  printf("test_can: %u frames at 1 Mbps, bus time %u us\n", TEST_FRAMES_NB, bus_time);
+  printf("test_can:   wait per frame %6u us\n", serialized_time);
+  printf("test_can:   one Tx buffer  %6u us\n", single_time);
+  printf("test_can:   three buffers  %6u us (%u us saved)\n", pipelined_time, serialized_time - pipelined_time);
+
+  HOST_TEST_CHECK(pipelined_time < single_time);
+  HOST_TEST_CHECK(single_time < serialized_time);
+
+  /* The three Tx buffers hide the preparation time: the bus never idles after the first frame */
+  HOST_TEST_CHECK(pipelined_time <= (bus_time + TEST_CPU_TIME + TEST_FRAMES_NB));
+}
+
+/**
+  * @brief  Check that only a poll frame is answered with the busy frame.
+  * @retval None.
+  */
+static void TEST_BusyState(void)
+{
+  uint8_t data = 0U;
+  CANSIM_FrameTypeDef frame;
+
+  TEST_Setup(CANSIM_TX_BUFFERS_MAX, TEST_SPEED_1MBPS);
+
+  /* The command sets the identifier of the responses and of the polls */
+  CANSIM_HostSend(TEST_COMMAND_ID, &data, 1U);
+  HOST_TEST_CHECK(OPENBL_CAN_GetCommandOpcode() == TEST_COMMAND_ID);
+
+  /* Nothing to answer */
+  OPENBL_CAN_SendBusyState();
+  CANSIM_RunUntilIdle();
+
+  HOST_TEST_CHECK(CANSIM_HostReceive(&frame) == 0U);
+
+  /* A poll is answered and consumed */
+  CANSIM_HostSend(TEST_COMMAND_ID, &data, 0U);
+  CANSIM_RunUntilIdle();
+  OPENBL_CAN_SendBusyState();
+  CANSIM_RunUntilIdle();
+
+  HOST_TEST_CHECK(CANSIM_HostReceive(&frame) == 1U);
+  HOST_TEST_CHECK(frame.Identifier == TEST_COMMAND_ID);
+  HOST_TEST_CHECK(frame.Length == COMMON_BUSY_FRAME_SIZE);
+  HOST_TEST_CHECK((frame.Data[0] == TEST_BUSY_PATTERN) && (frame.Data[COMMON_BUSY_FRAME_SIZE - 1U] == 0xB6U));
+  HOST_TEST_CHECK(OPENBL_CAN_ProtocolDetection() == 0U);
+
+  /* Another frame is left for the command */
+  data = 0x5AU;
+  CANSIM_HostSend(TEST_OTHER_ID, &data, 1U);
+  CANSIM_RunUntilIdle();
+  OPENBL_CAN_SendBusyState();
+  CANSIM_RunUntilIdle();
+
+  HOST_TEST_CHECK(CANSIM_HostReceive(&frame) == 0U);
+  HOST_TEST_CHECK(OPENBL_CAN_ReadByte() == data);
+}
+
+/**
+  * @brief  Check that a bus error is reported once.
+  * @retval None.
+  */
+static void TEST_LinkError(void)
+{
+  TEST_Setup(CANSIM_TX_BUFFERS_MAX, TEST_SPEED_1MBPS);
+
+  HOST_TEST_CHECK(OPENBL_CAN_GetLinkErrorStatus() == RESET);
+
+  CANSIM_InjectBusError();
+
+  HOST_TEST_CHECK(OPENBL_CAN_GetLinkErrorStatus() == SET);
+  HOST_TEST_CHECK(OPENBL_CAN_GetLinkErrorStatus() == RESET);
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  The watchdog refresh of the wait loops lets the simulated time run.
+  * @retval None.
+  */
+void OPENBL_IWDG_Refresh(void)
+{
+  CANSIM_Elapse(1U);
+}
+
+/**
+  * @brief  Busy frame with a known content.
+  * @param  pFrame The frame to be filled.
+  * @retval Returns the size of the frame.
+  */
+uint32_t Common_SetBusyFrame(uint8_t *pFrame)
+{
+  uint32_t index;
+
+  for (index = 0U; index < COMMON_BUSY_FRAME_SIZE; index++)
+  {
+    pFrame[index] = (uint8_t)(TEST_BUSY_PATTERN + index);
+  }
+
+  return COMMON_BUSY_FRAME_SIZE;
+}
+
+int main(void)
+{
+  TEST_SpeedTable();
+  TEST_Transmit();
+  TEST_ReceiveRing();
+  TEST_ReceiveBothFifos();
+  TEST_Throughput();
+  TEST_BusyState();
+  TEST_LinkError();
+
+  return HOST_TEST_RESULT("test_can");
+}
@@ -0,0 +1,223 @@
+/**
+  ******************************************************************************
+  * @file    test_extnor.c
+  * @author  MCD Application Team
+  * @brief   Host test of the external NOR interface on the simulated OCTOSPI and
+  *          NOR: page programming, erase commands and failures
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "host_test.h"
+#include "platform.h"
+#include "interfaces_conf.h"
+#include "norsim.h"
+#include "openbl_mem.h"
+#include "iwdg_interface.h"
+#include "extnor_interface.h"
+
+/* Private define ------------------------------------------------------------*/
+#define TEST_REFRESH_TIME                 10U    /* Simulated time in us between two watchdog refreshes */
+#define TEST_OFFSET                       200U   /* Offset of the written data, inside the first page */
+#define TEST_LENGTH                       1000U  /* Length of the written data, over five pages */
+#define TEST_SECTOR                       17U    /* Sector erased alone, after the first block */
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t a_Data[TEST_LENGTH];
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Reset the simulated NOR and configure the interface.
+  * @retval None.
+  */
+static void TEST_Setup(void)
+{
+  uint32_t index;
+
+  for (index = 0U; index < TEST_LENGTH; index++)
+  {
+    a_Data[index] = (uint8_t)((index * 7U) + 3U);
+  }
+
+  NORSIM_Init();
+  OPENBL_EXTNOR_Configuration();
+}
+
+/**
+  * @brief  Erase sectors through the erase request layout: sectors number then sector numbers.
+  * @param  FirstSector The first sector of the run to be erased.
+  * @param  SectorsNumber The number of consecutive sectors.
+  * @param  ExtraSector One more sector listed after the run.
+  * @retval Returns the status of the erase.
+  */
+static ErrorStatus TEST_EraseSectors(uint16_t FirstSector, uint16_t SectorsNumber, uint16_t ExtraSector)
+{
+  uint16_t index;
+  uint16_t sector;
+  uint8_t a_request[2U * 20U];
+
+  a_request[0] = (uint8_t)(SectorsNumber + 1U);
+  a_request[1] = 0U;
+
+  for (index = 0U; index <= SectorsNumber; index++)
+  {
+    sector = (index < SectorsNumber) ? (uint16_t)(FirstSector + index) : ExtraSector;
+
+    a_request[2U + (2U * index)]      = (uint8_t)sector;
+    a_request[2U + (2U * index) + 1U] = (uint8_t)(sector >> 8);
+  }
+
+  return OPENBL_EXTNOR_Erase(a_request, 2U + (2U * (SectorsNumber + 1U)));
+}
+
+/**
+  * @brief  Check that a write is split on the page boundaries and leaves the NOR memory mapped.
+  * @retval None.
+  */
+static void TEST_Write(void)
+{
+  uint8_t *p_image;
+
+  TEST_Setup();
+
+  p_image = NORSIM_GetImage();
+
+  HOST_TEST_CHECK(NORSIM_IsMemoryMapped() == 1U);
+  HOST_TEST_CHECK(OPENBL_EXTNOR_Write(EXTNOR_START_ADDRESS + TEST_OFFSET, a_Data, TEST_LENGTH) == SUCCESS);
+
+  HOST_TEST_CHECK(memcmp(&p_image[TEST_OFFSET], a_Data, TEST_LENGTH) == 0);
+  HOST_TEST_CHECK(p_image[TEST_OFFSET - 1U] == 0xFFU);
+  HOST_TEST_CHECK(p_image[TEST_OFFSET + TEST_LENGTH] == 0xFFU);
+
+  /* The bytes 200 to 1199 touch the pages 0 to 4 */
+  HOST_TEST_CHECK(NORSIM_GetCommandCount(EXTNOR_CMD_QUAD_PAGE_PROGRAM) == 5U);
+  HOST_TEST_CHECK(NORSIM_GetCommandCount(EXTNOR_CMD_WRITE_ENABLE) == 5U);
+  HOST_TEST_CHECK(NORSIM_IsMemoryMapped() == 1U);
+}
+
+/**
+  * @brief  Check that a whole aligned block is erased with one block erase, the other sectors
+  *         with sector erases, and the chip erase.
+  * @retval None.
+  */
+static void TEST_Erase(void)
+{
+  uint8_t *p_image;
+  uint32_t sectors_per_block = EXTNOR_BLOCK_SIZE / EXTNOR_SECTOR_SIZE;
+
+  TEST_Setup();
+
+  p_image = NORSIM_GetImage();
+  memset(p_image, 0x00, 2U * EXTNOR_BLOCK_SIZE);
+
+  HOST_TEST_CHECK(TEST_EraseSectors(0U, (uint16_t)sectors_per_block, TEST_SECTOR) == SUCCESS);
+
+  HOST_TEST_CHECK(NORSIM_GetCommandCount(EXTNOR_CMD_BLOCK_ERASE) == 1U);
+  HOST_TEST_CHECK(NORSIM_GetCommandCount(EXTNOR_CMD_SECTOR_ERASE) == 1U);
+  HOST_TEST_CHECK((p_image[0] == 0xFFU) && (p_image[EXTNOR_BLOCK_SIZE - 1U] == 0xFFU));
+  HOST_TEST_CHECK(p_image[EXTNOR_BLOCK_SIZE] == 0x00U);
+  HOST_TEST_CHECK(p_image[TEST_SECTOR * EXTNOR_SECTOR_SIZE] == 0xFFU);
+  HOST_TEST_CHECK(p_image[(TEST_SECTOR + 1U) * EXTNOR_SECTOR_SIZE] == 0x00U);
+  HOST_TEST_CHECK(NORSIM_IsMemoryMapped() == 1U);
+
+  /* A run that does not start on a block boundary is erased sector by sector */
+  HOST_TEST_CHECK(TEST_EraseSectors(1U, (uint16_t)sectors_per_block, 0U) == SUCCESS);
+  HOST_TEST_CHECK(NORSIM_GetCommandCount(EXTNOR_CMD_BLOCK_ERASE) == 1U);
+  HOST_TEST_CHECK(NORSIM_GetCommandCount(EXTNOR_CMD_SECTOR_ERASE) == (2U + sectors_per_block));
+
+  /* A sector beyond the NOR is rejected */
+  HOST_TEST_CHECK(TEST_EraseSectors(0U, 0U, (uint16_t)(EXTNOR_BL_SIZE / EXTNOR_SECTOR_SIZE)) == ERROR);
+
+  HOST_TEST_CHECK(OPENBL_EXTNOR_MassErase(NULL, 0U) == SUCCESS);
+  HOST_TEST_CHECK(NORSIM_GetCommandCount(EXTNOR_CMD_CHIP_ERASE) == 1U);
+  HOST_TEST_CHECK(p_image[EXTNOR_BLOCK_SIZE] == 0xFFU);
+}
+
+/**
+  * @brief  Check that the failures are reported, bounded in time and leave the NOR memory mapped.
+  * @retval None.
+  */
+static void TEST_Failures(void)
+{
+  uint32_t start_tick;
+  uint8_t *p_image;
+
+  TEST_Setup();
+
+  p_image = NORSIM_GetImage();
+
+  /* A DMA that never completes times out and is aborted: nothing is programmed */
+  NORSIM_StallDma(ENABLE);
+  start_tick = HAL_GetTick();
+
+  HOST_TEST_CHECK(OPENBL_EXTNOR_Write(EXTNOR_START_ADDRESS, a_Data, EXTNOR_PAGE_SIZE) == ERROR);
+  HOST_TEST_CHECK((HAL_GetTick() - start_tick) > HAL_OSPI_TIMEOUT_DEFAULT_VALUE);
+  HOST_TEST_CHECK((HAL_GetTick() - start_tick) < (2U * HAL_OSPI_TIMEOUT_DEFAULT_VALUE));
+  HOST_TEST_CHECK(p_image[0] == 0xFFU);
+  HOST_TEST_CHECK(NORSIM_IsMemoryMapped() == 1U);
+
+  NORSIM_StallDma(DISABLE);
+
+  /* A NOR that stays busy times out the status polling */
+  NORSIM_StickBusy(ENABLE);
+
+  HOST_TEST_CHECK(OPENBL_EXTNOR_Write(EXTNOR_START_ADDRESS, a_Data, EXTNOR_PAGE_SIZE) == ERROR);
+  HOST_TEST_CHECK(NORSIM_IsMemoryMapped() == 1U);
+
+  NORSIM_StickBusy(DISABLE);
+
+  /* A failed command stops the write at its page */
+  NORSIM_FailNextCommand();
+
+  HOST_TEST_CHECK(OPENBL_EXTNOR_Write(EXTNOR_START_ADDRESS + EXTNOR_PAGE_SIZE, a_Data, TEST_LENGTH) == ERROR);
+  HOST_TEST_CHECK(p_image[EXTNOR_PAGE_SIZE] == 0xFFU);
+  HOST_TEST_CHECK(NORSIM_IsMemoryMapped() == 1U);
+
+  /* The interface recovers */
+  HOST_TEST_CHECK(OPENBL_EXTNOR_Write(EXTNOR_START_ADDRESS + EXTNOR_PAGE_SIZE, a_Data, TEST_LENGTH) == SUCCESS);
+  HOST_TEST_CHECK(memcmp(&p_image[EXTNOR_PAGE_SIZE], a_Data, TEST_LENGTH) == 0);
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  The watchdog refresh of the wait loops lets the simulated time run.
+  * @retval None.
+  */
+void OPENBL_IWDG_Refresh(void)
+{
+  NORSIM_Elapse(TEST_REFRESH_TIME);
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+  (void)IRQn;
+  (void)PreemptPriority;
+  (void)SubPriority;
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+  (void)IRQn;
+}
+
+int main(void)
+{
+  TEST_Write();
+  TEST_Erase();
+  TEST_Failures();
+
+  return HOST_TEST_RESULT("test_extnor");
+}
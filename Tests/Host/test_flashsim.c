@@ -0,0 +1,164 @@
+/**
+  ******************************************************************************
+  * @file    test_flashsim.c
+  * @author  MCD Application Team
+  * @brief   Host test of the simulated FLASH: erase, program and their errors
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "host_test.h"
+#include "openbl_mem.h"
+#include "openbl_kernels.h"
+#include "flashsim_interface.h"
+
+/* Private define ------------------------------------------------------------*/
+#define TEST_PAGE                         1U     /* Page erased and programmed by the tests */
+#define TEST_PAGE_ADDRESS                 (FLASH_START_ADDRESS + (TEST_PAGE * FLASHSIM_PAGE_SIZE))
+#define TEST_PROGRAMMED_BYTE              0x5AU  /* Content of the image before the erase */
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t a_FlashImage[FLASH_BL_SIZE];
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Erase one page through the erase request layout: pages number then page numbers.
+  * @param  Page The page to be erased.
+  * @retval Returns the status of the erase.
+  */
+static ErrorStatus TEST_ErasePage(uint16_t Page)
+{
+  uint16_t a_request[2];
+
+  a_request[0] = 1U;
+  a_request[1] = Page;
+
+  return OPENBL_FLASHSIM_Erase((uint8_t *)a_request, sizeof(a_request));
+}
+
+/**
+  * @brief  Check that a page erase only erases its page.
+  * @retval None.
+  */
+static void TEST_Erase(void)
+{
+  OPENBL_FLASHSIM_Init(a_FlashImage, NULL);
+  memset(a_FlashImage, TEST_PROGRAMMED_BYTE, sizeof(a_FlashImage));
+
+  HOST_TEST_CHECK(TEST_ErasePage(TEST_PAGE) == SUCCESS);
+  HOST_TEST_CHECK(OPENBL_KERNEL_IsFilled(&a_FlashImage[TEST_PAGE * FLASHSIM_PAGE_SIZE], FLASHSIM_PAGE_SIZE, 0xFFU)
+                  == 1U);
+  HOST_TEST_CHECK(OPENBL_KERNEL_IsFilled(a_FlashImage, TEST_PAGE * FLASHSIM_PAGE_SIZE, TEST_PROGRAMMED_BYTE) == 1U);
+  HOST_TEST_CHECK(OPENBL_KERNEL_IsFilled(&a_FlashImage[(TEST_PAGE + 1U) * FLASHSIM_PAGE_SIZE],
+                                         FLASH_BL_SIZE - ((TEST_PAGE + 1U) * FLASHSIM_PAGE_SIZE),
+                                         TEST_PROGRAMMED_BYTE) == 1U);
+  HOST_TEST_CHECK(OPENBL_FLASHSIM_GetErrors() == FLASHSIM_ERROR_NONE);
+
+  /* A page beyond the simulated FLASH is rejected */
+  HOST_TEST_CHECK(TEST_ErasePage((uint16_t)(FLASH_BL_SIZE / FLASHSIM_PAGE_SIZE)) == ERROR);
+  HOST_TEST_CHECK(OPENBL_FLASHSIM_GetErrors() == FLASHSIM_ERROR_RANGE);
+}
+
+/**
+  * @brief  Check the bank erase options of the mass erase.
+  * @retval None.
+  */
+static void TEST_MassErase(void)
+{
+  uint16_t option;
+
+  OPENBL_FLASHSIM_Init(a_FlashImage, NULL);
+  memset(a_FlashImage, TEST_PROGRAMMED_BYTE, sizeof(a_FlashImage));
+
+  option = FLASH_BANK2_ERASE;
+  HOST_TEST_CHECK(OPENBL_FLASHSIM_MassErase((uint8_t *)&option, sizeof(option)) == SUCCESS);
+  HOST_TEST_CHECK(OPENBL_KERNEL_IsFilled(a_FlashImage, FLASHSIM_BANK_SIZE, TEST_PROGRAMMED_BYTE) == 1U);
+  HOST_TEST_CHECK(OPENBL_KERNEL_IsFilled(&a_FlashImage[FLASHSIM_BANK_SIZE], FLASHSIM_BANK_SIZE, 0xFFU) == 1U);
+
+  option = FLASH_MASS_ERASE;
+  HOST_TEST_CHECK(OPENBL_FLASHSIM_MassErase((uint8_t *)&option, sizeof(option)) == SUCCESS);
+  HOST_TEST_CHECK(OPENBL_KERNEL_IsFilled(a_FlashImage, FLASH_BL_SIZE, 0xFFU) == 1U);
+
+  option = 0x1234U;
+  HOST_TEST_CHECK(OPENBL_FLASHSIM_MassErase((uint8_t *)&option, sizeof(option)) == ERROR);
+}
+
+/**
+  * @brief  Check the programming of an unaligned buffer and the refusal to program twice.
+  * @retval None.
+  */
+static void TEST_Program(void)
+{
+  OPENBL_FLASHSIM_TimingTypeDef timing = {1500U, 20000U, 120U, NULL};
+  uint8_t a_data[40];
+  uint8_t a_other[40];
+  uint32_t index;
+
+  for (index = 0U; index < sizeof(a_data); index++)
+  {
+    a_data[index]  = (uint8_t)(index + 1U);
+    a_other[index] = (uint8_t)(0x80U + index);
+  }
+
+  OPENBL_FLASHSIM_Init(a_FlashImage, &timing);
+  memset(a_FlashImage, TEST_PROGRAMMED_BYTE, sizeof(a_FlashImage));
+
+  HOST_TEST_CHECK(TEST_ErasePage(TEST_PAGE) == SUCCESS);
+
+  /* 40 bytes from offset 6 touch the quad-words 0 to 2 of the page */
+  HOST_TEST_CHECK(OPENBL_FLASHSIM_Write(TEST_PAGE_ADDRESS + 6U, a_data, sizeof(a_data)) == SUCCESS);
+
+  HOST_TEST_CHECK(OPENBL_FLASHSIM_GetErrors() == FLASHSIM_ERROR_NONE);
+  HOST_TEST_CHECK(OPENBL_KERNEL_Compare(&a_FlashImage[(TEST_PAGE * FLASHSIM_PAGE_SIZE) + 6U], a_data,
+                                        sizeof(a_data)) == 0U);
+  HOST_TEST_CHECK(OPENBL_FLASHSIM_Read(TEST_PAGE_ADDRESS + 5U) == 0xFFU);
+  HOST_TEST_CHECK(OPENBL_FLASHSIM_Read(TEST_PAGE_ADDRESS + 6U) == a_data[0]);
+  HOST_TEST_CHECK(OPENBL_FLASHSIM_Read(TEST_PAGE_ADDRESS + 46U) == 0xFFU);
+  HOST_TEST_CHECK(OPENBL_FLASHSIM_GetElapsedTime() == (1500U + (3U * 120U)));
+
+  /* The quad-words are already programmed, the FLASH refuses them and keeps its content */
+  HOST_TEST_CHECK(OPENBL_FLASHSIM_Write(TEST_PAGE_ADDRESS + 6U, a_other, sizeof(a_other)) == ERROR);
+
+  HOST_TEST_CHECK(OPENBL_FLASHSIM_GetErrors() == FLASHSIM_ERROR_NOT_ERASED);
+  HOST_TEST_CHECK(OPENBL_KERNEL_Compare(&a_FlashImage[(TEST_PAGE * FLASHSIM_PAGE_SIZE) + 6U], a_data,
+                                        sizeof(a_data)) == 0U);
+
+  /* The digest is the one of the CRC peripheral: the word 0x12345678 gives 0xDF8A8A2B */
+  a_data[0] = 0x78U;
+  a_data[1] = 0x56U;
+  a_data[2] = 0x34U;
+  a_data[3] = 0x12U;
+  HOST_TEST_CHECK(TEST_ErasePage(TEST_PAGE) == SUCCESS);
+  HOST_TEST_CHECK(OPENBL_FLASHSIM_Write(TEST_PAGE_ADDRESS, a_data, 4U) == SUCCESS);
+
+  HOST_TEST_CHECK(OPENBL_FLASHSIM_ComputeDigest(TEST_PAGE_ADDRESS, 4U) == 0xDF8A8A2BU);
+
+  /* A write beyond the simulated FLASH is rejected */
+  OPENBL_FLASHSIM_Init(a_FlashImage, NULL);
+  HOST_TEST_CHECK(OPENBL_FLASHSIM_Write(FLASH_END_ADDRESS - 8U, a_data, 16U) == ERROR);
+
+  HOST_TEST_CHECK(OPENBL_FLASHSIM_GetErrors() == FLASHSIM_ERROR_RANGE);
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+int main(void)
+{
+  TEST_Erase();
+  TEST_MassErase();
+  TEST_Program();
+
+  return HOST_TEST_RESULT("test_flashsim");
+}
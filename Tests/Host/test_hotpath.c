@@ -0,0 +1,161 @@
+/**
+  ******************************************************************************
+  * @file    test_hotpath.c
+  * @author  MCD Application Team
+  * @brief   Host report of the cycles saved by executing the hot paths from RAM
+  *          instead of FLASH, for the workloads of a Write Memory sequence
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "host_test.h"
+#include "platform.h"
+#include "openbl_kernels.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  const char *pName;
+  uint32_t Refetches;
+} TEST_BenchmarkTypeDef;
+
+/* Private define ------------------------------------------------------------*/
+/* Fetch model of the target: the bootloader leaves the instruction cache disabled, so each taken
+   branch into FLASH code refetches its target line and waits for the FLASH latency. From RAM the
+   same branch completes at zero wait-state. The sequential fetches are covered by the prefetch. */
+#define TEST_WAIT_STATES                  4U     /* FLASH latency at the 160 MHz system clock */
+#define TEST_SYSCLK_MHZ                   160U
+#define TEST_CALL_REFETCHES               2U     /* The call and the return of a hot path function */
+
+#define TEST_WORD_SIZE                    4U
+#define TEST_PACKET_SIZE                  256U   /* Data of one Write Memory command */
+#define TEST_PAGE_SIZE                    8192U  /* FLASH page handled by the write cache */
+#define TEST_CRC_ROUNDS                   9U     /* Taken branches per CRC32 word: 8 nibbles, then the next word */
+#define TEST_BENCHMARKS_NB                7U
+
+/* Private variables ---------------------------------------------------------*/
+static uint32_t a_Page1[TEST_PAGE_SIZE / TEST_WORD_SIZE];
+static uint32_t a_Page2[TEST_PAGE_SIZE / TEST_WORD_SIZE];
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Count the loop iterations of a kernel with a byte head, a word body and a byte tail.
+  * @param  pData Pointer to the buffer processed by the kernel.
+  * @param  Length Size of the buffer.
+  * @retval Returns the number of iterations, each of them ends with a taken branch.
+  */
+static uint32_t TEST_KernelIterations(const uint8_t *pData, uint32_t Length)
+{
+  uint32_t head;
+
+  head = (uint32_t)((TEST_WORD_SIZE - ((uintptr_t)pData & (TEST_WORD_SIZE - 1U))) & (TEST_WORD_SIZE - 1U));
+  head = (head < Length) ? head : Length;
+
+  return head + ((Length - head) / TEST_WORD_SIZE) + ((Length - head) % TEST_WORD_SIZE);
+}
+
+/**
+  * @brief  Run the kernels on the buffers of a Write Memory sequence and count their refetches.
+  * @note   The results of the kernels are checked on the way.
+  * @param  pBenchmarks Table of the benchmarks to be filled.
+  * @retval None.
+  */
+static void TEST_RunBenchmarks(TEST_BenchmarkTypeDef *pBenchmarks)
+{
+  uint8_t *p_page1 = (uint8_t *)a_Page1;
+  uint8_t *p_page2 = (uint8_t *)a_Page2;
+  uint32_t index;
+  uint8_t xor = 0U;
+
+  /* Reception of the packet: one call of the byte read per byte, its polling waits for the line */
+  pBenchmarks[0].pName     = "USART ReadByte, 256 bytes";
+  pBenchmarks[0].Refetches = TEST_PACKET_SIZE * TEST_CALL_REFETCHES;
+
+  for (index = 0U; index < TEST_PACKET_SIZE; index++)
+  {
+    p_page2[index] = (uint8_t)((index * 13U) + 1U);
+    xor ^= p_page2[index];
+  }
+
+  pBenchmarks[1].pName     = "XOR checksum, 256 bytes";
+  pBenchmarks[1].Refetches = TEST_KernelIterations(p_page2, TEST_PACKET_SIZE) + TEST_CALL_REFETCHES;
+  HOST_TEST_CHECK(OPENBL_KERNEL_Xor(p_page2, TEST_PACKET_SIZE, 0U) == xor);
+
+  /* The RAM write copies one word per iteration */
+  pBenchmarks[2].pName     = "RAM write, 256 bytes";
+  pBenchmarks[2].Refetches = (TEST_PACKET_SIZE / TEST_WORD_SIZE) + TEST_CALL_REFETCHES;
+
+  pBenchmarks[3].pName     = "Cache slot fill, 8 KB";
+  pBenchmarks[3].Refetches = TEST_KernelIterations(p_page1, TEST_PAGE_SIZE) + TEST_CALL_REFETCHES;
+  OPENBL_KERNEL_Fill(p_page1, TEST_PAGE_SIZE, 0xFFU);
+  HOST_TEST_CHECK((p_page1[0] == 0xFFU) && (p_page1[TEST_PAGE_SIZE - 1U] == 0xFFU));
+
+  pBenchmarks[4].pName     = "Blank check, 8 KB";
+  pBenchmarks[4].Refetches = TEST_KernelIterations(p_page1, TEST_PAGE_SIZE) + TEST_CALL_REFETCHES;
+  HOST_TEST_CHECK(OPENBL_KERNEL_IsFilled(p_page1, TEST_PAGE_SIZE, 0xFFU) == 1U);
+
+  /* The compare calls the find-difference kernel */
+  (void)memcpy(p_page2, p_page1, TEST_PAGE_SIZE);
+  pBenchmarks[5].pName     = "Read-back compare, 8 KB";
+  pBenchmarks[5].Refetches = TEST_KernelIterations(p_page1, TEST_PAGE_SIZE) + (2U * TEST_CALL_REFETCHES);
+  HOST_TEST_CHECK(OPENBL_KERNEL_Compare(p_page1, p_page2, TEST_PAGE_SIZE) == 0U);
+
+  pBenchmarks[6].pName     = "CRC32 digest, 8 KB";
+  pBenchmarks[6].Refetches = ((TEST_PAGE_SIZE / TEST_WORD_SIZE) * TEST_CRC_ROUNDS) + TEST_CALL_REFETCHES;
+  HOST_TEST_CHECK(OPENBL_KERNEL_Crc32(OPENBL_KERNEL_CRC32_INIT, p_page1, TEST_PAGE_SIZE)
+                  != OPENBL_KERNEL_CRC32_INIT);
+}
+
+/**
+  * @brief  Print the cycles saved by each hot path executed from RAM.
+  * @retval None.
+  */
+static void TEST_Report(void)
+{
+  TEST_BenchmarkTypeDef a_benchmarks[TEST_BENCHMARKS_NB];
+  uint32_t index;
+  uint32_t cycles;
+  uint32_t total = 0U;
+
+  TEST_RunBenchmarks(a_benchmarks);
+
+  printf("test_hotpath: cycles saved from RAM, %u wait states at %u MHz\n", TEST_WAIT_STATES, TEST_SYSCLK_MHZ);
+
+  for (index = 0U; index < TEST_BENCHMARKS_NB; index++)
+  {
+    cycles = a_benchmarks[index].Refetches * TEST_WAIT_STATES;
+    total += cycles;
+
+    HOST_TEST_CHECK(cycles > 0U);
+
+    printf("test_hotpath:   %-26s %6u cycles (%u us)\n", a_benchmarks[index].pName, cycles,
+           cycles / TEST_SYSCLK_MHZ);
+  }
+
+  printf("test_hotpath:   %-26s %6u cycles (%u us)\n", "total", total, total / TEST_SYSCLK_MHZ);
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+int main(void)
+{
+  /* An unaligned buffer has a byte head and a byte tail around its word body */
+  HOST_TEST_CHECK(TEST_KernelIterations((const uint8_t *)a_Page1 + 1U, 10U) == 7U);
+  HOST_TEST_CHECK(TEST_KernelIterations((const uint8_t *)a_Page1, 2U) == 2U);
+
+  TEST_Report();
+
+  return HOST_TEST_RESULT("test_hotpath");
+}
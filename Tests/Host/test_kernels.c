@@ -0,0 +1,240 @@
+/**
+  ******************************************************************************
+  * @file    test_kernels.c
+  * @author  MCD Application Team
+  * @brief   Host test of the checksum, compare and fill kernels against byte-wise references
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "host_test.h"
+#include "platform.h"
+#include "openbl_kernels.h"
+
+/* Private define ------------------------------------------------------------*/
+#define TEST_BUFFER_SIZE                  96U    /* Covers the head, word body and tail of the kernels */
+#define TEST_OFFSETS                      8U     /* Start offsets tried for each buffer */
+#define TEST_CRC_POLYNOMIAL               0x04C11DB7U
+#define TEST_GUARD_BYTE                   0xA5U
+
+/* Private variables ---------------------------------------------------------*/
+static uint32_t TestSeed = 0x12345678U;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Fill a buffer with pseudo-random bytes.
+  * @param  pData Pointer to the buffer.
+  * @param  Length Size of the buffer.
+  * @retval None.
+  */
+static void TEST_Randomize(uint8_t *pData, uint32_t Length)
+{
+  uint32_t index;
+
+  for (index = 0U; index < Length; index++)
+  {
+    TestSeed     = (TestSeed * 1103515245U) + 12345U;
+    pData[index] = (uint8_t)(TestSeed >> 16);
+  }
+}
+
+/**
+  * @brief  Model of the CRC peripheral as programmed by OPENBL_FLASH_ComputeDigest: 32-bit
+  *         polynomial, initial value 0xFFFFFFFF, no reversal, fed with little-endian words.
+  * @param  pData Pointer to the area.
+  * @param  Length Size of the area, multiple of 4.
+  * @retval Returns the CRC32 of the area.
+  */
+static uint32_t TEST_PeripheralCrc32(const uint8_t *pData, uint32_t Length)
+{
+  uint32_t crc = 0xFFFFFFFFU;
+  uint32_t word;
+  uint32_t index;
+  uint32_t bit;
+
+  for (index = 0U; (index + 4U) <= Length; index += 4U)
+  {
+    word = (uint32_t)pData[index] | ((uint32_t)pData[index + 1U] << 8) | ((uint32_t)pData[index + 2U] << 16)
+           | ((uint32_t)pData[index + 3U] << 24);
+
+    /* The data register shifts the word in MSB first */
+    for (bit = 0U; bit < 32U; bit++)
+    {
+      if (((crc ^ (word << bit)) & 0x80000000U) != 0U)
+      {
+        crc = (crc << 1) ^ TEST_CRC_POLYNOMIAL;
+      }
+      else
+      {
+        crc = crc << 1;
+      }
+    }
+  }
+
+  return crc;
+}
+
+/**
+  * @brief  Check the XOR checksum for all the alignments, lengths and seeds.
+  * @retval None.
+  */
+static void TEST_Xor(void)
+{
+  uint8_t a_data[TEST_BUFFER_SIZE + TEST_OFFSETS];
+  uint32_t offset;
+  uint32_t length;
+  uint32_t index;
+  uint8_t expected;
+
+  TEST_Randomize(a_data, sizeof(a_data));
+
+  for (offset = 0U; offset < TEST_OFFSETS; offset++)
+  {
+    for (length = 0U; length <= TEST_BUFFER_SIZE; length++)
+    {
+      expected = (uint8_t)(length + offset);
+
+      for (index = 0U; index < length; index++)
+      {
+        expected ^= a_data[offset + index];
+      }
+
+      HOST_TEST_CHECK(OPENBL_KERNEL_Xor(&a_data[offset], length, (uint8_t)(length + offset)) == expected);
+    }
+  }
+}
+
+/**
+  * @brief  Check the CRC32 against the CRC peripheral model used by OPENBL_FLASH_ComputeDigest.
+  * @retval None.
+  */
+static void TEST_Crc32(void)
+{
+  uint8_t a_vector[4] = {0x78U, 0x56U, 0x34U, 0x12U};
+  uint8_t a_data[TEST_BUFFER_SIZE + TEST_OFFSETS];
+  uint32_t offset;
+  uint32_t length;
+  uint32_t crc;
+
+  /* Value documented with OPENBL_FLASH_ComputeDigest for the word 0x12345678 */
+  HOST_TEST_CHECK(TEST_PeripheralCrc32(a_vector, sizeof(a_vector)) == 0xDF8A8A2BU);
+  HOST_TEST_CHECK(OPENBL_KERNEL_Crc32(OPENBL_KERNEL_CRC32_INIT, a_vector, sizeof(a_vector)) == 0xDF8A8A2BU);
+
+  TEST_Randomize(a_data, sizeof(a_data));
+
+  for (offset = 0U; offset < TEST_OFFSETS; offset++)
+  {
+    for (length = 0U; length <= TEST_BUFFER_SIZE; length += 4U)
+    {
+      HOST_TEST_CHECK(OPENBL_KERNEL_Crc32(OPENBL_KERNEL_CRC32_INIT, &a_data[offset], length)
+                      == TEST_PeripheralCrc32(&a_data[offset], length));
+    }
+  }
+
+  /* A CRC can be continued over consecutive areas, the trailing bytes are ignored */
+  crc = OPENBL_KERNEL_Crc32(OPENBL_KERNEL_CRC32_INIT, a_data, 40U);
+  crc = OPENBL_KERNEL_Crc32(crc, &a_data[40], (TEST_BUFFER_SIZE - 40U) + 3U);
+
+  HOST_TEST_CHECK(crc == TEST_PeripheralCrc32(a_data, TEST_BUFFER_SIZE));
+}
+
+/**
+  * @brief  Check the location of a difference for all the relative alignments of the buffers.
+  * @retval None.
+  */
+static void TEST_FindDifference(void)
+{
+  uint8_t a_data1[TEST_BUFFER_SIZE + TEST_OFFSETS];
+  uint8_t a_data2[TEST_BUFFER_SIZE + TEST_OFFSETS];
+  uint32_t offset1;
+  uint32_t offset2;
+  uint32_t position;
+
+  TEST_Randomize(a_data1, sizeof(a_data1));
+
+  for (offset1 = 0U; offset1 < TEST_OFFSETS; offset1++)
+  {
+    for (offset2 = 0U; offset2 < TEST_OFFSETS; offset2++)
+    {
+      memcpy(&a_data2[offset2], &a_data1[offset1], TEST_BUFFER_SIZE);
+
+      HOST_TEST_CHECK(OPENBL_KERNEL_FindDifference(&a_data1[offset1], &a_data2[offset2], TEST_BUFFER_SIZE)
+                      == TEST_BUFFER_SIZE);
+      HOST_TEST_CHECK(OPENBL_KERNEL_Compare(&a_data1[offset1], &a_data2[offset2], TEST_BUFFER_SIZE) == 0U);
+
+      for (position = 0U; position < TEST_BUFFER_SIZE; position++)
+      {
+        a_data2[offset2 + position] ^= 0x10U;
+
+        HOST_TEST_CHECK(OPENBL_KERNEL_FindDifference(&a_data1[offset1], &a_data2[offset2], TEST_BUFFER_SIZE)
+                        == position);
+        HOST_TEST_CHECK(OPENBL_KERNEL_Compare(&a_data1[offset1], &a_data2[offset2], TEST_BUFFER_SIZE) == 1U);
+
+        /* A difference beyond the compared length is not seen */
+        HOST_TEST_CHECK(OPENBL_KERNEL_Compare(&a_data1[offset1], &a_data2[offset2], position) == 0U);
+
+        a_data2[offset2 + position] ^= 0x10U;
+      }
+    }
+  }
+}
+
+/**
+  * @brief  Check the blank check and the fill for all the alignments and lengths.
+  * @retval None.
+  */
+static void TEST_IsFilledAndFill(void)
+{
+  uint8_t a_data[TEST_BUFFER_SIZE + TEST_OFFSETS + 1U];
+  uint32_t offset;
+  uint32_t length;
+  uint32_t position;
+
+  for (offset = 0U; offset < TEST_OFFSETS; offset++)
+  {
+    for (length = 0U; length <= TEST_BUFFER_SIZE; length++)
+    {
+      memset(a_data, TEST_GUARD_BYTE, sizeof(a_data));
+
+      OPENBL_KERNEL_Fill(&a_data[offset], length, 0xFFU);
+
+      /* The bytes around the area keep their value */
+      HOST_TEST_CHECK(OPENBL_KERNEL_IsFilled(a_data, offset, TEST_GUARD_BYTE) == 1U);
+      HOST_TEST_CHECK(OPENBL_KERNEL_IsFilled(&a_data[offset], length, 0xFFU) == 1U);
+      HOST_TEST_CHECK(a_data[offset + length] == TEST_GUARD_BYTE);
+
+      for (position = 0U; position < length; position++)
+      {
+        a_data[offset + position] = 0xFEU;
+
+        HOST_TEST_CHECK(OPENBL_KERNEL_IsFilled(&a_data[offset], length, 0xFFU) == 0U);
+
+        a_data[offset + position] = 0xFFU;
+      }
+    }
+  }
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+int main(void)
+{
+  TEST_Xor();
+  TEST_Crc32();
+  TEST_FindDifference();
+  TEST_IsFilledAndFill();
+
+  return HOST_TEST_RESULT("test_kernels");
+}